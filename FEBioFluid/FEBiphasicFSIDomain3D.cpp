@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FEBioFSI.h"
 #include "FEFluidFSI.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -211,9 +212,9 @@ void FEBiphasicFSIDomain3D::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -221,7 +222,7 @@ void FEBiphasicFSIDomain3D::InternalForces(FEGlobalVector& R)
         if (el.isActive()) {
             // get the element force vector and initialize it to zero
             int ndof = 7*el.Nodes();
-            fe.assign(ndof, 0);
+            vector<double>& fe = scratch.Vector(ndof);
             
             // calculate internal force vector
             ElementInternalForce(el, fe);
@@ -337,12 +338,12 @@ void FEBiphasicFSIDomain3D::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
         FESolidElement& el = m_Elem[i];
         
         if (el.isActive()) {
-            vector<double> fe;
-            vector<int> lm;
+            FEElementScratch& scratch = FEElementScratch::Get();
+            vector<int>& lm = scratch.LM();
             
             // get the element force vector and initialize it to zero
             int ndof = 7*el.Nodes();
-            fe.assign(ndof, 0);
+            vector<double>& fe = scratch.Vector(ndof);
             
             // apply body forces
             ElementBodyForce(BF, el, fe);
@@ -669,18 +670,18 @@ void FEBiphasicFSIDomain3D::StiffnessMatrix(FELinearSystem& LS)
         
         if (el.isActive()) {
             // element stiffness matrix
-            FEElementMatrix ke(el);
+            FEElementScratch& scratch = FEElementScratch::Get();
             
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
-            ke.resize(ndof, ndof);
+            FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
             ke.zero();
             
             // calculate material stiffness
             ElementStiffness(el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = scratch.LM();
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -703,18 +704,18 @@ void FEBiphasicFSIDomain3D::MassMatrix(FELinearSystem& LS)
         
         if (el.isActive()) {
             
-            FEElementMatrix ke(el);
+            FEElementScratch& scratch = FEElementScratch::Get();
             
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
-            ke.resize(ndof, ndof);
+            FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
             ke.zero();
             
             // calculate inertial stiffness
             ElementMassMatrix(el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = scratch.LM();
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -738,18 +739,18 @@ void FEBiphasicFSIDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         if (el.isActive()) {
             
             // element stiffness matrix
-            FEElementMatrix ke(el);
+            FEElementScratch& scratch = FEElementScratch::Get();
             
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
-            ke.resize(ndof, ndof);
+            FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
             ke.zero();
             
             // calculate inertial stiffness
             ElementBodyForceStiffness(bf, el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = scratch.LM();
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -1039,13 +1040,13 @@ void FEBiphasicFSIDomain3D::InertialForces(FEGlobalVector& R)
         FESolidElement& el = m_Elem[i];
         
         if (el.isActive()) {
-            // element force vector
-            vector<double> fe;
-            vector<int> lm;
+            // scratch buffers for the element force vector and LM vector
+            FEElementScratch& scratch = FEElementScratch::Get();
+            vector<int>& lm = scratch.LM();
             
             // get the element force vector and initialize it to zero
             int ndof = 7*el.Nodes();
-            fe.assign(ndof, 0);
+            vector<double>& fe = scratch.Vector(ndof);
             
             // calculate internal force vector
             ElementInertialForce(el, fe);
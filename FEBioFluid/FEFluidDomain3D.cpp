@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioFluid.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -141,16 +142,16 @@ void FEFluidDomain3D::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 4*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForce(el, fe);
@@ -240,15 +241,15 @@ void FEFluidDomain3D::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
     int NE = (int)m_Elem.size();
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 4*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // apply body forces
         ElementBodyForce(BF, el, fe);
@@ -451,32 +452,28 @@ void FEFluidDomain3D::ElementStiffness(FESolidElement &el, matrix &ke)
 void FEFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
 {
     // repeat over all solid elements
-    int NE = (int)m_Elem.size();
-    
-#pragma omp parallel for shared (NE)
-    for (int iel=0; iel<NE; ++iel)
+    ParallelAssemble(LS, [&](int iel)
     {
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate material stiffness
         ElementStiffness(el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
@@ -491,18 +488,17 @@ void FEFluidDomain3D::MassMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate inertial stiffness
         ElementMassMatrix(el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -522,18 +518,17 @@ void FEFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate inertial stiffness
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -715,16 +710,16 @@ void FEFluidDomain3D::InertialForces(FEGlobalVector& R)
 #pragma omp parallel for shared(NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 4*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInertialForce(el, fe);
@@ -32,6 +32,7 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include "FEBioFSI.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -197,9 +198,9 @@ void FEFluidFSIDomain3D::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -207,7 +208,7 @@ void FEFluidFSIDomain3D::InternalForces(FEGlobalVector& R)
         if (el.isActive()) {
             // get the element force vector and initialize it to zero
             int ndof = 7*el.Nodes();
-            fe.assign(ndof, 0);
+            vector<double>& fe = scratch.Vector(ndof);
             
             // calculate internal force vector
             ElementInternalForce(el, fe);
@@ -316,12 +317,12 @@ void FEFluidFSIDomain3D::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
         FESolidElement& el = m_Elem[i];
         
         if (el.isActive()) {
-            vector<double> fe;
-            vector<int> lm;
+            FEElementScratch& scratch = FEElementScratch::Get();
+            vector<int>& lm = scratch.LM();
             
             // get the element force vector and initialize it to zero
             int ndof = 7*el.Nodes();
-            fe.assign(ndof, 0);
+            vector<double>& fe = scratch.Vector(ndof);
             
             // apply body forces
             ElementBodyForce(BF, el, fe);
@@ -574,18 +575,18 @@ void FEFluidFSIDomain3D::StiffnessMatrix(FELinearSystem& LS)
         
         if (el.isActive()) {
             // element stiffness matrix
-            FEElementMatrix ke(el);
+            FEElementScratch& scratch = FEElementScratch::Get();
             
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
-            ke.resize(ndof, ndof);
+            FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
             ke.zero();
             
             // calculate material stiffness
             ElementStiffness(el, ke);
             
             // get the element's LM vector
-			vector<int> lm;
+			vector<int>& lm = scratch.LM();
 			UnpackLM(el, lm);
 			ke.SetIndices(lm);
             
@@ -608,18 +609,18 @@ void FEFluidFSIDomain3D::MassMatrix(FELinearSystem& LS)
         
         if (el.isActive()) {
 
-			FEElementMatrix ke(el);
+			FEElementScratch& scratch = FEElementScratch::Get();
 
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
-            ke.resize(ndof, ndof);
+            FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
             ke.zero();
             
             // calculate inertial stiffness
             ElementMassMatrix(el, ke);
             
             // get the element's LM vector
-			vector<int> lm;
+			vector<int>& lm = scratch.LM();
 			UnpackLM(el, lm);
 			ke.SetIndices(lm);
             
@@ -644,18 +645,18 @@ void FEFluidFSIDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
         if (el.isActive()) {
 
 			// element stiffness matrix
-			FEElementMatrix ke(el);
+			FEElementScratch& scratch = FEElementScratch::Get();
 
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
-            ke.resize(ndof, ndof);
+            FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
             ke.zero();
             
             // calculate inertial stiffness
             ElementBodyForceStiffness(bf, el, ke);
             
             // get the element's LM vector
-			vector<int> lm;
+			vector<int>& lm = scratch.LM();
 			UnpackLM(el, lm);
 			ke.SetIndices(lm);
             
@@ -887,13 +888,13 @@ void FEFluidFSIDomain3D::InertialForces(FEGlobalVector& R)
         FESolidElement& el = m_Elem[i];
         
         if (el.isActive()) {
-            // element force vector
-            vector<double> fe;
-            vector<int> lm;
+            // scratch buffers for the element force vector and LM vector
+            FEElementScratch& scratch = FEElementScratch::Get();
+            vector<int>& lm = scratch.LM();
             
             // get the element force vector and initialize it to zero
             int ndof = 7*el.Nodes();
-            fe.assign(ndof, 0);
+            vector<double>& fe = scratch.Vector(ndof);
             
             // calculate internal force vector
             ElementInertialForce(el, fe);
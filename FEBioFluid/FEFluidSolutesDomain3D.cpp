@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioFluidSolutes.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 #ifndef SQR
 #define SQR(x) ((x)*(x))
@@ -296,16 +297,16 @@ void FEFluidSolutesDomain3D::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = ndpn*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForce(el, fe);
@@ -452,15 +453,15 @@ void FEFluidSolutesDomain3D::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
     int ndpn = 4+nsol;
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = ndpn*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // apply body forces
         ElementBodyForce(BF, el, fe);
@@ -888,20 +889,20 @@ void FEFluidSolutesDomain3D::StiffnessMatrix(FELinearSystem& LS)
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int nsol = m_pMat->Solutes();
         int ndpn = 4 + nsol;
         int ndof = ndpn*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate material stiffness
         ElementStiffness(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -922,20 +923,20 @@ void FEFluidSolutesDomain3D::MassMatrix(FELinearSystem& LS)
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         const int nsol = m_pMat->Solutes();
         const int ndpn = 4 + nsol;
         int ndof = ndpn*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
         ElementMassMatrix(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -955,20 +956,20 @@ void FEFluidSolutesDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         const int nsol = m_pMat->Solutes();
         const int ndpn = 4 + nsol;
         int ndof = ndpn*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate element body force stiffness
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -1192,9 +1193,9 @@ void FEFluidSolutesDomain3D::InertialForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -1203,7 +1204,7 @@ void FEFluidSolutesDomain3D::InertialForces(FEGlobalVector& R)
         const int nsol = m_pMat->Solutes();
         const int ndpn = 4+nsol;
         int ndof = ndpn*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInertialForce(el, fe);
@@ -35,6 +35,7 @@
 #include "FEFluidFSI.h"
 #include "FEBiphasicFSI.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 #ifndef SQR
 #define SQR(x) ((x)*(x))
@@ -385,9 +386,9 @@ void FEMultiphasicFSIDomain3D::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -395,7 +396,7 @@ void FEMultiphasicFSIDomain3D::InternalForces(FEGlobalVector& R)
         if (el.isActive()) {
             // get the element force vector and initialize it to zero
             int ndof = ndpn*el.Nodes();
-            fe.assign(ndof, 0);
+            vector<double>& fe = scratch.Vector(ndof);
             
             // calculate internal force vector
             ElementInternalForce(el, fe);
@@ -591,12 +592,12 @@ void FEMultiphasicFSIDomain3D::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
         FESolidElement& el = m_Elem[i];
         
         if (el.isActive()) {
-            vector<double> fe;
-            vector<int> lm;
+            FEElementScratch& scratch = FEElementScratch::Get();
+            vector<int>& lm = scratch.LM();
             
             // get the element force vector and initialize it to zero
             int ndof = ndpn*el.Nodes();
-            fe.assign(ndof, 0);
+            vector<double>& fe = scratch.Vector(ndof);
             
             // apply body forces
             ElementBodyForce(BF, el, fe);
@@ -1253,18 +1254,18 @@ void FEMultiphasicFSIDomain3D::StiffnessMatrix(FELinearSystem& LS)
         
         if (el.isActive()) {
             // element stiffness matrix
-            FEElementMatrix ke(el);
+            FEElementScratch& scratch = FEElementScratch::Get();
             
             // create the element's stiffness matrix
             int ndof = ndpn*el.Nodes();
-            ke.resize(ndof, ndof);
+            FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
             ke.zero();
             
             // calculate material stiffness
             ElementStiffness(el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = scratch.LM();
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -1290,18 +1291,18 @@ void FEMultiphasicFSIDomain3D::MassMatrix(FELinearSystem& LS)
         
         if (el.isActive()) {
             
-            FEElementMatrix ke(el);
+            FEElementScratch& scratch = FEElementScratch::Get();
             
             // create the element's stiffness matrix
             int ndof = ndpn*el.Nodes();
-            ke.resize(ndof, ndof);
+            FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
             ke.zero();
             
             // calculate inertial stiffness
             ElementMassMatrix(el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = scratch.LM();
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -1330,18 +1331,18 @@ void FEMultiphasicFSIDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForc
         if (el.isActive()) {
             
             // element stiffness matrix
-            FEElementMatrix ke(el);
+            FEElementScratch& scratch = FEElementScratch::Get();
             
             // create the element's stiffness matrix
             int ndof = ndpn*el.Nodes();
-            ke.resize(ndof, ndof);
+            FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
             ke.zero();
             
             // calculate inertial stiffness
             ElementBodyForceStiffness(bf, el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = scratch.LM();
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -1680,13 +1681,13 @@ void FEMultiphasicFSIDomain3D::InertialForces(FEGlobalVector& R)
         FESolidElement& el = m_Elem[i];
         
         if (el.isActive()) {
-            // element force vector
-            vector<double> fe;
-            vector<int> lm;
+            // scratch buffers for the element force vector and LM vector
+            FEElementScratch& scratch = FEElementScratch::Get();
+            vector<int>& lm = scratch.LM();
             
             // get the element force vector and initialize it to zero
             int ndof = ndpn*el.Nodes();
-            fe.assign(ndof, 0);
+            vector<double>& fe = scratch.Vector(ndof);
             
             // calculate internal force vector
             ElementInertialForce(el, fe);
@@ -38,6 +38,7 @@
 #include "FEBioPolarFluid.h"
 #include <FECore/FELinearSystem.h>
 #include "FEBodyMoment.h"
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -147,16 +148,16 @@ void FEPolarFluidDomain3D::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 7*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForce(el, fe);
@@ -253,15 +254,15 @@ void FEPolarFluidDomain3D::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
     int NE = (int)m_Elem.size();
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 7*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // apply body forces
         ElementBodyForce(BF, el, fe);
@@ -372,15 +373,15 @@ void FEPolarFluidDomain3D::BodyMoment(FEGlobalVector& R, FEBodyMoment& bm)
     int NE = (int)m_Elem.size();
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 7*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // apply body forces
         ElementBodyMoment(bm, el, fe);
@@ -637,18 +638,18 @@ void FEPolarFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 7*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate material stiffness
         ElementStiffness(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -669,18 +670,18 @@ void FEPolarFluidDomain3D::MassMatrix(FELinearSystem& LS)
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 7*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
         ElementMassMatrix(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -701,18 +702,18 @@ void FEPolarFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 7*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -732,18 +733,18 @@ void FEPolarFluidDomain3D::BodyMomentStiffness(FELinearSystem& LS, FEBodyMoment&
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 7*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
         ElementBodyMomentStiffness(bm, el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -968,16 +969,16 @@ void FEPolarFluidDomain3D::InertialForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 7*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInertialForce(el, fe);
@@ -32,6 +32,7 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioFluidSolutes.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -241,9 +242,9 @@ void FESolutesDomain::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
 	for (int i = 0; i<NE; ++i)
 	{
-		// element force vector
-		vector<double> fe;
-		vector<int> lm;
+		// scratch buffers for the element force vector and LM vector
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<int>& lm = scratch.LM();
 
 		// get the element
 		FESolidElement& el = m_Elem[i];
@@ -251,7 +252,7 @@ void FESolutesDomain::InternalForces(FEGlobalVector& R)
 		// get the element force vector and initialize it to zero
 		int nsol = m_pMat->Solutes();
 		int ndof = nsol*el.Nodes();
-		fe.assign(ndof, 0);
+		vector<double>& fe = scratch.Vector(ndof);
 
 		// calculate internal force vector
 		ElementInternalForce(el, fe);
@@ -454,19 +455,19 @@ void FESolutesDomain::StiffnessMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 
 		// create the element's stiffness matrix
 		int nsol = m_pMat->Solutes();
 		int ndof = nsol*el.Nodes();
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 		ke.zero();
 
 		// calculate material stiffness
 		ElementStiffness(el, ke);
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -37,6 +37,7 @@ SOFTWARE.*/
 #include <FECore/FEAnalysis.h>
 #include <FECore/sys.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -166,16 +167,16 @@ void FEThermoFluidDomain3D::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = ndpn*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForce(el, fe);
@@ -283,15 +284,15 @@ void FEThermoFluidDomain3D::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
     int ndpn = 5;
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = ndpn*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // apply body forces
         ElementBodyForce(BF, el, fe);
@@ -356,15 +357,15 @@ void FEThermoFluidDomain3D::HeatSupply(FEGlobalVector& R, FEFluidHeatSupply& BF)
     int NE = (int)m_Elem.size();
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 5*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // apply body forces
         ElementHeatSupply(BF, el, fe);
@@ -656,18 +657,18 @@ void FEThermoFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
         FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 5*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate material stiffness
         ElementStiffness(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
 
@@ -688,18 +689,18 @@ void FEThermoFluidDomain3D::MassMatrix(FELinearSystem& LS)
         FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 5*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
         ElementMassMatrix(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -720,18 +721,18 @@ void FEThermoFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 5*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -751,18 +752,18 @@ void FEThermoFluidDomain3D::HeatSupplyStiffness(FELinearSystem& LS, FEFluidHeatS
         FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 5*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
         ElementHeatSupplyStiffness(bf, el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = scratch.LM();
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -963,16 +964,16 @@ void FEThermoFluidDomain3D::InertialForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 5*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInertialForce(el, fe);
@@ -63,6 +63,7 @@ SOFTWARE.*/
 #include <FECore/FEMaterial.h>
 #include <FECore/FEPlotDataStore.h>
 #include <FECore/FETimeStepController.h>
+#include <FECore/FEElementScratch.h>
 #include "febio.h"
 #include "version.h"
 #include <iostream>
@@ -1505,6 +1506,9 @@ bool FEBioModel::Init()
 	FEBioPlotFile* pplt = nullptr;
 	m_lastUpdate = -1;
 
+	// reset the allocation counter of the element scratch buffers
+	FEElementScratch::ResetAllocations();
+
 	// open plot database file
 	FEAnalysis* step = GetCurrentStep();
 	if (step->GetPlotLevel() != FE_PLOT_NEVER)
@@ -1713,6 +1717,7 @@ void FEBioModel::on_cb_solved()
 		Timer::time_str(total_qn    , sztime); feLog("\t   QN updates ................... : %s (%lg sec)\n\n", sztime, total_qn);
 		Timer::time_str(total_linsol, sztime); feLog("\t   time in linear solver ........ : %s (%lg sec)\n\n", sztime, total_linsol);
 		Timer::time_str(total_time  , sztime); feLog("\tTotal elapsed time .............. : %s (%lg sec)\n\n", sztime, total_time);
+		feLog("\tElement scratch allocations ..... : %d\n\n", FEElementScratch::Allocations());
 
 		m_log.SetMode(old_mode);
 
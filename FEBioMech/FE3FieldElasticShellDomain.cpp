@@ -32,6 +32,7 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FECore/log.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 BEGIN_FECORE_CLASS(FE3FieldElasticShellDomain, FEElasticShellDomain)
@@ -125,11 +126,11 @@ void FE3FieldElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // create the element's stiffness matrix
         int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate material and geometrical stiffness (i.e. constitutive component)
@@ -139,7 +140,7 @@ void FE3FieldElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
         ElementDilatationalStiffness(fem, iel, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
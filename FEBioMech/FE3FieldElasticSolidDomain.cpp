@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FEUncoupledMaterial.h"
 #include <FECore/FEModel.h>
 #include "FECore/log.h"
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 BEGIN_FECORE_CLASS(FE3FieldElasticSolidDomain, FEElasticSolidDomain)
@@ -142,11 +143,11 @@ void FE3FieldElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 
 		// create the element's stiffness matrix
 		int ndof = 3*el.Nodes();
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 		ke.zero();
 
 		// calculate material stiffness (i.e. constitutive component)
@@ -166,7 +167,7 @@ void FE3FieldElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 				ke[j][i] = ke[i][j];
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -36,6 +36,8 @@ SOFTWARE.*/
 #include "FEReactivePlasticDamageMaterialPoint.h"
 #include "FEElasticMixture.h"
 #include "FEElasticMultigeneration.h"
+#include "FEReactiveViscoelastic.h"
+#include "FEUncoupledReactiveViscoelastic.h"
 #include "FERigidMaterial.h"
 #include "FESolidSolver.h"
 #include "FESolidSolver2.h"
@@ -1915,6 +1917,50 @@ double FELogOctahedralPlasticStrain::value(FEElement& el)
     return D;
 }
 
+//-----------------------------------------------------------------------------
+double FELogRVEGenerations::value(FEElement& el)
+{
+	FEDomain* dom = dynamic_cast<FEDomain*>(el.GetMeshPartition());
+	if ((dom == nullptr) || (dom->GetMaterial() == nullptr)) return 0.0;
+	FEElasticMaterial* pmat = dom->GetMaterial()->ExtractProperty<FEElasticMaterial>();
+	if (pmat == nullptr) return 0.0;
+
+	FEReactiveViscoelasticMaterial* rvmat = dynamic_cast<FEReactiveViscoelasticMaterial*>(pmat);
+	FEUncoupledReactiveViscoelasticMaterial* rumat = dynamic_cast<FEUncoupledReactiveViscoelasticMaterial*>(pmat);
+
+	int nint = el.GaussPoints();
+	int n = 0;
+	double ng = 0;
+	if (rvmat || rumat)
+	{
+		for (int j = 0; j < nint; ++j)
+		{
+			FEMaterialPoint& mp = *el.GetMaterialPoint(j);
+			ng += (rvmat ? rvmat->RVEGenerations(mp) : rumat->RVEGenerations(mp));
+			++n;
+		}
+	}
+	else
+	{
+		// check the components of a mixture
+		for (int ic = 0; ic < pmat->Properties(); ++ic)
+		{
+			FEReactiveViscoelasticMaterial* rvc = pmat->GetProperty(ic)->ExtractProperty<FEReactiveViscoelasticMaterial>();
+			FEUncoupledReactiveViscoelasticMaterial* ruc = pmat->GetProperty(ic)->ExtractProperty<FEUncoupledReactiveViscoelasticMaterial>();
+			if ((rvc == nullptr) && (ruc == nullptr)) continue;
+
+			for (int j = 0; j < nint; ++j)
+			{
+				FEMaterialPoint& mp = *el.GetMaterialPoint(j)->GetPointData(ic);
+				ng += (rvc ? rvc->RVEGenerations(mp) : ruc->RVEGenerations(mp));
+				++n;
+			}
+		}
+	}
+
+	return (n > 0 ? ng / n : 0.0);
+}
+
 //-----------------------------------------------------------------------------
 double FELogDiscreteElementStretch::value(FEElement& el)
 {
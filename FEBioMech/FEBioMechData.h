@@ -1020,6 +1020,15 @@ public:
     double value(FEElement& el);
 };
 
+//-----------------------------------------------------------------------------
+//! Average number of reactive viscoelastic generations per integration point
+class FELogRVEGenerations : public FELogElemData
+{
+public:
+    FELogRVEGenerations(FEModel* pfem) : FELogElemData(pfem){}
+    double value(FEElement& el);
+};
+
 //-----------------------------------------------------------------------------
 //! Discrete element stretch
 class FELogDiscreteElementStretch : public FELogElemData
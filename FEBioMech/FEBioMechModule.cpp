@@ -276,6 +276,7 @@ SOFTWARE.*/
 #include "FESolidModule.h"
 
 #include "FESolidAnalysis.h"
+#include "FEMatrixFreeStrategy.h"
 #include <FECore/FEModelUpdate.h>
 
 #include "FEElasticBeamMaterial.h"
@@ -308,6 +309,10 @@ void FEBioMech::InitModule()
 	REGISTER_FECORE_CLASS(FESolidSolver, "solid_old");
 	REGISTER_FECORE_CLASS(FECGSolidSolver, "CG-solid");
 
+	//-----------------------------------------------------------------------------
+	// Newton strategies
+	REGISTER_FECORE_CLASS(FEMatrixFreeStrategy, "matrix-free");
+
 	//-----------------------------------------------------------------------------
 	// material classes
 
@@ -999,6 +1004,7 @@ void FEBioMech::InitModule()
     REGISTER_FECORE_CLASS(FELogYieldedBonds, "wy");
     REGISTER_FECORE_CLASS(FELogFatigueBonds, "wf");
     REGISTER_FECORE_CLASS(FELogOctahedralPlasticStrain, "ops");
+    REGISTER_FECORE_CLASS(FELogRVEGenerations, "rve_generations");
     REGISTER_FECORE_CLASS(FELogDiscreteElementStretch   , "discrete element stretch");
     REGISTER_FECORE_CLASS(FELogDiscreteElementElongation, "discrete element elongation");
     REGISTER_FECORE_CLASS(FELogDiscreteElementForce     , "discrete element force"  );
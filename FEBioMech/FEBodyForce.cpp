@@ -48,6 +48,17 @@ void FEBodyForce::LoadVector(FEGlobalVector& R)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void FEBodyForce::LoadVectorTasks(FEGlobalVector& R, FETaskList& tasks)
+{
+	for (int i = 0; i<Domains(); ++i)
+	{
+		FEDomain* dom = Domain(i);
+		FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(dom);
+		if (edom && (edom->BodyForceTasks(R, *this, tasks) == false)) edom->BodyForce(R, *this);
+	}
+}
+
 //-----------------------------------------------------------------------------
 // NOTE: Work in progress! Working on integrating body loads as model loads
 void FEBodyForce::StiffnessMatrix(FELinearSystem& LS)
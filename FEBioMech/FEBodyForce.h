@@ -31,6 +31,8 @@ SOFTWARE.*/
 #include <FECore/FEBodyLoad.h>
 #include "febiomech_api.h"
 
+class FETaskList;
+
 //-----------------------------------------------------------------------------
 //! This class is the base class for body forces
 //! Derived classes need to implement the force and stiffness functions.
@@ -54,4 +56,8 @@ public:
 public:
 	void LoadVector(FEGlobalVector& R) override;
 	void StiffnessMatrix(FELinearSystem& LS) override;
+
+	//! Evaluate the load vector. The domains that support it add their element loops to the
+	//! task list (see FEElasticDomain::BodyForceTasks), the others are evaluated right away.
+	void LoadVectorTasks(FEGlobalVector& R, FETaskList& tasks);
 };
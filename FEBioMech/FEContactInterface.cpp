@@ -34,6 +34,8 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FECore/FESolver.h>
 #include <FECore/FEAnalysis.h>
+#include <FECore/FELinearSystem.h>
+#include <FECore/FEElementColoring.h>
 #include "FEElasticDomain.h"
 
 BEGIN_FECORE_CLASS(FEContactInterface, FESurfacePairConstraint)
@@ -209,3 +211,97 @@ double FEContactInterface::GetPenaltyScaleFactor()
     if ((m_psfmax > 0) && (psf > m_psfmax)) psf = m_psfmax;
     return psf;
 }
+
+//-----------------------------------------------------------------------------
+// Collects the nodes of each facet of the primary surface and of the secondary facets it 
+// is paired with (in compressed format), which is what the facet coloring is built from. 
+// If pairs is not given, these are the current (and previous) secondary facets of its 
+// integration points. Returns false if the surface does not store contact material points.
+static bool ContactFacetNodes(FEContactSurface& ss, std::function<void(int nface, std::vector<FESurfaceElement*>& pe)>& pairs, std::vector<int>& ptr, std::vector<int>& nodeList)
+{
+	const int NF = ss.Elements();
+	ptr.assign(NF + 1, 0);
+	nodeList.clear();
+	nodeList.reserve(NF*FEElement::MAX_NODES);
+	std::vector<FESurfaceElement*> pe;
+	for (int i = 0; i < NF; ++i)
+	{
+		FESurfaceElement& el = ss.Element(i);
+		for (int j = 0; j < el.Nodes(); ++j) nodeList.push_back(el.m_node[j]);
+
+		pe.clear();
+		if (pairs) pairs(i, pe);
+		else
+		{
+			for (int n = 0; n < el.GaussPoints(); ++n)
+			{
+				FEContactMaterialPoint* mp = dynamic_cast<FEContactMaterialPoint*>(el.GetMaterialPoint(n));
+				if (mp == nullptr) return false;
+
+				// the stick condition can switch back to the previous facet during assembly
+				pe.push_back(mp->m_pme);
+				if (mp->m_pmep != mp->m_pme) pe.push_back(mp->m_pmep);
+			}
+		}
+
+		for (FESurfaceElement* pf : pe)
+		{
+			if (pf == nullptr) continue;
+			for (int j = 0; j < pf->Nodes(); ++j) nodeList.push_back(pf->m_node[j]);
+		}
+		ptr[i + 1] = (int)nodeList.size();
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEContactInterface::ParallelAssemble(FELinearSystem& LS, FEContactSurface& ss, std::function<void(int nface)> f,
+	std::function<void(int nface, std::vector<FESurfaceElement*>& pe)> pairs)
+{
+	// The coloring depends on the contact pairing, which can change between iterations.
+	// Collecting the facet node lists is cheap, so we compare them with the ones the cached
+	// coloring was built from, and only color the facets again when they differ.
+	const FEElementColoring* col = nullptr;
+	if (LS.ColoredAssembly())
+	{
+		FACET_COLORING* fc = nullptr;
+		for (FACET_COLORING& c : m_facetCol) if (c.ss == &ss) { fc = &c; break; }
+		if (fc == nullptr)
+		{
+			m_facetCol.push_back(FACET_COLORING());
+			fc = &m_facetCol.back();
+			fc->ss = &ss;
+		}
+
+		std::vector<int> ptr, nodeList;
+		if (ContactFacetNodes(ss, pairs, ptr, nodeList))
+		{
+			if (fc->col.IsEmpty() || (ptr != fc->ptr) || (nodeList != fc->nodeList))
+			{
+				fc->col.Create(ss.Elements(), ss.GetMesh()->Nodes(), ptr, nodeList);
+				fc->ptr.swap(ptr);
+				fc->nodeList.swap(nodeList);
+			}
+			col = &fc->col;
+		}
+	}
+
+	if (col)
+	{
+		LS.SetAtomicAssembly(false);
+		for (int c = 0; c < col->Colors(); ++c)
+		{
+			const int* faceList = col->ElementList(c);
+			int NF = col->Elements(c);
+#pragma omp parallel for schedule(dynamic) shared(NF)
+			for (int i = 0; i < NF; ++i) f(faceList[i]);
+		}
+		LS.SetAtomicAssembly(true);
+	}
+	else
+	{
+		int NF = ss.Elements();
+#pragma omp parallel for schedule(dynamic) shared(NF)
+		for (int i = 0; i < NF; ++i) f(i);
+	}
+}
@@ -28,7 +28,9 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/FESurfacePairConstraint.h>
+#include <FECore/FEElementColoring.h>
 #include "febiomech_api.h"
+#include <functional>
 
 class FEModel;
 class FESolver;
@@ -75,7 +77,27 @@ protected:
 
     //! cale the penalty factor during Lagrange augmentation
     double GetPenaltyScaleFactor();
+
+	//! Evaluate f for all facets of the primary surface ss in parallel. When the solver requests 
+	//! colored assembly, facets are only processed concurrently when neither they, nor the 
+	//! secondary facets their integration points are paired with, share nodes. By default, the 
+	//! secondary facets are taken from the facets' contact material points. Interfaces that store
+	//! their pairing elsewhere can pass a function that returns the secondary facets of a facet.
+	void ParallelAssemble(FELinearSystem& LS, FEContactSurface& ss, std::function<void(int nface)> f,
+		std::function<void(int nface, std::vector<FESurfaceElement*>& pe)> pairs = nullptr);
     
+private:
+	//! Facet coloring of a primary surface. It is cached between calls to ParallelAssemble
+	//! and only rebuilt when the facet node lists it was built from change.
+	struct FACET_COLORING
+	{
+		const FEContactSurface*	ss;			//!< the primary surface
+		std::vector<int>		ptr;		//!< facet node lists (compressed format)
+		std::vector<int>		nodeList;
+		FEElementColoring		col;		//!< the coloring
+	};
+	std::vector<FACET_COLORING>	m_facetCol;
+
 public:
 	int		m_laugon;	//!< contact enforcement method
     double  m_psf;      //!< penalty scale factor during Lagrange augmentation
@@ -29,7 +29,9 @@ SOFTWARE.*/
 #include <FECore/FEGlobalMatrix.h>
 #include <FECore/FELinearSystem.h>
 #include <FECore/FEBox.h>
+#include <FECore/sys.h>
 #include <stdexcept>
+#include <algorithm>
 
 vec3d MaterialPointPosition(FESurfaceElement& el, int n)
 {
@@ -123,6 +125,7 @@ BEGIN_FECORE_CLASS(FEContactPotential, FEContactInterface)
 	ADD_PARAMETER(m_Rout, "R_out");
 	ADD_PARAMETER(m_Rmin, "R0_min");
 	ADD_PARAMETER(m_wtol, "w_tol");
+	ADD_PARAMETER(m_skin, "skin");
 END_FECORE_CLASS();
 
 FEContactPotential::FEContactPotential(FEModel* fem) : FEContactInterface(fem), m_surf1(fem), m_surf2(fem)
@@ -136,6 +139,9 @@ FEContactPotential::FEContactPotential(FEModel* fem) : FEContactInterface(fem),
 	m_Rout = 2.0;
 	m_Rmin = 0.0;
 	m_wtol = 0.0;
+	m_skin = 0.25;
+
+	m_grid = nullptr;
 }
 
 //! return the primary surface
@@ -220,30 +226,35 @@ public:
 	double depth () const { return r1.z - r0.z; }
 };
 
-class Grid
+class FEContactPotential::Grid
 {
 public:
 	class Cell
 	{
 	public:
-		Cell() {}
-		Cell(const Cell& c) : m_box(c.m_box), m_elemList(c.m_elemList), m_nbr(c.m_nbr) {}
-		void operator = (const Cell& c) { 
-			m_box = c.m_box; 
-			m_elemList = c.m_elemList; 
-			m_nbr = c.m_nbr;
+		void add(int el)
+		{
+			if (std::find(m_elemList.begin(), m_elemList.end(), el) == m_elemList.end()) m_elemList.push_back(el);
 		}
 
-		void add(FESurfaceElement* el)
+		void remove(int el)
 		{
-			m_elemList.insert(el);
+			for (size_t i = 0; i < m_elemList.size(); ++i)
+			{
+				if (m_elemList[i] == el)
+				{
+					m_elemList[i] = m_elemList.back();
+					m_elemList.pop_back();
+					return;
+				}
+			}
 		}
 
 		bool empty() const { return m_elemList.empty(); }
 
 	public:
 		BOX m_box;
-		set<FESurfaceElement*>	m_elemList;
+		vector<int>		m_elemList;
 		vector<Cell*>	m_nbr;
 	};
 
@@ -279,31 +290,52 @@ public:
 	}
 
 public:
-	Grid() { m_nx = m_ny = m_nz = 0; m_cell = nullptr; }
+	Grid() { m_nx = m_ny = m_nz = 0; m_cell = nullptr; m_cutoff = 0.0; m_binTol = 0.0; }
 
-	bool Build(FESurface& s, int boxDivs, double minBoxSize)
+	// Build the grid for the integration points of the surface. All integration points
+	// within the cutoff distance of a point are found in the cell neighborhood of that point.
+	bool Build(FESurface& s, int boxDivs, double cutoff)
 	{
-		// update the bounding box
-		for (int i = 0; i < s.Nodes(); ++i)
+		delete [] m_cell; m_cell = nullptr;
+		m_cutoff = cutoff;
+
+		// store the integration point positions and update the bounding box
+		const int NE = s.Elements();
+		m_ipStart.assign(NE + 1, 0);
+		for (int i = 0; i < NE; ++i) m_ipStart[i + 1] = m_ipStart[i] + s.Element(i).GaussPoints();
+		m_binPos.resize(m_ipStart[NE]);
+		for (int i = 0; i < NE; ++i)
 		{
-			FENode& node = s.Node(i);
-			vec3d ri = node.m_rt;
-			if (i == 0) box.r0 = box.r1 = ri;
-			else box.add(ri);
+			FESurfaceElement& el = s.Element(i);
+			for (int n = 0; n < el.GaussPoints(); ++n)
+			{
+				vec3d ri = el.GetMaterialPoint(n)->m_rt;
+				m_binPos[m_ipStart[i] + n] = ri;
+				if ((i == 0) && (n == 0)) box.r0 = box.r1 = ri;
+				else box.add(ri);
+			}
 		}
 
-		// inflate a little, just to be sure
-		double R = box.MaxExtent();
-		box.inflate(minBoxSize);
+		// Elements are only re-binned when their integration points moved more than a 
+		// fraction of the cell size, so the cells must be large enough to contain the 
+		// cutoff distance plus that tolerance.
+		const double f = 0.2;
+		double minBoxSize = cutoff / (1.0 - f);
+		double boxSize = (box.MaxExtent() + 2.0*minBoxSize) / boxDivs;
+		if (boxSize < minBoxSize) boxSize = minBoxSize;
+		m_binTol = f * boxSize;
+
+		// the integration points must remain in the core box, otherwise the grid is rebuilt
+		m_core = box;
+		m_core.inflate(m_binTol);
+		box = m_core;
+		box.inflate(boxSize);
 
 		// determine the sizes
 		double W = box.width();
 		double H = box.height();
 		double D = box.depth();
 
-		double boxSize = box.MaxExtent() / boxDivs;
-		if (boxSize < minBoxSize) boxSize = minBoxSize;
-
 		m_nx = (int)(W / boxSize); if (m_nx < 1) m_nx = 1;
 		m_ny = (int)(H / boxSize); if (m_ny < 1) m_ny = 1;
 		m_nz = (int)(D / boxSize); if (m_nz < 1) m_nz = 1;
@@ -358,16 +390,50 @@ public:
 		}
 
 		// assign elements to grid cells
-		for (int i = 0; i < s.Elements(); ++i)
+		for (int i = 0; i < NE; ++i)
+		{
+			for (int n = m_ipStart[i]; n < m_ipStart[i + 1]; ++n)
+			{
+				Cell* c = FindCell(m_binPos[n]); assert(c);
+				if (c == nullptr) return false;
+				c->add(i);
+			}
+		}
+
+		return true;
+	}
+
+	// Re-bin the elements whose integration points moved more than the binning tolerance
+	// since they were last binned. Returns false if the grid has to be rebuilt instead.
+	bool Update(FESurface& s, double cutoff)
+	{
+		const int NE = s.Elements();
+		if ((m_cell == nullptr) || (cutoff != m_cutoff) || ((int)m_ipStart.size() != NE + 1)) return false;
+
+		const double tol2 = m_binTol * m_binTol;
+		for (int i = 0; i < NE; ++i)
 		{
 			FESurfaceElement& el = s.Element(i);
 			int nint = el.GaussPoints();
+			if (m_ipStart[i + 1] - m_ipStart[i] != nint) return false;
+
+			vec3d* rb = &m_binPos[m_ipStart[i]];
+			bool bmoved = false;
 			for (int n = 0; n < nint; ++n)
 			{
-				FECPContactPoint& mp = static_cast<FECPContactPoint&>(*el.GetMaterialPoint(n));
-				Cell* c = FindCell(mp.m_rt); assert(c);
-				if (c == nullptr) return false;
-				c->add(&el);
+				const vec3d& rn = el.GetMaterialPoint(n)->m_rt;
+				if (m_core.isInside(rn) == false) return false;
+				if ((rn - rb[n]).norm2() > tol2) bmoved = true;
+			}
+
+			if (bmoved)
+			{
+				for (int n = 0; n < nint; ++n) FindCell(rb[n])->remove(i);
+				for (int n = 0; n < nint; ++n)
+				{
+					rb[n] = el.GetMaterialPoint(n)->m_rt;
+					FindCell(rb[n])->add(i);
+				}
 			}
 		}
 
@@ -386,10 +452,21 @@ public:
 
 protected:
 	BOX		box;
+	BOX		m_core;		// box that must contain all integration points
 	int		m_nx, m_ny, m_nz;
 	Cell*	m_cell;
+	double	m_cutoff;	// cutoff distance the grid was built for
+	double	m_binTol;	// distance integration points can move before their element is re-binned
+
+	vector<int>		m_ipStart;	// index of the first integration point of each element into m_binPos
+	vector<vec3d>	m_binPos;	// integration point positions when their element was binned
 };
 
+FEContactPotential::~FEContactPotential()
+{
+	delete m_grid;
+}
+
 // initialization
 bool FEContactPotential::Init()
 {
@@ -400,130 +477,283 @@ bool FEContactPotential::Init()
 
 void FEContactPotential::BuildNeighborTable()
 {
-	m_elemNeighbors.resize(m_surf1.Elements());
-	for (int i = 0; i < m_surf1.Elements(); ++i)
+	const int NE1 = m_surf1.Elements();
+	m_nbrStart.assign(NE1 + 1, 0);
+	m_nbr.clear();
+	for (int i = 0; i < NE1; ++i)
 	{
 		FESurfaceElement& el1 = m_surf1.Element(i);
-
-		set<FESurfaceElement*>& nbrList = m_elemNeighbors[i];
-		nbrList.clear();
-
 		for (int j = 0; j < m_surf2.Elements(); ++j)
 		{
 			FESurfaceElement& el2 = m_surf2.Element(j);
-			if (is_neighbor(el1, el2))
-			{
-				nbrList.insert(&el2);
-			}
+			if (is_neighbor(el1, el2)) m_nbr.push_back(j);
 		}
+		m_nbrStart[i + 1] = (int)m_nbr.size();
 	}
+
+	// the candidate pairs have to be rebuilt
+	m_rc1.clear();
+	m_rc2.clear();
 }
 
-// update
-void FEContactPotential::Update()
+static void StorePositions(FESurface& s, vector<vec3d>& r)
 {
-	FEContactInterface::Update();
-
-	// update the constants
-	m_c1 = 0.5 * m_p * m_kc / ((m_Rout - m_Rin) * pow(m_Rin, m_p + 1.0));
-	m_c2 = m_kc / pow(m_Rin, m_p) - m_c1 * (m_Rin - m_Rout) * (m_Rin - m_Rout);
-
-	// Update the surfaces
-#pragma omp parallel 
+	r.clear();
+	for (int i = 0; i < s.Elements(); ++i)
 	{
-		UpdateSurface(m_surf1);
-		UpdateSurface(m_surf2);
+		FESurfaceElement& el = s.Element(i);
+		for (int n = 0; n < el.GaussPoints(); ++n) r.push_back(el.GetMaterialPoint(n)->m_rt);
 	}
+}
 
-	// build the grid
-	int ndivs = (int)pow(m_surf2.Elements(), 0.33333);
-	if (ndivs < 2) ndivs = 2;
-	Grid g;
-	if (g.Build(m_surf2, ndivs, m_Rout) == false)
+// returns the largest distance an integration point moved away from r0
+// (or -1 if the number of integration points changed)
+static double MaxDisplacement(FESurface& s, const vector<vec3d>& r0)
+{
+	double dmax2 = 0.0;
+	size_t k = 0;
+	for (int i = 0; i < s.Elements(); ++i)
 	{
-		throw std::runtime_error("Failed to build grid in FEContactPotential::Update");
+		FESurfaceElement& el = s.Element(i);
+		for (int n = 0; n < el.GaussPoints(); ++n, ++k)
+		{
+			if (k >= r0.size()) return -1.0;
+			double d2 = (el.GetMaterialPoint(n)->m_rt - r0[k]).norm2();
+			if (d2 > dmax2) dmax2 = d2;
+		}
 	}
+	return (k == r0.size() ? sqrt(dmax2) : -1.0);
+}
 
-	// build the list of active elements
-	m_activeElements.resize(m_surf1.Elements());
-#pragma omp parallel for shared(g) schedule(dynamic)
-	for (int i = 0; i < m_surf1.Elements(); ++i)
-	{
-		FESurfaceElement& el1 = m_surf1.Element(i);
+// The candidate pairs contain all pairs that were closer than R_out plus the skin
+// distance when they were built. As long as the largest displacements of the integration
+// points of the two surfaces add up to less than the skin distance, no other pair can
+// have come within R_out, so the candidates can be reused.
+bool FEContactPotential::CandidatesValid()
+{
+	double skin = SkinDistance();
+	if ((skin <= 0.0) || m_rc1.empty() || ((int)m_candStart.size() != m_surf1.Elements() + 1)) return false;
 
-		set<FESurfaceElement*>& activeElems = m_activeElements[i];
-		activeElems.clear();
+	double d1 = MaxDisplacement(m_surf1, m_rc1);
+	double d2 = MaxDisplacement(m_surf2, m_rc2);
+	if ((d1 < 0) || (d2 < 0)) return false;
 
-		// list of elements to exclude. This will be neighbors and elements
-		// already processed
-		set<FESurfaceElement*> excludeList = m_elemNeighbors[i];
+	return (d1 + d2 < skin);
+}
 
-		for (int n = 0; n < el1.GaussPoints(); ++n)
+void FEContactPotential::BuildCandidates()
+{
+	const double Rc = m_Rout + SkinDistance();
+
+	// re-bin the elements that moved, or rebuild the grid if needed
+	if (m_grid == nullptr) m_grid = new Grid;
+	if (m_grid->Update(m_surf2, Rc) == false)
+	{
+		int ndivs = (int)pow(m_surf2.Elements(), 0.33333);
+		if (ndivs < 2) ndivs = 2;
+		if (m_grid->Build(m_surf2, ndivs, Rc) == false)
+		{
+			throw std::runtime_error("Failed to build grid in FEContactPotential::Update");
+		}
+	}
+	Grid& g = *m_grid;
+
+	const int NE1 = m_surf1.Elements();
+	const int NE2 = m_surf2.Elements();
+
+	// First pass: find and count the candidates of each element. The candidates are
+	// collected in per-thread buffers, and we record where each element's list went.
+	int nt = omp_get_max_threads();
+	vector< vector<int> > buf(nt);
+	vector<int> owner(NE1, 0), offset(NE1, 0);
+	m_candStart.assign(NE1 + 1, 0);
+#pragma omp parallel shared(g)
+	{
+		int nthread = omp_get_thread_num();
+		vector<int>& tbuf = buf[nthread];
+
+		// mark[j] == i if element j is excluded from, or already added to, the list of element i
+		// visit[j] == stamp if element j was already tested against the current integration point
+		vector<int> mark(NE2, -1), visit(NE2, -1);
+		int stamp = 0;
+
+#pragma omp for schedule(dynamic)
+		for (int i = 0; i < NE1; ++i)
 		{
-			FECPContactPoint& mp1 = static_cast<FECPContactPoint&>(*el1.GetMaterialPoint(n));
-			mp1.m_gap = 0.0;
-			vec3d r1 = mp1.m_rt;
-			vec3d R1 = mp1.m_r0;
-			vec3d n1 = mp1.dxr ^ mp1.dxs; n1.unit();
-
-			// find the grid cell this point is in and loop over the cell's neighborhood
-			Grid::Cell* c[27] = { nullptr };
-			int nc = g.GetCellNeighborHood(r1, &c[0]);
-			for (int l = 0; l < nc; ++l)
+			FESurfaceElement& el1 = m_surf1.Element(i);
+			owner[i] = nthread;
+			offset[i] = (int)tbuf.size();
+
+			// neighbors are excluded (which can be the case for self-contact)
+			for (int k = m_nbrStart[i]; k < m_nbrStart[i + 1]; ++k) mark[m_nbr[k]] = i;
+
+			for (int n = 0; n < el1.GaussPoints(); ++n)
 			{
-				Grid::Cell* cl = c[l];
-				for (FESurfaceElement* el2 : cl->m_elemList)
+				FEMaterialPoint* mp1 = el1.GetMaterialPoint(n);
+				vec3d r1 = mp1->m_rt;
+				vec3d R1 = mp1->m_r0;
+				++stamp;
+
+				// find the grid cell this point is in and loop over the cell's neighborhood
+				Grid::Cell* c[27] = { nullptr };
+				int nc = g.GetCellNeighborHood(r1, &c[0]);
+				for (int l = 0; l < nc; ++l)
 				{
-					// make sure we did not process this element yet
-					// and the element is not a neighbor (which can be the case for self-contact)
-					if (excludeList.find(el2) == excludeList.end())
+					for (int j : c[l]->m_elemList)
 					{
-						// Next, we see if any integration point of el2 is close to the current 
-						// integration point of el1. 
-						vec3d r12;
-						for (int m = 0; m < el2->GaussPoints(); ++m)
+						if ((mark[j] == i) || (visit[j] == stamp)) continue;
+						visit[j] = stamp;
+
+						// see if any integration point of el2 is close to the current integration point of el1
+						FESurfaceElement& el2 = m_surf2.Element(j);
+						for (int m = 0; m < el2.GaussPoints(); ++m)
 						{
-							FEMaterialPoint* mp2 = el2->GetMaterialPoint(m);
-							vec3d r2 = mp2->m_rt;
-							vec3d R2 = mp2->m_r0;
-
-							r12.x = r1.x - r2.x;
-							r12.y = r1.y - r2.y;
-							r12.z = r1.z - r2.z;
-//							vec3d r12 = r1 - mp2.m_rt;
-							if ((r12.x < m_Rout) && (r12.x > -m_Rout) &&
-								(r12.y < m_Rout) && (r12.y > -m_Rout) &&
-								(r12.z < m_Rout) && (r12.z > -m_Rout) &&
-								(r12.norm2() < m_Rout * m_Rout))
+							FEMaterialPoint* mp2 = el2.GetMaterialPoint(m);
+							vec3d r12 = r1 - mp2->m_rt;
+							if ((r12.x < Rc) && (r12.x > -Rc) &&
+								(r12.y < Rc) && (r12.y > -Rc) &&
+								(r12.z < Rc) && (r12.z > -Rc) &&
+								(r12.norm2() < Rc * Rc) && ((mp2->m_r0 - R1).norm2() >= m_Rmin))
 							{
-								double L12 = (R2 - R1).norm2();
-								double l12 = r12.unit();
-								if ((fabs(r12 * n1) >= m_wtol) && (L12 >= m_Rmin))
-								{
-									// we found one, so insert it to the list of active elements
-									activeElems.insert(el2);
+								mark[j] = i;
+								tbuf.push_back(j);
+								break;
+							}
+						}
+					}
+				}
+			}
+
+			// store the list in element order
+			std::sort(tbuf.begin() + offset[i], tbuf.end());
+			m_candStart[i + 1] = (int)tbuf.size() - offset[i];
+		}
+	}
+
+	// Second pass: convert the counts to offsets and copy the lists
+	for (int i = 0; i < NE1; ++i) m_candStart[i + 1] += m_candStart[i];
+	m_cand.resize(m_candStart[NE1]);
+#pragma omp parallel for
+	for (int i = 0; i < NE1; ++i)
+	{
+		const int* src = buf[owner[i]].data() + offset[i];
+		std::copy(src, src + (m_candStart[i + 1] - m_candStart[i]), m_cand.begin() + m_candStart[i]);
+	}
 
-									// also insert it to the exclude list
-									excludeList.insert(el2);
+	// store the positions so we can tell when the candidates need to be rebuilt
+	StorePositions(m_surf1, m_rc1);
+	StorePositions(m_surf2, m_rc2);
+}
+
+void FEContactPotential::UpdateActivePairs()
+{
+	const int NE1 = m_surf1.Elements();
+	const int NE2 = m_surf2.Elements();
+
+	// First pass: select the active pairs of each element. Since these are a subset
+	// of the candidates, they are written to the candidate's position in a temporary list.
+	vector<int> tmp(m_cand.size());
+	m_activeStart.assign(NE1 + 1, 0);
+#pragma omp parallel
+	{
+		// mark[j] == i if element j was already added to the list of element i
+		vector<int> mark(NE2, -1);
 
-//									fprintf(stderr, "r12: %lg, %lg, %lg\n", r12.x, r12.y, r12.z);
-//									fprintf(stderr, "n1 : %lg, %lg, %lg\n", n1.x, n1.y, n1.z);
-//									fprintf(stderr, "l12 = %lg\n", l12);
+#pragma omp for schedule(dynamic)
+		for (int i = 0; i < NE1; ++i)
+		{
+			FESurfaceElement& el1 = m_surf1.Element(i);
+			const int c0 = m_candStart[i], c1 = m_candStart[i + 1];
+			int na = 0;
 
-									if ((mp1.m_gap == 0.0) || (l12 < mp1.m_gap))
-									{
-										mp1.m_gap = l12;
-									}
-									break;
+			for (int n = 0; n < el1.GaussPoints(); ++n)
+			{
+				FECPContactPoint& mp1 = static_cast<FECPContactPoint&>(*el1.GetMaterialPoint(n));
+				mp1.m_gap = 0.0;
+				vec3d r1 = mp1.m_rt;
+				vec3d R1 = mp1.m_r0;
+				vec3d n1 = mp1.dxr ^ mp1.dxs; n1.unit();
+
+				for (int k = c0; k < c1; ++k)
+				{
+					int j = m_cand[k];
+					if (mark[j] == i) continue;
+
+					// Next, we see if any integration point of el2 is close to the current 
+					// integration point of el1. 
+					FESurfaceElement& el2 = m_surf2.Element(j);
+					vec3d r12;
+					for (int m = 0; m < el2.GaussPoints(); ++m)
+					{
+						FEMaterialPoint* mp2 = el2.GetMaterialPoint(m);
+						vec3d r2 = mp2->m_rt;
+						vec3d R2 = mp2->m_r0;
+
+						r12.x = r1.x - r2.x;
+						r12.y = r1.y - r2.y;
+						r12.z = r1.z - r2.z;
+						if ((r12.x < m_Rout) && (r12.x > -m_Rout) &&
+							(r12.y < m_Rout) && (r12.y > -m_Rout) &&
+							(r12.z < m_Rout) && (r12.z > -m_Rout) &&
+							(r12.norm2() < m_Rout * m_Rout))
+						{
+							double L12 = (R2 - R1).norm2();
+							double l12 = r12.unit();
+							if ((fabs(r12 * n1) >= m_wtol) && (L12 >= m_Rmin))
+							{
+								// we found one, so add it to the list of active elements
+								mark[j] = i;
+								tmp[c0 + na++] = j;
+
+								if ((mp1.m_gap == 0.0) || (l12 < mp1.m_gap))
+								{
+									mp1.m_gap = l12;
 								}
+								break;
 							}
 						}
-
 					}
 				}
 			}
+
+			// store the list in element order
+			std::sort(tmp.begin() + c0, tmp.begin() + c0 + na);
+			m_activeStart[i + 1] = na;
 		}
 	}
+
+	// Second pass: convert the counts to offsets and copy the lists
+	for (int i = 0; i < NE1; ++i) m_activeStart[i + 1] += m_activeStart[i];
+	m_active.resize(m_activeStart[NE1]);
+#pragma omp parallel for
+	for (int i = 0; i < NE1; ++i)
+	{
+		int na = m_activeStart[i + 1] - m_activeStart[i];
+		std::copy(tmp.begin() + m_candStart[i], tmp.begin() + m_candStart[i] + na, m_active.begin() + m_activeStart[i]);
+	}
+}
+
+// update
+void FEContactPotential::Update()
+{
+	FEContactInterface::Update();
+
+	// update the constants
+	m_c1 = 0.5 * m_p * m_kc / ((m_Rout - m_Rin) * pow(m_Rin, m_p + 1.0));
+	m_c2 = m_kc / pow(m_Rin, m_p) - m_c1 * (m_Rin - m_Rout) * (m_Rin - m_Rout);
+
+	// Update the surfaces
+#pragma omp parallel 
+	{
+		UpdateSurface(m_surf1);
+		UpdateSurface(m_surf2);
+	}
+
+	// the candidate pairs only need to be rebuilt when the surfaces moved more than the skin distance
+	if (CandidatesValid() == false) BuildCandidates();
+
+	// find the pairs that are within the cutoff distance
+	UpdateActivePairs();
 }
 
 // Build the matrix profile
@@ -545,9 +775,9 @@ void FEContactPotential::BuildMatrixProfile(FEGlobalMatrix& M)
 		}
 
 		// add all active dofs of surface 2
-		set<FESurfaceElement*>& activeElems = m_activeElements[i];
-		for (FESurfaceElement* el2 : activeElems)
+		for (int k = m_activeStart[i]; k < m_activeStart[i + 1]; ++k)
 		{
+			FESurfaceElement* el2 = &m_surf2.Element(m_active[k]);
 			for (int j = 0; j < el2->Nodes(); ++j)
 			{
 				FENode& node = m_surf2.Node(el2->m_lnode[j]);
@@ -622,7 +852,7 @@ void FEContactPotential::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 	}
 
 	// loop over all elements of surf 1
-#pragma omp parallel for shared(R)
+#pragma omp parallel for schedule(static) shared(R)
 	for (int i = 0; i < m_surf1.Elements(); ++i)
 	{
 		FESurfaceElement& eli = m_surf1.Element(i);
@@ -631,10 +861,10 @@ void FEContactPotential::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		vector<double> fe;
 		vector<int> lm;
 
-		// loop over all elements of surf 2
-		set<FESurfaceElement*>& activeElems = m_activeElements[i];
-		for (FESurfaceElement* elj : activeElems)
+		// loop over all active elements of surf 2
+		for (int k = m_activeStart[i]; k < m_activeStart[i + 1]; ++k)
 		{
+			FESurfaceElement* elj = &m_surf2.Element(m_active[k]);
 			int nb = elj->Nodes();
 
 			// evaluate contribution to force vector
@@ -759,9 +989,9 @@ void FEContactPotential::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& t
 		FESurfaceElement& eli = m_surf1.Element(i);
 		int na = eli.Nodes();
 
-		set<FESurfaceElement*>& activeElems = m_activeElements[i];
-		for (FESurfaceElement* elj : activeElems)
+		for (int k = m_activeStart[i]; k < m_activeStart[i + 1]; ++k)
 		{
+			FESurfaceElement* elj = &m_surf2.Element(m_active[k]);
 			int nb = elj->Nodes();
 
 			FEElementMatrix ke((na + nb) * ndof, (na + nb) * ndof);
@@ -886,5 +1116,8 @@ void FEContactPotential::Serialize(DumpStream& ar)
 	m_surf1.Serialize(ar);
 	m_surf2.Serialize(ar);
 
+	// this also resets the candidate pairs
 	BuildNeighborTable();
+	delete m_grid;
+	m_grid = nullptr;
 }
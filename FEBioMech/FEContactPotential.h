@@ -26,7 +26,6 @@ SOFTWARE.*/
 #pragma once
 #include "FEContactInterface.h"
 #include "FEContactSurface.h"
-#include <set>
 
 class FEContactPotentialSurface : public FEContactSurface
 {
@@ -57,8 +56,11 @@ typedef FEContactPotentialSurface::Data FECPContactPoint;
 
 class FEContactPotential : public FEContactInterface
 {
+	class Grid;
+
 public:
 	FEContactPotential(FEModel* fem);
+	~FEContactPotential();
 
 	// -- From FESurfacePairConstraint
 public:
@@ -100,6 +102,18 @@ protected:
 
 	void BuildNeighborTable();
 
+	// see if the candidate pairs can be reused
+	bool CandidatesValid();
+
+	// (re)build the list of candidate pairs
+	void BuildCandidates();
+
+	// select the active pairs from the candidate pairs
+	void UpdateActivePairs();
+
+	// the skin distance that is added to the cutoff radius for the candidate pairs
+	double SkinDistance() const { return m_skin * m_Rout; }
+
 protected:
 	FEContactPotentialSurface	m_surf1;
 	FEContactPotentialSurface	m_surf2;
@@ -111,11 +125,18 @@ protected:
 	double	m_Rout;
 	double	m_Rmin;
 	double	m_wtol;
+	double	m_skin;	//!< skin distance of the candidate pairs (as a fraction of R_out)
 
 	double	m_c1, m_c2;
 
-	std::vector< std::set<FESurfaceElement*> >	m_activeElements;
-	std::vector< std::set<FESurfaceElement*> >	m_elemNeighbors;
+	// The pair lists are stored in compressed row format: the surface 2 elements
+	// paired with element i of surface 1 are list[start[i]], ..., list[start[i+1]-1].
+	std::vector<int>	m_activeStart, m_active;	//!< pairs that are within the cutoff radius
+	std::vector<int>	m_candStart, m_cand;		//!< pairs that are within the cutoff radius plus the skin
+	std::vector<int>	m_nbrStart, m_nbr;			//!< surface 2 elements that share nodes with surface 1 elements
+
+	std::vector<vec3d>	m_rc1, m_rc2;	//!< integration point positions when the candidates were built
+	Grid*				m_grid;			//!< grid of surface 2 integration points
 
 	DECLARE_FECORE_CLASS();
 };
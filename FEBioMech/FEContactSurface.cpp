@@ -39,6 +39,7 @@ FEContactSurface::FEContactSurface(FEModel* pfem) : FESurface(pfem), m_pfem(pfem
 	m_dofX = -1;
 	m_dofY = -1;
 	m_dofZ = -1;
+	m_bEEL = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -57,6 +58,18 @@ bool FEContactSurface::Init()
 	return FESurface::Init();
 }
 
+//-----------------------------------------------------------------------------
+FEElemElemList* FEContactSurface::GetFacetNeighbors()
+{
+	if (Elements() == 0) return nullptr;
+	if (m_bEEL == false)
+	{
+		m_EEL.Create(this);
+		m_bEEL = true;
+	}
+	return &m_EEL;
+}
+
 //-----------------------------------------------------------------------------
 // serialization
 void FEContactSurface::Serialize(DumpStream& ar)
@@ -30,6 +30,8 @@ SOFTWARE.*/
 
 #include <FECore/FESurface.h>
 #include <FECore/vec2d.h>
+#include <FECore/FESurfaceBVH.h>
+#include <FECore/FEElemElemList.h>
 #include "FEContactInterface.h"
 #include "febiomech_api.h"
 
@@ -121,6 +123,14 @@ public:
 
 	FEModel* GetFEModel() { return m_pfem; }
 
+	//! Search tree over the facets of this surface. It persists between projections 
+	//! onto this surface, so that it only needs to be refit to the current configuration.
+	FESurfaceBVH* GetSearchTree() { m_bvh.Attach(this); return &m_bvh; }
+
+	//! Facet neighbor list of this surface (created on first use). It is used to walk
+	//! across the surface from a previous contact pairing.
+	FEElemElemList* GetFacetNeighbors();
+
 protected:
 	FEContactSurface* m_pSibling;
     FEContactInterface* m_pContactInterface;
@@ -129,4 +139,8 @@ protected:
 	int	m_dofX;
 	int	m_dofY;
 	int	m_dofZ;
+
+	FESurfaceBVH	m_bvh;	//!< search tree for projections onto this surface
+	FEElemElemList	m_EEL;	//!< facet neighbor list
+	bool			m_bEEL;	//!< was the facet neighbor list created?
 };
@@ -37,6 +37,7 @@ SOFTWARE.*/
 #include <FECore/FESolidDomain.h>
 #include <FECore/FELinearSystem.h>
 #include "FEBioMech.h"
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 FEElasticANSShellDomain::FEElasticANSShellDomain(FEModel* pfem) : FESSIShellDomain(pfem), FEElasticDomain(pfem), m_dofV(pfem), m_dofSV(pfem), m_dofSA(pfem), m_dofR(pfem), m_dof(pfem)
@@ -156,16 +157,16 @@ void FEElasticANSShellDomain::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NS)
     for (int i=0; i<NS; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
 		FEShellElementNew& el = m_Elem[i];
         
         // create the element force vector and initialize to zero
         int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate element's internal force
         ElementInternalForce(el, fe);
@@ -260,16 +261,16 @@ void FEElasticANSShellDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 #pragma omp parallel for
     for (int i=0; i<NS; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
 		FEShellElementNew& el = m_Elem[i];
         
         // create the element force vector and initialize to zero
         int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // apply body forces to shells
         ElementBodyForce(BF, el, fe);
@@ -334,16 +335,16 @@ void FEElasticANSShellDomain::InertialForces(FEGlobalVector& R, vector<double>&
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElementNew& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInertialForce(el, fe);
@@ -470,15 +471,15 @@ void FEElasticANSShellDomain::StiffnessMatrix(FELinearSystem& LS)
 		FEShellElement& el = m_Elem[iel];
 
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementStiffness(iel, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -498,16 +499,16 @@ void FEElasticANSShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 		FEShellElementNew& el = m_Elem[iel];
 
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
         ElementMassMatrix(el, ke, scale);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -527,16 +528,16 @@ void FEElasticANSShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce
 		FEShellElementNew& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
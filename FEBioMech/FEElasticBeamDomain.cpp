@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include <FECore/FEAnalysis.h>
 #include <FECore/FESolver.h>
 #include <FECore/fecore_debug.h>
+#include <FECore/FEElementScratch.h>
 
 
 FEElasticBeamDomain::FEElasticBeamDomain(FEModel* fem) : FEBeamDomain(fem), FEElasticDomain(fem), 
@@ -151,11 +152,12 @@ void FEElasticBeamDomain::InternalForces(FEGlobalVector& R)
 
 		int ne = el.Nodes();
 		int ndof = ne * 6;
-		vector<double> fe(ndof, 0.0);
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<double>& fe = scratch.Vector(ndof);
 
 		ElementInternalForces(el, fe);
 
-		vector<int> lm(6*ne);
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		R.Assemble(lm, fe);
 	}
@@ -225,10 +227,11 @@ void FEElasticBeamDomain::StiffnessMatrix(FELinearSystem& LS)
 
 		int ne = el.Nodes();
 		int ndof = ne * 6;
-		vector<int> lm;
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 
-		FEElementMatrix ke(el, lm); ke.zero();
+		FEElementMatrix& ke = scratch.Matrix(el, lm, ndof, ndof);
 		ElementStiffnessMatrix(el, ke);
 
 		LS.Assemble(ke);
@@ -515,9 +518,10 @@ void FEElasticBeamDomain::InertialForces(FEGlobalVector& R, std::vector<double>&
 	for (auto& el : m_Elem)
 	{
 		int neln = el.Nodes();
-		vector<double> fe(6 * neln, 0.0);
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<double>& fe = scratch.Vector(6 * neln);
 		ElementInertialForce(el, fe);
-		vector<int> lm(6 * neln);
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		R.Assemble(lm, fe);
 	}
@@ -558,12 +562,12 @@ void FEElasticBeamDomain::MassMatrix(FELinearSystem& LS, double scale)
 	for (auto& el : m_Elem)
 	{
 		int neln = el.Nodes();
-		FEElementMatrix ke(6 * neln, 6 * neln); ke.zero();
+		FEElementScratch& scratch = FEElementScratch::Get();
+		FEElementMatrix& ke = scratch.Matrix(el, 6 * neln, 6 * neln);
 		ElementMassMatrix(el, ke);
-		vector<int> lm(6 * neln);
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
-		ke.SetNodes(el.m_node);
 		LS.Assemble(ke);
 	}
 }
@@ -36,6 +36,7 @@ class FEGlobalVector;
 class FEBodyForce;
 class FESolver;
 class FELinearSystem;
+class FETaskList;
 
 //-----------------------------------------------------------------------------
 //! Abstract interface class for elastic domains.
@@ -73,4 +74,19 @@ public:
 
 	//! calculate the mass matrix (for dynamic problems)
 	virtual void MassMatrix(FELinearSystem& LS, double scale) = 0;
+
+	// --- T A S K S ---
+
+	//! Add the evaluation of the internal forces to a task list instead of evaluating them 
+	//! in InternalForces. This allows all domains to be processed in one parallel region.
+	//! Returns false if the domain does not support this.
+	virtual bool InternalForcesTasks(FEGlobalVector& R, FETaskList& tasks) { return false; }
+
+	//! Add the evaluation of the stiffness matrix to a task list instead of evaluating it 
+	//! in StiffnessMatrix. Returns false if the domain does not support this.
+	virtual bool StiffnessMatrixTasks(FELinearSystem& LS, FETaskList& tasks) { return false; }
+
+	//! Add the evaluation of the body force vector to a task list instead of evaluating it 
+	//! in BodyForce. Returns false if the domain does not support this.
+	virtual bool BodyForceTasks(FEGlobalVector& R, FEBodyForce& bf, FETaskList& tasks) { return false; }
 };
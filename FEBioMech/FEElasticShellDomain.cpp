@@ -37,6 +37,9 @@ SOFTWARE.*/
 #include <FECore/FESolidDomain.h>
 #include <FECore/FELinearSystem.h>
 #include "FEBioMech.h"
+#include <FECore/FEElementScratch.h>
+#include <FECore/FETaskList.h>
+#include <typeinfo>
 
 //-----------------------------------------------------------------------------
 FEElasticShellDomain::FEElasticShellDomain(FEModel* pfem) : FESSIShellDomain(pfem), FEElasticDomain(pfem), m_dofV(pfem), m_dofSV(pfem), m_dofSA(pfem), m_dofR(pfem), m_dof(pfem)
@@ -160,28 +163,58 @@ void FEElasticShellDomain::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NS)
     for (int i=0; i<NS; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
-        
-        // get the element
-        FEShellElement& el = m_Elem[i];
-        
-        // create the element force vector and initialize to zero
-        int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
-        
-        // calculate element's internal force
-        ElementInternalForce(el, fe);
-        
-        // get the element's LM vector
-        UnpackLM(el, lm);
-        
-        // assemble the residual
-        R.Assemble(el.m_node, lm, fe, true);
+        AssembleElementInternalForce(R, i);
     }
 }
 
+//-----------------------------------------------------------------------------
+void FEElasticShellDomain::AssembleElementInternalForce(FEGlobalVector& R, int iel)
+{
+    // scratch buffers for the element force vector and LM vector
+    FEElementScratch& scratch = FEElementScratch::Get();
+    vector<int>& lm = scratch.LM();
+    
+    // get the element
+    FEShellElement& el = m_Elem[iel];
+    
+    // create the element force vector and initialize to zero
+    int ndof = 6*el.Nodes();
+    vector<double>& fe = scratch.Vector(ndof);
+    
+    // calculate element's internal force
+    ElementInternalForce(el, fe);
+    
+    // get the element's LM vector
+    UnpackLM(el, lm);
+    
+    // assemble the residual
+    R.Assemble(el.m_node, lm, fe, true);
+}
+
+//-----------------------------------------------------------------------------
+//! Derived classes that override InternalForces or StiffnessMatrix evaluate their
+//! elements differently, so only this class is evaluated as tasks.
+bool FEElasticShellDomain::InternalForcesTasks(FEGlobalVector& R, FETaskList& tasks)
+{
+    if (typeid(*this) != typeid(FEElasticShellDomain)) return false;
+
+    tasks.AddTask(Elements(), [this, &R](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) AssembleElementInternalForce(R, i);
+    });
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEElasticShellDomain::StiffnessMatrixTasks(FELinearSystem& LS, FETaskList& tasks)
+{
+    if (typeid(*this) != typeid(FEElasticShellDomain)) return false;
+
+    tasks.AddTask(Elements(), [this, &LS](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) AssembleElementStiffness(LS, i);
+    });
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 //! calculates the internal equivalent nodal forces for shell elements
 //! Note that we use a one-point gauss integration rule for the thickness
@@ -246,16 +279,16 @@ void FEElasticShellDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 #pragma omp parallel for
     for (int i=0; i<NS; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElement& el = m_Elem[i];
         
         // create the element force vector and initialize to zero
         int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // apply body forces to shells
         ElementBodyForce(BF, el, fe);
@@ -320,16 +353,16 @@ void FEElasticShellDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInertialForce(el, fe);
@@ -448,26 +481,32 @@ void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
 #pragma omp parallel for shared (NS)
     for (int iel=0; iel<NS; ++iel)
     {
-		FEShellElement& el = m_Elem[iel];
-        
-        // create the element's stiffness matrix
-		FEElementMatrix ke(el);
-		int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
-        
-        // calculate the element stiffness matrix
-        ElementStiffness(iel, ke);
-        
-        // get the element's LM vector
-		vector<int> lm;
-		UnpackLM(el, lm);
-		ke.SetIndices(lm);
-        
-        // assemble element matrix in global stiffness matrix
-		LS.Assemble(ke);
+        AssembleElementStiffness(LS, iel);
     }
 }
 
+//-----------------------------------------------------------------------------
+void FEElasticShellDomain::AssembleElementStiffness(FELinearSystem& LS, int iel)
+{
+	FEShellElement& el = m_Elem[iel];
+    
+    // create the element's stiffness matrix
+	FEElementScratch& scratch = FEElementScratch::Get();
+	int ndof = 6*el.Nodes();
+    FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
+    
+    // calculate the element stiffness matrix
+    ElementStiffness(iel, ke);
+    
+    // get the element's LM vector
+	vector<int>& lm = scratch.LM();
+	UnpackLM(el, lm);
+	ke.SetIndices(lm);
+    
+    // assemble element matrix in global stiffness matrix
+	LS.Assemble(ke);
+}
+
 //-----------------------------------------------------------------------------
 void FEElasticShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 {
@@ -479,16 +518,15 @@ void FEElasticShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 		FEShellElement& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate inertial stiffness
         ElementMassMatrix(el, ke, scale);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -508,16 +546,15 @@ void FEElasticShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
 		FEShellElement& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = 6*el.Nodes();
-        ke.resize(ndof, ndof);
-        ke.zero();
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate inertial stiffness
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
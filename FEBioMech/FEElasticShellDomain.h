@@ -94,6 +94,12 @@ public: // overrides from FEElasticDomain
 	// body force stiffness
     void BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf) override;
 
+	//! add the internal forces to a task list
+	bool InternalForcesTasks(FEGlobalVector& R, FETaskList& tasks) override;
+
+	//! add the stiffness matrix to a task list
+	bool StiffnessMatrixTasks(FELinearSystem& LS, FETaskList& tasks) override;
+
 public:
 
 	// --- S T I F F N E S S --- 
@@ -101,6 +107,9 @@ public:
 	//! calculates the shell element stiffness matrix
 	void ElementStiffness(int iel, matrix& ke);
 
+	//! calculates the stiffness matrix of element iel and assembles it
+	void AssembleElementStiffness(FELinearSystem& LS, int iel);
+
     //! calculates the solid element mass matrix
     void ElementMassMatrix(FEShellElement& el, matrix& ke, double a);
     
@@ -112,6 +121,9 @@ public:
 	//! Calculates the internal stress vector for shell elements
 	void ElementInternalForce(FEShellElement& el, vector<double>& fe);
 
+	//! calculates the internal forces of element iel and assembles them
+	void AssembleElementInternalForce(FEGlobalVector& R, int iel);
+
 	//! Calculate extenral body forces for shell elements
 	void ElementBodyForce(FEModel& fem, FEShellElement& el, vector<double>& fe);
 
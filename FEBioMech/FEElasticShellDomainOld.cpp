@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include <FECore/FELinearSystem.h>
 #include <math.h>
 #include "FEBioMech.h"
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 FEElasticShellDomainOld::FEElasticShellDomainOld(FEModel* pfem) : FEShellDomainOld(pfem), FEElasticDomain(pfem), m_dofSU(pfem), m_dofSR(pfem), m_dofR(pfem), m_dof(pfem)
@@ -354,10 +355,9 @@ double FEElasticShellDomainOld::invjact(FEShellElementOld& el, double Ji[3][3],
 // Calculates the forces due to the stress
 void FEElasticShellDomainOld::InternalForces(FEGlobalVector& R)
 {
-	// element force vector
-	vector<double> fe;
-
-	vector<int> lm;
+	// scratch buffers for the element force vector and LM vector
+	FEElementScratch& scratch = FEElementScratch::Get();
+	vector<int>& lm = scratch.LM();
 
 	int NS = (int)m_Elem.size();
 	for (int i=0; i<NS; ++i)
@@ -367,7 +367,7 @@ void FEElasticShellDomainOld::InternalForces(FEGlobalVector& R)
 
 		// create the element force vector and initialize to zero
 		int ndof = 6*el.Nodes();
-		fe.assign(ndof, 0);
+		vector<double>& fe = scratch.Vector(ndof);
 
 		// calculate element's internal force
 		ElementInternalForce(el, fe);
@@ -447,10 +447,9 @@ void FEElasticShellDomainOld::ElementInternalForce(FEShellElementOld& el, vector
 //-----------------------------------------------------------------------------
 void FEElasticShellDomainOld::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 {
-	// element force vector
-	vector<double> fe;
-
-	vector<int> lm;
+	// scratch buffers for the element force vector and LM vector
+	FEElementScratch& scratch = FEElementScratch::Get();
+	vector<int>& lm = scratch.LM();
 
 	int NS = (int)m_Elem.size();
 	for (int i=0; i<NS; ++i)
@@ -460,7 +459,7 @@ void FEElasticShellDomainOld::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 
 		// create the element force vector and initialize to zero
 		int ndof = 6*el.Nodes();
-		fe.assign(ndof, 0);
+		vector<double>& fe = scratch.Vector(ndof);
 
 		// apply body forces to shells
 		ElementBodyForce(BF, el, fe);
@@ -533,15 +532,15 @@ void FEElasticShellDomainOld::StiffnessMatrix(FELinearSystem& LS)
 		FEMaterial* pmat = m_pMat;
 
 		// create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = 6*el.Nodes();
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 
 		// calculate the element stiffness matrix
 		ElementStiffness(iel, ke);
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
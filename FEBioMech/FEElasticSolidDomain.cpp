@@ -37,6 +37,10 @@ SOFTWARE.*/
 #include "FEBioMech.h"
 #include <FECore/FELinearSystem.h>
 #include "FEResidualVector.h"
+#include <FECore/FEElementScratch.h>
+#include <FECore/FETaskList.h>
+#include <FECore/FESolidElementKernel.h>
+#include <typeinfo>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -52,6 +56,8 @@ FEElasticSolidDomain::FEElasticSolidDomain(FEModel* pfem) : FESolidDomain(pfem),
 	m_secant_stress = false;
 	m_secant_tangent = false;
 
+	m_batchStiffness = false;
+
 	// TODO: Can this be done in Init, since  there is no error checking
 	if (pfem)
 	{
@@ -165,32 +171,311 @@ void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 {
 	int NE = Elements();
 	#pragma omp parallel for shared (NE)
-	for (int i=0; i<NE; ++i)
+	for (int i=0; i<NE; ++i) AssembleElementInternalForce(R, i);
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticSolidDomain::AssembleElementInternalForce(FEGlobalVector& R, int iel)
+{
+	// get the element
+	FESolidElement& el = m_Elem[iel];
+
+	if (el.isActive()) {
+		// scratch buffers for the element force vector and LM vector
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<int>& lm = scratch.LM();
+
+		// get the element force vector and initialize it to zero
+		int ndof = 3 * el.Nodes();
+		vector<double>& fe = scratch.Vector(ndof);
+
+		// calculate internal force vector
+		ElementInternalForce(el, fe);
+
+		// get the element's LM vector
+		UnpackLM(el, lm);
+
+		// assemble element 'fe'-vector into global R vector
+		R.Assemble(el.m_node, lm, fe);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! The integrand of the body force vector
+static FEVolumeVectorIntegrand bodyForceIntegrand(FESolidMaterial* mat, FEBodyForce* bodyForce)
+{
+	return [=](FEMaterialPoint& mp, int node_a, std::vector<double>& fa) {
+
+		// evaluate density
+		double density = mat->Density(mp);
+
+		// get the force
+		vec3d f = bodyForce->force(mp);
+
+		// get element shape functions
+		double* H = mp.m_shape;
+
+		// get the initial Jacobian
+		double J0 = mp.m_J0;
+
+		// set integrand
+		fa[0] = -H[node_a] * density* f.x * J0;
+		fa[1] = -H[node_a] * density* f.y * J0;
+		fa[2] = -H[node_a] * density* f.z * J0;
+	};
+}
+
+//-----------------------------------------------------------------------------
+//! Derived classes that override InternalForces, StiffnessMatrix or BodyForce evaluate
+//! their elements differently, so only the standard domains are evaluated as tasks.
+static bool hasStandardElementLoops(FEElasticSolidDomain& dom)
+{
+	return ((typeid(dom) == typeid(FEElasticSolidDomain)) || (typeid(dom) == typeid(FEStandardElasticSolidDomain)));
+}
+
+//-----------------------------------------------------------------------------
+bool FEElasticSolidDomain::InternalForcesTasks(FEGlobalVector& R, FETaskList& tasks)
+{
+	if (hasStandardElementLoops(*this) == false) return false;
+
+	tasks.AddTask(Elements(), [this, &R](int i0, int i1) {
+		for (int i = i0; i < i1; ++i) AssembleElementInternalForce(R, i);
+	});
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEElasticSolidDomain::StiffnessMatrixTasks(FELinearSystem& LS, FETaskList& tasks)
+{
+	// colored assembly relies on processing the domain color by color
+	if (LS.ColoredAssembly()) return false;
+	if (hasStandardElementLoops(*this) == false) return false;
+
+	// for symmetric systems, we only need the upper triangle of the element matrices
+	bool upper = LS.UpperTriangularAssembly();
+
+	if (BatchStiffness())
 	{
-		// get the element
-		FESolidElement& el = m_Elem[i];
+		tasks.AddTask(Elements(), [this, &LS, upper](int i0, int i1) {
+			int elemList[STIFFNESS_BATCH];
+			for (int i = i0; i < i1; i += STIFFNESS_BATCH)
+			{
+				int n = (i + STIFFNESS_BATCH <= i1 ? STIFFNESS_BATCH : i1 - i);
+				for (int l = 0; l < n; ++l) elemList[l] = i + l;
+				AssembleBatchStiffness(LS, elemList, n, upper);
+			}
+		});
+		return true;
+	}
 
-		if (el.isActive()) {
-			// element force vector
-			vector<double> fe;
-			vector<int> lm;
+	tasks.AddTask(Elements(), [this, &LS, upper](int i0, int i1) {
+		for (int i = i0; i < i1; ++i) AssembleElementStiffness(LS, i, upper);
+	});
+	return true;
+}
 
-			// get the element force vector and initialize it to zero
-			int ndof = 3 * el.Nodes();
-			fe.assign(ndof, 0);
+//-----------------------------------------------------------------------------
+bool FEElasticSolidDomain::BodyForceTasks(FEGlobalVector& R, FEBodyForce& bf, FETaskList& tasks)
+{
+	if (hasStandardElementLoops(*this) == false) return false;
 
-			// calculate internal force vector
-			ElementInternalForce(el, fe);
+	FEVolumeVectorIntegrand f = bodyForceIntegrand(m_pMat, &bf);
+	tasks.AddTask(Elements(), [this, &R, f](int i0, int i1) {
+		for (int i = i0; i < i1; ++i) ElementLoadVector(R, i, m_dofU, f);
+	});
+	return true;
+}
 
-			// get the element's LM vector
-			UnpackLM(el, lm);
+//-----------------------------------------------------------------------------
+// The batched kernel requires that all elements are of the same type.
+bool FEElasticSolidDomain::BatchStiffness() const
+{
+	return (m_batchStiffness && (ElementKernel() != FE_ELEM_INVALID_TYPE) && 
+		hasStandardElementLoops(const_cast<FEElasticSolidDomain&>(*this)));
+}
 
-			// assemble element 'fe'-vector into global R vector
-			R.Assemble(el.m_node, lm, fe);
+//-----------------------------------------------------------------------------
+// The loops over the element nodes of the internal force and stiffness calculations. 
+// NELN is the number of nodes for the element types with specialized kernels, or 0 
+// for the generic version (see FESolidElementKernel). When upper is true, the 
+// stiffness kernels only evaluate the node blocks (i,j) with j >= i.
+template <int NELN> static void addInternalForce(int neln, const double Ji[3][3], const double* Gr, const double* Gs, const double* Gt, const mat3ds& s, double detJt, double* fe)
+{
+	const int ne = (NELN > 0 ? NELN : neln);
+	for (int i=0; i<ne; ++i)
+	{
+		// calculate global gradient of shape functions
+		// note that we need the transposed of Ji, not Ji itself !
+		double Gx = Ji[0][0]*Gr[i]+Ji[1][0]*Gs[i]+Ji[2][0]*Gt[i];
+		double Gy = Ji[0][1]*Gr[i]+Ji[1][1]*Gs[i]+Ji[2][1]*Gt[i];
+		double Gz = Ji[0][2]*Gr[i]+Ji[1][2]*Gs[i]+Ji[2][2]*Gt[i];
+
+		// calculate internal force
+		// the '-' sign is so that the internal forces get subtracted
+		// from the global residual vector
+		fe[3*i  ] -= ( Gx*s.xx() +
+			           Gy*s.xy() +
+				       Gz*s.xz() )*detJt;
+
+		fe[3*i+1] -= ( Gy*s.yy() +
+			           Gx*s.xy() +
+				       Gz*s.yz() )*detJt;
+
+		fe[3*i+2] -= ( Gz*s.zz() +
+			           Gy*s.yz() +
+				       Gx*s.xz() )*detJt;
+	}
+}
+
+template <int NELN> static void addGeometricalStiffness(int neln, const vec3d* G, const mat3ds& s, double w, matrix& ke, bool upper)
+{
+	const int ne = (NELN > 0 ? NELN : neln);
+	for (int i = 0; i<ne; ++i)
+		for (int j = (upper ? i : 0); j<ne; ++j)
+		{
+			double kab = (G[i]*(s * G[j]))*w;
+
+			ke[3*i  ][3*j  ] += kab;
+			ke[3*i+1][3*j+1] += kab;
+			ke[3*i+2][3*j+2] += kab;
+		}
+}
+
+template <int NELN> static void addMaterialStiffness(int neln, const vec3d* G, const double D[6][6], double detJt, matrix& ke, bool upper)
+{
+	const int ne = (NELN > 0 ? NELN : neln);
+
+	double Gxi, Gyi, Gzi;
+	double Gxj, Gyj, Gzj;
+
+	// The 'D*BL' matrix
+	double DBL[6][3];
+
+	for (int i=0, i3=0; i<ne; ++i, i3 += 3)
+	{
+		Gxi = G[i].x;
+		Gyi = G[i].y;
+		Gzi = G[i].z;
+
+		for (int j = (upper ? i : 0), j3 = 3*j; j<ne; ++j, j3 += 3)
+		{
+			Gxj = G[j].x;
+			Gyj = G[j].y;
+			Gzj = G[j].z;
+
+			// calculate D*BL matrices
+			DBL[0][0] = (D[0][0]*Gxj+D[0][3]*Gyj+D[0][5]*Gzj);
+			DBL[0][1] = (D[0][1]*Gyj+D[0][3]*Gxj+D[0][4]*Gzj);
+			DBL[0][2] = (D[0][2]*Gzj+D[0][4]*Gyj+D[0][5]*Gxj);
+
+			DBL[1][0] = (D[1][0]*Gxj+D[1][3]*Gyj+D[1][5]*Gzj);
+			DBL[1][1] = (D[1][1]*Gyj+D[1][3]*Gxj+D[1][4]*Gzj);
+			DBL[1][2] = (D[1][2]*Gzj+D[1][4]*Gyj+D[1][5]*Gxj);
+
+			DBL[2][0] = (D[2][0]*Gxj+D[2][3]*Gyj+D[2][5]*Gzj);
+			DBL[2][1] = (D[2][1]*Gyj+D[2][3]*Gxj+D[2][4]*Gzj);
+			DBL[2][2] = (D[2][2]*Gzj+D[2][4]*Gyj+D[2][5]*Gxj);
+
+			DBL[3][0] = (D[3][0]*Gxj+D[3][3]*Gyj+D[3][5]*Gzj);
+			DBL[3][1] = (D[3][1]*Gyj+D[3][3]*Gxj+D[3][4]*Gzj);
+			DBL[3][2] = (D[3][2]*Gzj+D[3][4]*Gyj+D[3][5]*Gxj);
+
+			DBL[4][0] = (D[4][0]*Gxj+D[4][3]*Gyj+D[4][5]*Gzj);
+			DBL[4][1] = (D[4][1]*Gyj+D[4][3]*Gxj+D[4][4]*Gzj);
+			DBL[4][2] = (D[4][2]*Gzj+D[4][4]*Gyj+D[4][5]*Gxj);
+
+			DBL[5][0] = (D[5][0]*Gxj+D[5][3]*Gyj+D[5][5]*Gzj);
+			DBL[5][1] = (D[5][1]*Gyj+D[5][3]*Gxj+D[5][4]*Gzj);
+			DBL[5][2] = (D[5][2]*Gzj+D[5][4]*Gyj+D[5][5]*Gxj);
+
+			ke[i3  ][j3  ] += (Gxi*DBL[0][0] + Gyi*DBL[3][0] + Gzi*DBL[5][0] )*detJt;
+			ke[i3  ][j3+1] += (Gxi*DBL[0][1] + Gyi*DBL[3][1] + Gzi*DBL[5][1] )*detJt;
+			ke[i3  ][j3+2] += (Gxi*DBL[0][2] + Gyi*DBL[3][2] + Gzi*DBL[5][2] )*detJt;
+
+			ke[i3+1][j3  ] += (Gyi*DBL[1][0] + Gxi*DBL[3][0] + Gzi*DBL[4][0] )*detJt;
+			ke[i3+1][j3+1] += (Gyi*DBL[1][1] + Gxi*DBL[3][1] + Gzi*DBL[4][1] )*detJt;
+			ke[i3+1][j3+2] += (Gyi*DBL[1][2] + Gxi*DBL[3][2] + Gzi*DBL[4][2] )*detJt;
+
+			ke[i3+2][j3  ] += (Gzi*DBL[2][0] + Gyi*DBL[4][0] + Gxi*DBL[5][0] )*detJt;
+			ke[i3+2][j3+1] += (Gzi*DBL[2][1] + Gyi*DBL[4][1] + Gxi*DBL[5][1] )*detJt;
+			ke[i3+2][j3+2] += (Gzi*DBL[2][2] + Gyi*DBL[4][2] + Gxi*DBL[5][2] )*detJt;
 		}
 	}
 }
 
+// Batched version of addMaterialStiffness, which processes the integration point n of 
+// STIFFNESS_BATCH elements at once. The data of the elements is interleaved, so that the
+// innermost loop over the elements of the batch can be vectorized:
+//   G : shape gradients, G[(3*i + k)*W + l] is component k of node i of element l
+//   D : tangents, D[(6*a + b)*W + l] is D[a][b] of element l
+//   w : Jacobian times integration weight of each element
+// The per element operations are the same as in addMaterialStiffness.
+template <int NELN> static void addMaterialStiffnessBatch(int neln, const double* G, const double* D, const double* w, double* Kb, bool upper)
+{
+	const int W = FEElasticSolidDomain::STIFFNESS_BATCH;
+	const int ne = (NELN > 0 ? NELN : neln);
+	const int ndof = 3 * ne;
+
+#define DL(a, b) D[(6*(a) + (b))*W + l]
+	for (int i = 0; i < ne; ++i)
+	{
+		const double* Gi = G + 3 * i*W;
+		for (int j = (upper ? i : 0); j < ne; ++j)
+		{
+			const double* Gj = G + 3 * j*W;
+			double* K0 = Kb + (3 * i*ndof + 3 * j)*W;
+			double* K1 = K0 + ndof*W;
+			double* K2 = K1 + ndof*W;
+
+#pragma omp simd
+			for (int l = 0; l < W; ++l)
+			{
+				const double Gxi = Gi[l], Gyi = Gi[W + l], Gzi = Gi[2 * W + l];
+				const double Gxj = Gj[l], Gyj = Gj[W + l], Gzj = Gj[2 * W + l];
+				const double detJt = w[l];
+
+				// calculate D*BL matrices
+				const double DBL00 = (DL(0,0)*Gxj + DL(0,3)*Gyj + DL(0,5)*Gzj);
+				const double DBL01 = (DL(0,1)*Gyj + DL(0,3)*Gxj + DL(0,4)*Gzj);
+				const double DBL02 = (DL(0,2)*Gzj + DL(0,4)*Gyj + DL(0,5)*Gxj);
+
+				const double DBL10 = (DL(1,0)*Gxj + DL(1,3)*Gyj + DL(1,5)*Gzj);
+				const double DBL11 = (DL(1,1)*Gyj + DL(1,3)*Gxj + DL(1,4)*Gzj);
+				const double DBL12 = (DL(1,2)*Gzj + DL(1,4)*Gyj + DL(1,5)*Gxj);
+
+				const double DBL20 = (DL(2,0)*Gxj + DL(2,3)*Gyj + DL(2,5)*Gzj);
+				const double DBL21 = (DL(2,1)*Gyj + DL(2,3)*Gxj + DL(2,4)*Gzj);
+				const double DBL22 = (DL(2,2)*Gzj + DL(2,4)*Gyj + DL(2,5)*Gxj);
+
+				const double DBL30 = (DL(3,0)*Gxj + DL(3,3)*Gyj + DL(3,5)*Gzj);
+				const double DBL31 = (DL(3,1)*Gyj + DL(3,3)*Gxj + DL(3,4)*Gzj);
+				const double DBL32 = (DL(3,2)*Gzj + DL(3,4)*Gyj + DL(3,5)*Gxj);
+
+				const double DBL40 = (DL(4,0)*Gxj + DL(4,3)*Gyj + DL(4,5)*Gzj);
+				const double DBL41 = (DL(4,1)*Gyj + DL(4,3)*Gxj + DL(4,4)*Gzj);
+				const double DBL42 = (DL(4,2)*Gzj + DL(4,4)*Gyj + DL(4,5)*Gxj);
+
+				const double DBL50 = (DL(5,0)*Gxj + DL(5,3)*Gyj + DL(5,5)*Gzj);
+				const double DBL51 = (DL(5,1)*Gyj + DL(5,3)*Gxj + DL(5,4)*Gzj);
+				const double DBL52 = (DL(5,2)*Gzj + DL(5,4)*Gyj + DL(5,5)*Gxj);
+
+				K0[l        ] += (Gxi*DBL00 + Gyi*DBL30 + Gzi*DBL50)*detJt;
+				K0[l +     W] += (Gxi*DBL01 + Gyi*DBL31 + Gzi*DBL51)*detJt;
+				K0[l + 2 * W] += (Gxi*DBL02 + Gyi*DBL32 + Gzi*DBL52)*detJt;
+
+				K1[l        ] += (Gyi*DBL10 + Gxi*DBL30 + Gzi*DBL40)*detJt;
+				K1[l +     W] += (Gyi*DBL11 + Gxi*DBL31 + Gzi*DBL41)*detJt;
+				K1[l + 2 * W] += (Gyi*DBL12 + Gxi*DBL32 + Gzi*DBL42)*detJt;
+
+				K2[l        ] += (Gzi*DBL20 + Gyi*DBL40 + Gxi*DBL50)*detJt;
+				K2[l +     W] += (Gzi*DBL21 + Gyi*DBL41 + Gxi*DBL51)*detJt;
+				K2[l + 2 * W] += (Gzi*DBL22 + Gyi*DBL42 + Gxi*DBL52)*detJt;
+			}
+		}
+	}
+#undef DL
+}
+
 //-----------------------------------------------------------------------------
 //! calculates the internal equivalent nodal forces for solid elements
 
@@ -222,66 +507,29 @@ void FEElasticSolidDomain::ElementInternalForce(FESolidElement& el, vector<doubl
 		const double* Gs = el.Gs(n);
 		const double* Gt = el.Gt(n);
 
-		for (int i=0; i<neln; ++i)
-		{
-			// calculate global gradient of shape functions
-			// note that we need the transposed of Ji, not Ji itself !
-			double Gx = Ji[0][0]*Gr[i]+Ji[1][0]*Gs[i]+Ji[2][0]*Gt[i];
-			double Gy = Ji[0][1]*Gr[i]+Ji[1][1]*Gs[i]+Ji[2][1]*Gt[i];
-			double Gz = Ji[0][2]*Gr[i]+Ji[1][2]*Gs[i]+Ji[2][2]*Gt[i];
-
-			// calculate internal force
-			// the '-' sign is so that the internal forces get subtracted
-			// from the global residual vector
-			fe[3*i  ] -= ( Gx*s.xx() +
-				           Gy*s.xy() +
-					       Gz*s.xz() )*detJt;
-
-			fe[3*i+1] -= ( Gy*s.yy() +
-				           Gx*s.xy() +
-					       Gz*s.yz() )*detJt;
-
-			fe[3*i+2] -= ( Gz*s.zz() +
-				           Gy*s.yz() +
-					       Gx*s.xz() )*detJt;
-		}
+		FE_SOLID_KERNEL_DISPATCH(ElementKernel(), addInternalForce, (neln, Ji, Gr, Gs, Gt, s, detJt, &fe[0]));
 	}
 }
 
 //-----------------------------------------------------------------------------
 void FEElasticSolidDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 {
-	// define some parameters that will be passed to lambda
-	FEBodyForce* bodyForce = &BF;
-
 	// TODO: a remaining issue here is that dofU does not consider the shell displacement
 	// dofs for interface nodes (see UnpackLM). Is that an issue?
 
 	// evaluate the residual contribution
-	LoadVector(R, m_dofU, [=](FEMaterialPoint& mp, int node_a, std::vector<double>& fa) {
-
-		// evaluate density
-		double density = m_pMat->Density(mp);
-
-		// get the force
-		vec3d f = bodyForce->force(mp);
-
-		// get element shape functions
-		double* H = mp.m_shape;
-
-		// get the initial Jacobian
-		double J0 = mp.m_J0;
-
-		// set integrand
-		fa[0] = -H[node_a] * density* f.x * J0;
-		fa[1] = -H[node_a] * density* f.y * J0;
-		fa[2] = -H[node_a] * density* f.z * J0;
-	});
+	LoadVector(R, m_dofU, bodyForceIntegrand(m_pMat, &BF));
 }
 
 //-----------------------------------------------------------------------------
 //! calculates element's geometrical stiffness component for integration point n
 void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matrix &ke)
+{
+	ElementGeometricalStiffness(el, ke, false);
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matrix &ke, bool upper)
 {
 	// spatial derivatives of shape functions
 	vec3d G[FEElement::MAX_NODES];
@@ -304,15 +552,7 @@ void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matri
 		// element's Cauchy-stress tensor at gauss point n
 		mat3ds& s = pt.m_s;
 
-		for (int i = 0; i<neln; ++i)
-			for (int j = 0; j<neln; ++j)
-			{
-				double kab = (G[i]*(s * G[j]))*w;
-
-				ke[3*i  ][3*j  ] += kab;
-				ke[3*i+1][3*j+1] += kab;
-				ke[3*i+2][3*j+2] += kab;
-			}
+		FE_SOLID_KERNEL_DISPATCH(ElementKernel(), addGeometricalStiffness, (neln, G, s, w, ke, upper));
 	}
 }
 
@@ -320,6 +560,12 @@ void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matri
 //! Calculates element material stiffness element matrix
 
 void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &ke)
+{
+	ElementMaterialStiffness(el, ke, false);
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &ke, bool upper)
 {
 	// Get the current element's data
 	const int nint = el.GaussPoints();
@@ -328,15 +574,9 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 	// global derivatives of shape functions
 	vec3d G[FEElement::MAX_NODES];
 
-	double Gxi, Gyi, Gzi;
-	double Gxj, Gyj, Gzj;
-
 	// The 'D' matrix
 	double D[6][6] = {0};	// The 'D' matrix
 
-	// The 'D*BL' matrix
-	double DBL[6][3];
-
 	// jacobian
 	double detJt;
 	
@@ -358,103 +598,272 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
         tens4dmm C = (m_secant_tangent ? m_pMat->SecantTangent(mp) : m_pMat->SolidTangent(mp));
 		C.extract(D);
 
-		// we only calculate the upper triangular part
-		// since ke is symmetric. The other part is
-		// determined below using this symmetry.
-		for (int i=0, i3=0; i<neln; ++i, i3 += 3)
+		// add B^T*D*B to the element stiffness
+		FE_SOLID_KERNEL_DISPATCH(ElementKernel(), addMaterialStiffness, (neln, G, D, detJt, ke, upper));
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticSolidDomain::ElementMaterialStiffnessBatch(const int* elemList, int nel, double* Kb, bool upper)
+{
+	const int W = STIFFNESS_BATCH;
+	assert((nel > 0) && (nel <= W));
+
+	// all elements of the batch are of the same type
+	FESolidElement& el0 = m_Elem[elemList[0]];
+	const int nint = el0.GaussPoints();
+	const int neln = el0.Nodes();
+
+	// interleaved shape gradients, tangents and weights (see addMaterialStiffnessBatch).
+	// The lanes of missing elements are zero.
+	double G[3 * FEElement::MAX_NODES * W] = { 0 };
+	double D[36 * W] = { 0 };
+	double w[W] = { 0 };
+
+	vec3d Gl[FEElement::MAX_NODES];
+	for (int n = 0; n < nint; ++n)
+	{
+		for (int l = 0; l < nel; ++l)
 		{
-			Gxi = G[i].x;
-			Gyi = G[i].y;
-			Gzi = G[i].z;
+			FESolidElement& el = m_Elem[elemList[l]];
+			assert(el.Type() == el0.Type());
 
-			for (int j=0, j3 = 0; j<neln; ++j, j3 += 3)
+			// calculate jacobian and shape function gradients
+			w[l] = ShapeGradient(el, n, Gl, m_alphaf)*el.GaussWeights()[n]*m_alphaf;
+			for (int i = 0; i < neln; ++i)
 			{
-				Gxj = G[j].x;
-				Gyj = G[j].y;
-				Gzj = G[j].z;
+				G[(3 * i    )*W + l] = Gl[i].x;
+				G[(3 * i + 1)*W + l] = Gl[i].y;
+				G[(3 * i + 2)*W + l] = Gl[i].z;
+			}
 
-				// calculate D*BL matrices
-				DBL[0][0] = (D[0][0]*Gxj+D[0][3]*Gyj+D[0][5]*Gzj);
-				DBL[0][1] = (D[0][1]*Gyj+D[0][3]*Gxj+D[0][4]*Gzj);
-				DBL[0][2] = (D[0][2]*Gzj+D[0][4]*Gyj+D[0][5]*Gxj);
+			// get the 'D' matrix
+			FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+			tens4dmm C = (m_secant_tangent ? m_pMat->SecantTangent(mp) : m_pMat->SolidTangent(mp));
+			double d[6][6];
+			C.extract(d);
+			for (int a = 0; a < 6; ++a)
+				for (int b = 0; b < 6; ++b) D[(6 * a + b)*W + l] = d[a][b];
+		}
 
-				DBL[1][0] = (D[1][0]*Gxj+D[1][3]*Gyj+D[1][5]*Gzj);
-				DBL[1][1] = (D[1][1]*Gyj+D[1][3]*Gxj+D[1][4]*Gzj);
-				DBL[1][2] = (D[1][2]*Gzj+D[1][4]*Gyj+D[1][5]*Gxj);
+		// add B^T*D*B to the element stiffnesses
+		FE_SOLID_KERNEL_DISPATCH(ElementKernel(), addMaterialStiffnessBatch, (neln, G, D, w, Kb, upper));
+	}
+}
 
-				DBL[2][0] = (D[2][0]*Gxj+D[2][3]*Gyj+D[2][5]*Gzj);
-				DBL[2][1] = (D[2][1]*Gyj+D[2][3]*Gxj+D[2][4]*Gzj);
-				DBL[2][2] = (D[2][2]*Gzj+D[2][4]*Gyj+D[2][5]*Gxj);
+//-----------------------------------------------------------------------------
+void FEElasticSolidDomain::ElementTangents(FESolidElement& el, double* D)
+{
+	const int nint = el.GaussPoints();
+	for (int n = 0; n < nint; ++n, D += TANGENT_SIZE)
+	{
+		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+		tens4dmm C = (m_secant_tangent ? m_pMat->SecantTangent(mp) : m_pMat->SolidTangent(mp));
 
-				DBL[3][0] = (D[3][0]*Gxj+D[3][3]*Gyj+D[3][5]*Gzj);
-				DBL[3][1] = (D[3][1]*Gyj+D[3][3]*Gxj+D[3][4]*Gzj);
-				DBL[3][2] = (D[3][2]*Gzj+D[3][4]*Gyj+D[3][5]*Gxj);
+		double d[6][6];
+		C.extract(d);
+		int m = 0;
+		for (int i = 0; i < 6; ++i)
+			for (int j = i; j < 6; ++j) D[m++] = d[i][j];
 
-				DBL[4][0] = (D[4][0]*Gxj+D[4][3]*Gyj+D[4][5]*Gzj);
-				DBL[4][1] = (D[4][1]*Gyj+D[4][3]*Gxj+D[4][4]*Gzj);
-				DBL[4][2] = (D[4][2]*Gzj+D[4][4]*Gyj+D[4][5]*Gxj);
+		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		const mat3ds& s = pt.m_s;
+		D[21] = s.xx(); D[22] = s.yy(); D[23] = s.zz();
+		D[24] = s.xy(); D[25] = s.yz(); D[26] = s.xz();
+	}
+}
 
-				DBL[5][0] = (D[5][0]*Gxj+D[5][3]*Gyj+D[5][5]*Gzj);
-				DBL[5][1] = (D[5][1]*Gyj+D[5][3]*Gxj+D[5][4]*Gzj);
-				DBL[5][2] = (D[5][2]*Gzj+D[5][4]*Gyj+D[5][5]*Gxj);
+//-----------------------------------------------------------------------------
+// Adds the product of the material and geometrical stiffness of an integration point with ue
+// to fe (see ElementStiffnessProduct). D contains the tangent and stress of the point.
+template <int NELN> static void addStiffnessProduct(int neln, const vec3d* G, const double* D, double detJt, const double* ue, double* fe)
+{
+	const int ne = (NELN > 0 ? NELN : neln);
 
-				ke[i3  ][j3  ] += (Gxi*DBL[0][0] + Gyi*DBL[3][0] + Gzi*DBL[5][0] )*detJt;
-				ke[i3  ][j3+1] += (Gxi*DBL[0][1] + Gyi*DBL[3][1] + Gzi*DBL[5][1] )*detJt;
-				ke[i3  ][j3+2] += (Gxi*DBL[0][2] + Gyi*DBL[3][2] + Gzi*DBL[5][2] )*detJt;
+	// gradient of ue: L[k] = sum_j G[j]*ue[j][k]
+	vec3d L[3];
+	for (int j = 0; j < ne; ++j)
+	{
+		const double* uj = ue + 3 * j;
+		L[0] += G[j] * uj[0];
+		L[1] += G[j] * uj[1];
+		L[2] += G[j] * uj[2];
+	}
 
-				ke[i3+1][j3  ] += (Gyi*DBL[1][0] + Gxi*DBL[3][0] + Gzi*DBL[4][0] )*detJt;
-				ke[i3+1][j3+1] += (Gyi*DBL[1][1] + Gxi*DBL[3][1] + Gzi*DBL[4][1] )*detJt;
-				ke[i3+1][j3+2] += (Gyi*DBL[1][2] + Gxi*DBL[3][2] + Gzi*DBL[4][2] )*detJt;
+	// the (engineering) strain in Voigt order xx, yy, zz, xy, yz, xz
+	double e[6];
+	e[0] = L[0].x;
+	e[1] = L[1].y;
+	e[2] = L[2].z;
+	e[3] = L[0].y + L[1].x;
+	e[4] = L[1].z + L[2].y;
+	e[5] = L[0].z + L[2].x;
+
+	// s = D*e, with D stored as its upper triangle
+	double s[6];
+	s[0] = (D[ 0]*e[0] + D[ 1]*e[1] + D[ 2]*e[2] + D[ 3]*e[3] + D[ 4]*e[4] + D[ 5]*e[5])*detJt;
+	s[1] = (D[ 1]*e[0] + D[ 6]*e[1] + D[ 7]*e[2] + D[ 8]*e[3] + D[ 9]*e[4] + D[10]*e[5])*detJt;
+	s[2] = (D[ 2]*e[0] + D[ 7]*e[1] + D[11]*e[2] + D[12]*e[3] + D[13]*e[4] + D[14]*e[5])*detJt;
+	s[3] = (D[ 3]*e[0] + D[ 8]*e[1] + D[12]*e[2] + D[15]*e[3] + D[16]*e[4] + D[17]*e[5])*detJt;
+	s[4] = (D[ 4]*e[0] + D[ 9]*e[1] + D[13]*e[2] + D[16]*e[3] + D[18]*e[4] + D[19]*e[5])*detJt;
+	s[5] = (D[ 5]*e[0] + D[10]*e[1] + D[14]*e[2] + D[17]*e[3] + D[19]*e[4] + D[20]*e[5])*detJt;
+
+	// initial stress term
+	mat3ds sig(D[21], D[22], D[23], D[24], D[25], D[26]);
+	vec3d SL[3];
+	for (int k = 0; k < 3; ++k) SL[k] = (sig * L[k])*detJt;
+
+	for (int i = 0; i < ne; ++i)
+	{
+		const vec3d& Gi = G[i];
+		double* fi = fe + 3 * i;
+		fi[0] += Gi.x*s[0] + Gi.y*s[3] + Gi.z*s[5] + Gi*SL[0];
+		fi[1] += Gi.y*s[1] + Gi.x*s[3] + Gi.z*s[4] + Gi*SL[1];
+		fi[2] += Gi.z*s[2] + Gi.y*s[4] + Gi.x*s[5] + Gi*SL[2];
+	}
+}
 
-				ke[i3+2][j3  ] += (Gzi*DBL[2][0] + Gyi*DBL[4][0] + Gxi*DBL[5][0] )*detJt;
-				ke[i3+2][j3+1] += (Gzi*DBL[2][1] + Gyi*DBL[4][1] + Gxi*DBL[5][1] )*detJt;
-				ke[i3+2][j3+2] += (Gzi*DBL[2][2] + Gyi*DBL[4][2] + Gxi*DBL[5][2] )*detJt;
-			}
-		}
+//-----------------------------------------------------------------------------
+//! This calculates the same product as assembling the material and geometrical
+//! stiffness (see ElementMaterialStiffness and ElementGeometricalStiffness) and
+//! multiplying with ue. Instead of forming the element matrix, it calculates the 
+//! (linearized) strain of ue at each integration point, and integrates B^T*(D*e) + 
+//! the initial stress term.
+void FEElasticSolidDomain::ElementStiffnessProduct(FESolidElement& el, const double* D, const double* ue, double* fe)
+{
+	const int nint = el.GaussPoints();
+	const int neln = el.Nodes();
+	const double* gw = el.GaussWeights();
+
+	// the nodal coordinates are the same for all integration points
+	vec3d rt[FEElement::MAX_NODES];
+	GetCurrentNodalCoordinates(el, rt, m_alphaf);
+
+	vec3d G[FEElement::MAX_NODES];
+
+	for (int i = 0; i < 3 * neln; ++i) fe[i] = 0.0;
+
+	for (int n = 0; n < nint; ++n, D += TANGENT_SIZE)
+	{
+		double Ji[3][3];
+		double detJt = invjact(el, Ji, n, rt)*gw[n] * m_alphaf;
+		FE_SOLID_KERNEL_DISPATCH(ElementKernel(), FESolidElementKernel, ::gradient(neln, Ji, el.Gr(n), el.Gs(n), el.Gt(n), G));
+
+		FE_SOLID_KERNEL_DISPATCH(ElementKernel(), addStiffnessProduct, (neln, G, D, detJt, ue, fe));
 	}
 }
 
 //-----------------------------------------------------------------------------
 void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 {
+	// For symmetric systems, we only need the upper triangle of the element matrices. 
+	// This requires that the element loops are not overridden by a derived class.
+	bool upper = hasStandardElementLoops(*this) && LS.UpperTriangularAssembly();
+
+	if (BatchStiffness())
+	{
+		ParallelAssembleBlocks(LS, STIFFNESS_BATCH, [&](const int* elemList, int n) {
+			AssembleBatchStiffness(LS, elemList, n, upper);
+		});
+		return;
+	}
+
 	// repeat over all solid elements
-	int NE = Elements();
-	
-	#pragma omp parallel for shared (NE)
-	for (int iel=0; iel<NE; ++iel)
+	ParallelAssemble(LS, [&](int iel) {
+		AssembleElementStiffness(LS, iel, upper);
+	});
+}
+
+//-----------------------------------------------------------------------------
+// This calculates the same element matrices as AssembleElementStiffness, with the
+// material stiffness evaluated by the batched kernel. 
+void FEElasticSolidDomain::AssembleBatchStiffness(FELinearSystem& LS, const int* elemList, int nel, bool upper)
+{
+	const int W = STIFFNESS_BATCH;
+
+	// only active elements are processed
+	int batch[W];
+	int nb = 0;
+	for (int l = 0; l < nel; ++l)
 	{
-		FESolidElement& el = m_Elem[iel];
+		if (m_Elem[elemList[l]].isActive()) batch[nb++] = elemList[l];
+	}
+	if (nb == 0) return;
 
-		if (el.isActive()) {
+	FEElementScratch& scratch = FEElementScratch::Get();
+	vector<int>& lm = scratch.LM();
 
-			// get the element's LM vector
-			vector<int> lm;
-			UnpackLM(el, lm);
+	const int ndof = 3 * m_Elem[batch[0]].Nodes();
+	const int nn = ndof*ndof;
+	double* Kb = scratch.Buffer(nn*W);
 
-			// element stiffness matrix
-			FEElementMatrix ke(el, lm);
+	// start with the geometrical stiffness so that the material stiffness is added
+	// in the same order as in AssembleElementStiffness
+	for (int l = 0; l < W; ++l)
+	{
+		if (l < nb)
+		{
+			FESolidElement& el = m_Elem[batch[l]];
+			FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
+			ElementGeometricalStiffness(el, ke, upper);
 
-			// create the element's stiffness matrix
-			int ndof = 3 * el.Nodes();
-			ke.resize(ndof, ndof);
-			ke.zero();
+			const double* pk = ke[0];
+			for (int k = 0; k < nn; ++k) Kb[k*W + l] = pk[k];
+		}
+		else for (int k = 0; k < nn; ++k) Kb[k*W + l] = 0.0;
+	}
+
+	// calculate material stiffness
+	ElementMaterialStiffnessBatch(batch, nb, Kb, upper);
+
+	// assemble element matrices in global stiffness matrix
+	for (int l = 0; l < nb; ++l)
+	{
+		FESolidElement& el = m_Elem[batch[l]];
+		UnpackLM(el, lm);
 
+		FEElementMatrix& ke = scratch.Matrix(el, lm, ndof, ndof);
+		double* pk = ke[0];
+		for (int k = 0; k < nn; ++k) pk[k] = Kb[k*W + l];
+		ke.SetUpperTriangular(upper);
+
+		LS.Assemble(ke);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticSolidDomain::AssembleElementStiffness(FELinearSystem& LS, int iel, bool upper)
+{
+	FESolidElement& el = m_Elem[iel];
+
+	if (el.isActive()) {
+
+		// get the element's LM vector
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<int>& lm = scratch.LM();
+		UnpackLM(el, lm);
+
+		// create the element's stiffness matrix
+		int ndof = 3 * el.Nodes();
+		FEElementMatrix& ke = scratch.Matrix(el, lm, ndof, ndof);
+
+		if (upper)
+		{
+			ElementGeometricalStiffness(el, ke, true);
+			ElementMaterialStiffness(el, ke, true);
+			ke.SetUpperTriangular(true);
+		}
+		else
+		{
 			// calculate geometrical stiffness
 			ElementGeometricalStiffness(el, ke);
 
 			// calculate material stiffness
 			ElementMaterialStiffness(el, ke);
-
-/*			// assign symmetic parts
-			// TODO: Can this be omitted by changing the Assemble routine so that it only
-			// grabs elements from the upper diagonal matrix?
-			for (int i = 0; i < ndof; ++i)
-				for (int j = i + 1; j < ndof; ++j)
-					ke[j][i] = ke[i][j];
-*/
-			// assemble element matrix in global stiffness matrix
-			LS.Assemble(ke);
 		}
+
+		// assemble element matrix in global stiffness matrix
+		LS.Assemble(ke);
 	}
 }
 
@@ -533,8 +942,8 @@ void FEElasticSolidDomain::ElementStiffness(const FETimeInfo& tp, int iel, matri
 	ElementGeometricalStiffness(el, ke);
 
 	// assign symmetic parts
-	// TODO: Can this be omitted by changing the Assemble routine so that it only
-	// grabs elements from the upper diagonal matrix?
+	// (callers of this function expect the full matrix. The domain's own assembly
+	// uses AssembleElementStiffness, which can skip this step.)
 	int ndof = 3*el.Nodes();
 	int i, j;
 	for (i=0; i<ndof; ++i)
@@ -718,13 +1127,13 @@ void FEElasticSolidDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 		FESolidElement& el = m_Elem[i];
 
 		if (el.isActive()) {
-			// element force vector
-			vector<double> fe;
-			vector<int> lm;
+			// scratch buffers for the element force vector and LM vector
+			FEElementScratch& scratch = FEElementScratch::Get();
+			vector<int>& lm = scratch.LM();
 
 			// get the element force vector and initialize it to zero
 			int ndof = 3 * el.Nodes();
-			fe.assign(ndof, 0);
+			vector<double>& fe = scratch.Vector(ndof);
 
 			// calculate internal force vector
 			ElementInertialForce(el, fe);
@@ -770,6 +1179,7 @@ void FEElasticSolidDomain::ElementInertialForce(FESolidElement& el, vector<doubl
 
 BEGIN_FECORE_CLASS(FEStandardElasticSolidDomain, FEElasticSolidDomain)
 	ADD_PARAMETER(m_elemType, "elem_type", FE_PARAM_ATTRIBUTE, "$(solid_element)\0");
+	ADD_PARAMETER(m_batchStiffness, "batch_stiffness");
 END_FECORE_CLASS();
 
 FEStandardElasticSolidDomain::FEStandardElasticSolidDomain(FEModel* fem) : FEElasticSolidDomain(fem)
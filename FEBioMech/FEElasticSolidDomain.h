@@ -37,6 +37,13 @@ SOFTWARE.*/
 //!
 class FEBIOMECH_API FEElasticSolidDomain : public FESolidDomain, public FEElasticDomain
 {
+public:
+	//! number of elements that are processed together by the batched stiffness kernel
+	enum { STIFFNESS_BATCH = 4 };
+
+	//! number of values that ElementTangents stores per integration point
+	enum { TANGENT_SIZE = 27 };
+
 public:
 	//! constructor
 	FEElasticSolidDomain(FEModel* pfem);
@@ -96,6 +103,15 @@ public: // overrides from FEElasticDomain
 	//! body force stiffness
 	void BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf) override;
 
+	//! add the internal forces to a task list
+	bool InternalForcesTasks(FEGlobalVector& R, FETaskList& tasks) override;
+
+	//! add the stiffness matrix to a task list
+	bool StiffnessMatrixTasks(FELinearSystem& LS, FETaskList& tasks) override;
+
+	//! add the body force vector to a task list
+	bool BodyForceTasks(FEGlobalVector& R, FEBodyForce& bf, FETaskList& tasks) override;
+
 public:
 	// --- S T I F F N E S S ---
 
@@ -108,11 +124,48 @@ public:
 	//! material stiffness component
 	virtual void ElementMaterialStiffness(FESolidElement& el, matrix& ke);
 
+	//! Geometrical and material stiffness. When upper is true, only the upper triangle 
+	//! of the (symmetric) element matrix is evaluated.
+	void ElementGeometricalStiffness(FESolidElement& el, matrix& ke, bool upper);
+	void ElementMaterialStiffness(FESolidElement& el, matrix& ke, bool upper);
+
+	//! Material stiffness of a batch of (at most STIFFNESS_BATCH) elements of the same type. 
+	//! The element matrices are stored interleaved: entry (i,j) of element l of the batch is
+	//! Kb[(i*ndof + j)*STIFFNESS_BATCH + l]. The stiffness is added to Kb. When upper is true,
+	//! only the upper triangle of the (symmetric) element matrices is evaluated.
+	void ElementMaterialStiffnessBatch(const int* elemList, int nel, double* Kb, bool upper = false);
+
+	//! see if the stiffness matrix is calculated with the batched kernel
+	bool BatchStiffness() const;
+
+	// --- M A T R I X - F R E E ---
+
+	//! Evaluates the material tangent and the Cauchy stress (xx,yy,zz,xy,yz,xz) at the element's
+	//! integration points. The tangent is assumed symmetric and only its upper triangle (21 values,
+	//! row-wise) is stored. D must have room for TANGENT_SIZE*GaussPoints() values.
+	void ElementTangents(FESolidElement& el, double* D);
+
+	//! Calculates fe = ke*ue, where ke is the element stiffness matrix, without forming ke.
+	//! The material tangents and stresses D must have been evaluated with ElementTangents.
+	//! ue and fe store the displacement dofs of the element (3 per node).
+	void ElementStiffnessProduct(FESolidElement& el, const double* D, const double* ue, double* fe);
+
 	// --- R E S I D U A L ---
 
 	//! Calculates the internal stress vector for solid elements
 	void ElementInternalForce(FESolidElement& el, vector<double>& fe);
 
+	//! Calculates the internal stress vector of an element and assembles it into R
+	void AssembleElementInternalForce(FEGlobalVector& R, int iel);
+
+	//! Calculates the stiffness matrix of an element and assembles it into LS.
+	//! When upper is true, only the upper triangle of the element matrix is evaluated.
+	void AssembleElementStiffness(FELinearSystem& LS, int iel, bool upper);
+
+	//! Calculates the stiffness matrices of a batch of (at most STIFFNESS_BATCH) elements 
+	//! and assembles them into LS
+	void AssembleBatchStiffness(FELinearSystem& LS, const int* elemList, int nel, bool upper);
+
     //! Calculates the inertial force vector for solid elements
     void ElementInertialForce(FESolidElement& el, vector<double>& fe);
     
@@ -125,6 +178,8 @@ protected:
 	bool	m_secant_stress;	//!< use secant approximation to stress
 	bool	m_secant_tangent;   //!< flag for using secant tangent
 
+	bool	m_batchStiffness;	//!< use the batched material stiffness kernel
+
 protected:
 	FEDofList	m_dofU;		// displacement dofs
 	FEDofList	m_dofR;		// rigid rotation rofs
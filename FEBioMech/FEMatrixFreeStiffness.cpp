@@ -0,0 +1,291 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEMatrixFreeStiffness.h"
+#include "FEElasticSolidDomain.h"
+#include "FEMechModel.h"
+#include "FESolidAnalysis.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FENodalLoad.h>
+#include <FECore/FELinearConstraintManager.h>
+#include <FECore/FEElementScratch.h>
+#include <FECore/log.h>
+#include <typeinfo>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+FEMatrixFreeStiffness::FEMatrixFreeStiffness(FEModel* fem) : m_fem(fem)
+{
+	m_bupdate = true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEMatrixFreeStiffness::Init()
+{
+	FEModel& fem = *m_fem;
+	FEMesh& mesh = fem.GetMesh();
+
+	m_dom.clear();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		// The element product is only implemented for the standard elastic solid domain,
+		// so we don't accept derived classes, since they calculate the stiffness differently.
+		FEDomain& dom = mesh.Domain(i);
+		if ((typeid(dom) != typeid(FEElasticSolidDomain)) && (typeid(dom) != typeid(FEStandardElasticSolidDomain)))
+		{
+			feLogError("The matrix-free stiffness only supports elastic solid domains.");
+			return false;
+		}
+		m_dom.push_back(dynamic_cast<FEElasticSolidDomain*>(&dom));
+	}
+
+	FEAnalysis* step = fem.GetCurrentStep();
+	if (step && (step->m_nanalysis != FESolidAnalysis::STATIC))
+	{
+		feLogError("The matrix-free stiffness only supports static analyses.");
+		return false;
+	}
+
+	FEMechModel* mech = dynamic_cast<FEMechModel*>(&fem);
+	if ((mech && (mech->RigidBodies() > 0)) ||
+		(fem.SurfacePairConstraints() > 0) ||
+		(fem.NonlinearConstraints() > 0) ||
+		(fem.GetLinearConstraintManager().LinearConstraints() > 0))
+	{
+		feLogError("The matrix-free stiffness does not support rigid bodies, contact or constraints.");
+		return false;
+	}
+
+	// nodal loads do not contribute to the stiffness, but other loads might
+	for (int i = 0; i < fem.ModelLoads(); ++i)
+	{
+		if (dynamic_cast<FENodalLoad*>(fem.ModelLoad(i)) == nullptr)
+		{
+			feLogError("The matrix-free stiffness only supports nodal loads.");
+			return false;
+		}
+	}
+
+	m_bupdate = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEMatrixFreeStiffness::Create(SparseMatrixProfile& MP)
+{
+	m_nrow = MP.Rows();
+	m_ncol = MP.Columns();
+	m_nsize = 0;
+	m_diag.assign(m_nrow, 0.0);
+	m_fixed.assign(m_nrow, 0);
+	m_bupdate = true;
+}
+
+//-----------------------------------------------------------------------------
+void FEMatrixFreeStiffness::Zero()
+{
+	std::fill(m_diag.begin(), m_diag.end(), 0.0);
+	std::fill(m_fixed.begin(), m_fixed.end(), 0);
+	m_bupdate = true;
+}
+
+//-----------------------------------------------------------------------------
+void FEMatrixFreeStiffness::Clear()
+{
+	m_D.clear();
+	m_off.clear();
+	m_LM.clear();
+	m_lmoff.clear();
+	m_diag.clear();
+	m_fixed.clear();
+	m_bupdate = true;
+	SparseMatrix::Clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEMatrixFreeStiffness::Assemble(const matrix& ke, const std::vector<int>& lm)
+{
+	const int N = ke.rows();
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lm[i];
+		if (I >= 0) add(I, I, ke[i][i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEMatrixFreeStiffness::Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+		for (int j = 0; j < M; ++j)
+		{
+			if (lmj[j] == I) add(I, I, ke[i][j]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEMatrixFreeStiffness::set(int i, int j, double v)
+{
+	if (i != j) return;
+#pragma omp critical
+	{
+		m_diag[i] = v;
+		m_fixed[i] = 1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEMatrixFreeStiffness::add(int i, int j, double v)
+{
+	if (i != j) return;
+	if (m_batomic)
+	{
+#pragma omp atomic
+		m_diag[i] += v;
+	}
+	else m_diag[i] += v;
+}
+
+//-----------------------------------------------------------------------------
+double FEMatrixFreeStiffness::get(int i, int j)
+{
+	return (i == j ? m_diag[i] : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+double FEMatrixFreeStiffness::diag(int i)
+{
+	return m_diag[i];
+}
+
+//-----------------------------------------------------------------------------
+void FEMatrixFreeStiffness::UpdateTangents()
+{
+	const int ND = (int)m_dom.size();
+	m_D.resize(ND);
+	m_off.resize(ND);
+	m_LM.resize(ND);
+	m_lmoff.resize(ND);
+	for (int nd = 0; nd < ND; ++nd)
+	{
+		FEElasticSolidDomain& dom = *m_dom[nd];
+		const int NE = dom.Elements();
+
+		vector<int>& off = m_off[nd];
+		vector<int>& lmoff = m_lmoff[nd];
+		off.resize(NE + 1);
+		lmoff.resize(NE + 1);
+		off[0] = lmoff[0] = 0;
+		for (int i = 0; i < NE; ++i)
+		{
+			FESolidElement& el = dom.Element(i);
+			off[i + 1] = off[i] + FEElasticSolidDomain::TANGENT_SIZE * el.GaussPoints();
+			lmoff[i + 1] = lmoff[i] + 3 * el.Nodes();
+		}
+
+		vector<double>& D = m_D[nd];
+		vector<int>& LM = m_LM[nd];
+		D.resize(off[NE]);
+		LM.resize(lmoff[NE]);
+
+#pragma omp parallel for schedule(dynamic, 64)
+		for (int i = 0; i < NE; ++i)
+		{
+			FESolidElement& el = dom.Element(i);
+			if (el.isActive() == false) continue;
+
+			dom.ElementTangents(el, &D[off[i]]);
+
+			// we only need the displacement dofs, which are stored first
+			vector<int>& lm = FEElementScratch::Get().LM();
+			dom.UnpackLM(el, lm);
+			for (int j = 0; j < 3 * el.Nodes(); ++j) LM[lmoff[i] + j] = lm[j];
+		}
+	}
+	m_bupdate = false;
+}
+
+//-----------------------------------------------------------------------------
+bool FEMatrixFreeStiffness::mult_vector(double* x, double* r)
+{
+	if (m_bupdate) UpdateTangents();
+
+	// rows of prescribed dofs only have a diagonal
+	const int neq = m_nrow;
+#pragma omp parallel for
+	for (int i = 0; i < neq; ++i) r[i] = (m_fixed[i] ? m_diag[i] * x[i] : 0.0);
+
+	for (int nd = 0; nd < (int)m_dom.size(); ++nd)
+	{
+		FEElasticSolidDomain& dom = *m_dom[nd];
+		const vector<double>& D = m_D[nd];
+		const vector<int>& off = m_off[nd];
+		const vector<int>& LM = m_LM[nd];
+		const vector<int>& lmoff = m_lmoff[nd];
+		const int NE = dom.Elements();
+
+#pragma omp parallel for schedule(dynamic, 64)
+		for (int i = 0; i < NE; ++i)
+		{
+			FESolidElement& el = dom.Element(i);
+			if (el.isActive() == false) continue;
+
+			const int* lm = &LM[lmoff[i]];
+
+			// gather the element's displacements
+			const int ndof = 3 * el.Nodes();
+			vector<double>& v = FEElementScratch::Get().Vector(2 * ndof);
+			double* ue = &v[0];
+			double* fe = ue + ndof;
+			for (int j = 0; j < ndof; ++j) ue[j] = (lm[j] >= 0 ? x[lm[j]] : 0.0);
+
+			dom.ElementStiffnessProduct(el, &D[off[i]], ue, fe);
+
+			// scatter
+			for (int j = 0; j < ndof; ++j)
+			{
+				int J = lm[j];
+				if (J >= 0)
+				{
+#pragma omp atomic
+					r[J] += fe[j];
+				}
+			}
+		}
+	}
+
+	return true;
+}
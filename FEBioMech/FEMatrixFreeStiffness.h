@@ -0,0 +1,110 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/SparseMatrix.h>
+#include "febiomech_api.h"
+
+class FEModel;
+class FEElasticSolidDomain;
+
+//-----------------------------------------------------------------------------
+//! This class implements the stiffness matrix of a solid mechanics problem as a
+//! matrix-free operator. The product K*x is calculated element-by-element, using
+//! the material tangents at the integration points, which are evaluated once after
+//! each stiffness reformation. The global matrix is never stored.
+//! The assembly functions only collect the diagonal of the matrix (e.g. for Jacobi
+//! preconditioning) and the rows of prescribed dofs. This means that this operator
+//! can only be used for models for which all the stiffness contributions come from
+//! the elastic solid domains (see Init).
+class FEBIOMECH_API FEMatrixFreeStiffness : public SparseMatrix
+{
+public:
+	FEMatrixFreeStiffness(FEModel* fem);
+
+	//! Checks if the model can be handled by this operator. 
+	bool Init();
+
+	//! get the model
+	FEModel* GetFEModel() { return m_fem; }
+
+	//! calculates r = K*x
+	bool mult_vector(double* x, double* r) override;
+
+	//! no profile needed
+	bool NeedsProfile() const override { return false; }
+
+public: // these functions only store the diagonal
+
+	//! zero the diagonal (also flags the tangents for updating)
+	void Zero() override;
+
+	//! allocate the diagonal
+	void Create(SparseMatrixProfile& MP) override;
+
+	//! assemble the diagonal of an element matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! assemble the diagonal of an element matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! all entries are considered allocated
+	bool check(int i, int j) override { return true; }
+
+	//! set a diagonal entry
+	void set(int i, int j, double v) override;
+
+	//! add to a diagonal entry
+	void add(int i, int j, double v) override;
+
+	//! get a diagonal entry
+	double get(int i, int j) override;
+
+	//! get the diagonal value
+	double diag(int i) override;
+
+	//! release memory
+	void Clear() override;
+
+protected:
+	//! evaluate the material tangents of all elements
+	void UpdateTangents();
+
+private:
+	FEModel*	m_fem;
+
+	std::vector<FEElasticSolidDomain*>	m_dom;	//!< the domains
+	std::vector< std::vector<double> >	m_D;	//!< material tangents and stresses of each domain
+	std::vector< std::vector<int> >		m_off;	//!< offset of each element into m_D
+	std::vector< std::vector<int> >		m_LM;	//!< equation numbers of the displacement dofs of each domain
+	std::vector< std::vector<int> >		m_lmoff;	//!< offset of each element into m_LM
+
+	std::vector<double>	m_diag;		//!< the diagonal
+	std::vector<char>	m_fixed;	//!< rows that were set explicitly (i.e. prescribed dofs)
+	bool				m_bupdate;	//!< tangents need to be updated
+};
@@ -0,0 +1,116 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEMatrixFreeStrategy.h"
+#include "FEMatrixFreeStiffness.h"
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEException.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/Preconditioner.h>
+#include <FECore/log.h>
+
+//-----------------------------------------------------------------------------
+FEMatrixFreeStrategy::FEMatrixFreeStrategy(FEModel* fem) : FENewtonStrategy(fem)
+{
+	m_A = nullptr;
+	m_plinsolve = nullptr;
+	m_maxups = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool FEMatrixFreeStrategy::Init()
+{
+	if (m_pns == nullptr) return false;
+	m_plinsolve = m_pns->GetLinearSolver();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* FEMatrixFreeStrategy::CreateSparseMatrix(Matrix_Type mtype)
+{
+	// NOTE: the previous operator is owned by the FEGlobalMatrix, which deletes it.
+	m_A = nullptr;
+
+	// the operator only stores the symmetric part of the material tangents
+	if (mtype != REAL_SYMMETRIC)
+	{
+		feLogError("The matrix-free strategy requires a symmetric stiffness matrix.");
+		return nullptr;
+	}
+
+	// make sure the linear solver is an iterative linear solver
+	IterativeLinearSolver* ls = dynamic_cast<IterativeLinearSolver*>(m_pns->m_plinsolve);
+	if (ls == nullptr)
+	{
+		feLogError("The matrix-free strategy requires an iterative linear solver.");
+		return nullptr;
+	}
+
+	// The operator only provides the diagonal of the matrix, so other preconditioners 
+	// cannot be built from it.
+	LinearSolver* PL = ls->GetLeftPreconditioner();
+	LinearSolver* PR = ls->GetRightPreconditioner();
+	if ((PL && (dynamic_cast<DiagonalPreconditioner*>(PL) == nullptr)) ||
+		(PR && (dynamic_cast<DiagonalPreconditioner*>(PR) == nullptr)))
+	{
+		feLogError("The matrix-free strategy only supports the diagonal preconditioner.");
+		return nullptr;
+	}
+
+	FEMatrixFreeStiffness* A = new FEMatrixFreeStiffness(GetFEModel());
+	if (A->Init() == false)
+	{
+		delete A;
+		return nullptr;
+	}
+	m_A = A;
+
+	// Let the linear solver and its (diagonal) preconditioners use the operator
+	ls->SetSparseMatrix(m_A);
+	if (PL) PL->SetSparseMatrix(m_A);
+	if (PR) PR->SetSparseMatrix(m_A);
+
+	return m_A;
+}
+
+//-----------------------------------------------------------------------------
+bool FEMatrixFreeStrategy::Update(double s, std::vector<double>& ui, std::vector<double>& R0, std::vector<double>& R1)
+{
+	// always return false to force a reformation
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+void FEMatrixFreeStrategy::SolveEquations(std::vector<double>& x, std::vector<double>& b)
+{
+	if (m_plinsolve->BackSolve(x, b) == false)
+	{
+		throw LinearSolverFailed();
+	}
+}
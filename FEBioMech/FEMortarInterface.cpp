@@ -31,6 +31,64 @@ SOFTWARE.*/
 #include "FECore/mortar.h"
 #include "FECore/log.h"
 #include <FECore/FEMesh.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+FEMortarWeights::FEMortarWeights()
+{
+	m_rows = m_cols = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FEMortarWeights::Create(int rows, int cols)
+{
+	m_rows = rows;
+	m_cols = cols;
+	m_ptr.assign(rows + 1, 0);
+	m_col.clear();
+	m_val.clear();
+	m_tmp.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEMortarWeights::Compress()
+{
+	// Sort the entries by row and column. The sort is stable, so duplicate
+	// entries are summed in the order in which they were added.
+	std::stable_sort(m_tmp.begin(), m_tmp.end(), [](const ENTRY& a, const ENTRY& b) {
+		return (a.row < b.row) || ((a.row == b.row) && (a.col < b.col));
+	});
+
+	m_col.clear();
+	m_val.clear();
+	m_ptr.assign(m_rows + 1, 0);
+	for (size_t n = 0; n < m_tmp.size(); ++n)
+	{
+		const ENTRY& e = m_tmp[n];
+		if ((n == 0) || (e.row != m_tmp[n - 1].row) || (e.col != m_tmp[n - 1].col))
+		{
+			m_col.push_back(e.col);
+			m_val.push_back(0.0);
+			m_ptr[e.row + 1]++;
+		}
+		m_val.back() += e.val;
+	}
+	for (int i = 0; i < m_rows; ++i) m_ptr[i + 1] += m_ptr[i];
+
+	// release the temporary storage
+	std::vector<ENTRY>().swap(m_tmp);
+}
+
+//-----------------------------------------------------------------------------
+double FEMortarWeights::operator () (int i, int j) const
+{
+	std::vector<int>::const_iterator it0 = m_col.begin() + m_ptr[i];
+	std::vector<int>::const_iterator it1 = m_col.begin() + m_ptr[i + 1];
+	std::vector<int>::const_iterator it = std::lower_bound(it0, it1, j);
+	if ((it != it1) && (*it == j)) return m_val[it - m_col.begin()];
+	return 0.0;
+}
 
 //-----------------------------------------------------------------------------
 FEMortarInterface::FEMortarInterface(FEModel* pfem) : FEContactInterface(pfem)
@@ -45,12 +103,8 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 	// allocate sturcture for the integration weights
 	int NS = ss.Nodes();
 	int NM = ms.Nodes();
-	m_n1.resize(NS,NS);
-	m_n2.resize(NS,NM);
-
-	// clear weights
-	m_n1.zero();
-	m_n2.zero();
+	m_n1.Create(NS,NS);
+	m_n2.Create(NS,NM);
 
 	// number of integration points
 	const int MAX_INT = 11;
@@ -134,7 +188,7 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 						n1 *= Area;
 
 						int b = se.m_lnode[B];
-						m_n1[a][b] += n1;
+						m_n1.Add(a, b, n1);
 					}
 
 					// loop over all the nodes on the secondary facet
@@ -148,23 +202,25 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 						n2 *= Area;
 
 						int c = me.m_lnode[C];
-						m_n2[a][c] += n2;
+						m_n2.Add(a, c, n2);
 					}
 				}
 			}		
 		}
 	}
 
+	// compress the weights
+	m_n1.Compress();
+	m_n2.Compress();
+
 #ifdef _DEBUG
 	// Sanity check: sum should add up to contact area
 	// This is for a hardcoded problem. Remove or generalize this!
 	double sum1 = 0.0;
-	for (int A=0; A<NS; ++A)
-		for (int B=0; B<NS; ++B) sum1 += m_n1[A][B];
+	for (int n=0; n<m_n1.NonZeroes(); ++n) sum1 += m_n1.Value(n);
 
 	double sum2 = 0.0;
-	for (int A=0; A<NS; ++A)
-		for (int C=0; C<NM; ++C) sum2 += m_n2[A][C];
+	for (int n=0; n<m_n2.NonZeroes(); ++n) sum2 += m_n2.Value(n);
 
 	if (fabs(sum1 - 1.0) > 1e-5) feLog("WARNING: Mortar weights are not correct (%lg).\n", sum1);
 	if (fabs(sum2 - 1.0) > 1e-5) feLog("WARNING: Mortar weights are not correct (%lg).\n", sum2);
@@ -180,27 +236,71 @@ void FEMortarInterface::UpdateNodalGaps(FEMortarContactSurface& ss, FEMortarCont
 	zero(ss.m_gap);
 
 	int NS = ss.Nodes();
-	int NM = ms.Nodes();
 
 	// loop over all primary nodes
 	for (int A=0; A<NS; ++A)
 	{
 		// loop over all primary nodes
-		for (int B=0; B<NS; ++B)
+		for (int n=m_n1.RowStart(A); n<m_n1.RowEnd(A); ++n)
 		{
-			FENode& nodeB = ss.Node(B);
+			FENode& nodeB = ss.Node(m_n1.Column(n));
 			vec3d& xB = nodeB.m_rt;
-			double nAB = m_n1[A][B];
+			double nAB = m_n1.Value(n);
 			gap[A] += xB*nAB;
 		}
 
 		// loop over secondary side
-		for (int C=0; C<NM; ++C)
+		for (int n=m_n2.RowStart(A); n<m_n2.RowEnd(A); ++n)
 		{
-			FENode& nodeC = ms.Node(C);
+			FENode& nodeC = ms.Node(m_n2.Column(n));
 			vec3d& xC = nodeC.m_rt;
-			double nAC = m_n2[A][C];
+			double nAC = m_n2.Value(n);
 			gap[A] -= xC*nAC;
 		}
 	}
 }
+
+//-----------------------------------------------------------------------------
+//! Each primary node A couples all the nodes B and C with non-zero weights n_AB and n_AC.
+//! (The sliding contact also couples these nodes to the nodes of the facets that contain A.)
+void FEMortarInterface::BuildMortarProfile(FEGlobalMatrix& K, FESurface& ss, FESurface& ms)
+{
+	vector<int> LM;
+	int NF = ss.Elements();
+	for (int i=0; i<NF; ++i)
+	{
+		FESurfaceElement& f = ss.Element(i);
+		int nn = f.Nodes();
+		for (int j=0; j<nn; ++j)
+		{
+			int A = f.m_lnode[j];
+			int nA = (m_n1.RowEnd(A) - m_n1.RowStart(A)) + (m_n2.RowEnd(A) - m_n2.RowStart(A));
+			if (nA == 0) continue;
+
+			LM.assign(3*(nn + nA), -1);
+			int m = 0;
+			for (int k=0; k<nn; ++k, m += 3)
+			{
+				FENode& node = ss.Node(f.m_lnode[k]);
+				LM[m  ] = node.m_ID[0];
+				LM[m+1] = node.m_ID[1];
+				LM[m+2] = node.m_ID[2];
+			}
+			for (int n=m_n1.RowStart(A); n<m_n1.RowEnd(A); ++n, m += 3)
+			{
+				FENode& node = ss.Node(m_n1.Column(n));
+				LM[m  ] = node.m_ID[0];
+				LM[m+1] = node.m_ID[1];
+				LM[m+2] = node.m_ID[2];
+			}
+			for (int n=m_n2.RowStart(A); n<m_n2.RowEnd(A); ++n, m += 3)
+			{
+				FENode& node = ms.Node(m_n2.Column(n));
+				LM[m  ] = node.m_ID[0];
+				LM[m+1] = node.m_ID[1];
+				LM[m+2] = node.m_ID[2];
+			}
+			K.build_add(LM);
+		}
+	}
+}
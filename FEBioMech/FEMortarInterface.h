@@ -29,6 +29,55 @@ SOFTWARE.*/
 #pragma once
 #include "FEContactInterface.h"
 #include "FEMortarContactSurface.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Sparse storage (compressed rows) of the mortar integration weights. Each primary 
+// node only couples to the nodes of the facets that overlap its own facets, so the 
+// number of non-zeroes grows linearly with the size of the interface.
+// The weights are first accumulated with Add and then compressed with Compress. 
+class FEMortarWeights
+{
+	struct ENTRY
+	{
+		int		row, col;
+		double	val;
+	};
+
+public:
+	FEMortarWeights();
+
+	//! clear all weights and set the size
+	void Create(int rows, int cols);
+
+	//! add to a weight (call Compress when done)
+	void Add(int i, int j, double v) { m_tmp.push_back({ i, j, v }); }
+
+	//! sort and merge the weights that were added
+	void Compress();
+
+	int Rows() const { return m_rows; }
+	int Columns() const { return m_cols; }
+	int NonZeroes() const { return (int)m_val.size(); }
+
+	//! range of the non-zeroes in row i (in ascending column order)
+	int RowStart(int i) const { return m_ptr[i]; }
+	int RowEnd  (int i) const { return m_ptr[i + 1]; }
+
+	//! column and value of non-zero n
+	int Column(int n) const { return m_col[n]; }
+	double Value(int n) const { return m_val[n]; }
+
+	//! value of weight (i,j)
+	double operator () (int i, int j) const;
+
+private:
+	int		m_rows, m_cols;
+	std::vector<int>	m_ptr;	//!< start of each row (size = rows + 1)
+	std::vector<int>	m_col;	//!< column indices
+	std::vector<double>	m_val;	//!< values
+	std::vector<ENTRY>	m_tmp;	//!< weights that were added but not compressed yet
+};
 
 //-----------------------------------------------------------------------------
 // Base class for mortar-type contact formulations
@@ -44,9 +93,12 @@ public:
 	//! update the nodal gaps
 	void UpdateNodalGaps(FEMortarContactSurface& ss, FEMortarContactSurface& ms);
 
+	//! add the couplings of the non-zero mortar weights to the matrix profile
+	void BuildMortarProfile(FEGlobalMatrix& K, FESurface& ss, FESurface& ms);
+
 protected:
-	matrix	m_n1;	//!< integration weights n1_AB
-	matrix	m_n2;	//!< integration weights n2_AB
+	FEMortarWeights	m_n1;	//!< integration weights n1_AB
+	FEMortarWeights	m_n2;	//!< integration weights n2_AB
 
 private:
 	// integration rule
@@ -107,26 +107,8 @@ void FEMortarTiedContact::Activate()
 //! build the matrix profile for use in the stiffness matrix
 void FEMortarTiedContact::BuildMatrixProfile(FEGlobalMatrix& K)
 {
-	// For now we'll assume that each node on the primary side is connected to the secondary side
-	// This is obviously too much, but we'll worry about improving this later
-	int NS = m_ss.Nodes();
-	int NM = m_ms.Nodes();
-	vector<int> LM(3*(NS+NM));
-	for (int i=0; i<NS; ++i)
-	{
-		FENode& ni = m_ss.Node(i);
-		LM[3*i  ] = ni.m_ID[0];
-		LM[3*i+1] = ni.m_ID[1];
-		LM[3*i+2] = ni.m_ID[2];
-	}
-	for (int i=0; i<NM; ++i)
-	{
-		FENode& ni = m_ms.Node(i);
-		LM[3*NS + 3*i  ] = ni.m_ID[0];
-		LM[3*NS + 3*i+1] = ni.m_ID[1];
-		LM[3*NS + 3*i+2] = ni.m_ID[2];
-	}
-	K.build_add(LM);
+	// only the nodes with non-zero mortar weights are connected
+	BuildMortarProfile(K, m_ss, m_ms);
 }
 
 //-----------------------------------------------------------------------------
@@ -134,7 +116,6 @@ void FEMortarTiedContact::BuildMatrixProfile(FEGlobalMatrix& K)
 void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
 	int NS = m_ss.Nodes();
-	int NM = m_ms.Nodes();
 
 	// loop over all primary nodes
 	for (int A=0; A<NS; ++A)
@@ -147,15 +128,16 @@ void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		vector<int> en(1);
 		vector<int> lm(3);
 		vector<double> fe(3);
-		for (int B=0; B<NS; ++B)
+		for (int nB=m_n1.RowStart(A); nB<m_n1.RowEnd(A); ++nB)
 		{
+			int B = m_n1.Column(nB);
 			FENode& nodeB = m_ss.Node(B);
 			en[0] = m_ss.NodeIndex(B);
 			lm[0] = nodeB.m_ID[m_dofX];
 			lm[1] = nodeB.m_ID[m_dofY];
 			lm[2] = nodeB.m_ID[m_dofZ];
 
-			double nAB = -m_n1[A][B];
+			double nAB = -m_n1.Value(nB);
 			if (nAB != 0.0)
 			{
 				fe[0] = tA.x*nAB;
@@ -167,15 +149,16 @@ void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		}
 
 		// loop over secondary side
-		for (int C=0; C<NM; ++C)
+		for (int nC=m_n2.RowStart(A); nC<m_n2.RowEnd(A); ++nC)
 		{
+			int C = m_n2.Column(nC);
 			FENode& nodeC = m_ms.Node(C);
 			en[0] = m_ms.NodeIndex(C);
 			lm[0] = nodeC.m_ID[m_dofX];
 			lm[1] = nodeC.m_ID[m_dofY];
 			lm[2] = nodeC.m_ID[m_dofZ];
 
-			double nAC = m_n2[A][C];
+			double nAC = m_n2.Value(nC);
 			if (nAC != 0.0)
 			{
 				fe[0] = tA.x*nAC;
@@ -193,7 +176,6 @@ void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
 	int NS = m_ss.Nodes();
-	int NM = m_ms.Nodes();
 
 	// A. Linearization of the gap function
 	vector<int> lmi(3), lmj(3);
@@ -204,25 +186,27 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		double eps = m_eps*m_ss.m_A[A];
 
 		// loop over all primary nodes
-		for (int B=0; B<NS; ++B)
+		for (int nB=m_n1.RowStart(A); nB<m_n1.RowEnd(A); ++nB)
 		{
+			int B = m_n1.Column(nB);
 			FENode& nodeB = m_ss.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = m_n1[A][B]*eps;
+			double nAB = m_n1.Value(nB)*eps;
 			if (nAB != 0.0)
 			{
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (int nC=m_n1.RowStart(A); nC<m_n1.RowEnd(A); ++nC)
 				{
+					int C = m_n1.Column(nC);
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C]*nAB;
+					double nAC = m_n1.Value(nC)*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -235,14 +219,15 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (int nC=m_n2.RowStart(A); nC<m_n2.RowEnd(A); ++nC)
 				{
+					int C = m_n2.Column(nC);
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C]*nAB;
+					double nAC = -m_n2.Value(nC)*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -257,25 +242,27 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		}
 
 		// loop over all secondary nodes
-		for (int B=0; B<NM; ++B)
+		for (int nB=m_n2.RowStart(A); nB<m_n2.RowEnd(A); ++nB)
 		{
+			int B = m_n2.Column(nB);
 			FENode& nodeB = m_ms.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = -m_n2[A][B]*eps;
+			double nAB = -m_n2.Value(nB)*eps;
 			if (nAB != 0.0)
 			{
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (int nC=m_n1.RowStart(A); nC<m_n1.RowEnd(A); ++nC)
 				{
+					int C = m_n1.Column(nC);
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C]*nAB;
+					double nAC = m_n1.Value(nC)*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -288,14 +275,15 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (int nC=m_n2.RowStart(A); nC<m_n2.RowEnd(A); ++nC)
 				{
+					int C = m_n2.Column(nC);
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C]*nAB;
+					double nAC = -m_n2.Value(nC)*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -45,6 +45,128 @@ FEMaterialPointData* FEReactiveViscoelasticMaterialPoint::Copy()
     return pt;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// FEReactiveVEGenerations
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+FEReactiveVEGenerations::FEReactiveVEGenerations()
+{
+	m_head = 0;
+	m_ng = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FEReactiveVEGenerations::clear()
+{
+	m_head = 0;
+	m_ng = 0;
+}
+
+//-----------------------------------------------------------------------------
+//! double the capacity of the buffer, and store the generations from the start
+void FEReactiveVEGenerations::grow()
+{
+	int cap = capacity();
+	int newCap = (cap < 2 ? 4 : 2*cap);
+
+	std::vector<mat3ds> Uv(newCap);
+	std::vector<double> Jv(newCap), v(newCap), f(newCap), wv(newCap);
+	for (int i = 0; i < m_ng; ++i)
+	{
+		int k = index(i);
+		Uv[i] = m_Uv[k];
+		Jv[i] = m_Jv[k];
+		v [i] = m_v [k];
+		f [i] = m_f [k];
+		wv[i] = m_wv[k];
+	}
+	m_Uv.swap(Uv);
+	m_Jv.swap(Jv);
+	m_v.swap(v);
+	m_f.swap(f);
+	m_wv.swap(wv);
+	m_head = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FEReactiveVEGenerations::push_back(const mat3ds& Uv, double Jv, double v, double f, double wv)
+{
+	if (m_ng == capacity()) grow();
+	int k = index(m_ng++);
+	m_Uv[k] = Uv;
+	m_Jv[k] = Jv;
+	m_v [k] = v;
+	m_f [k] = f;
+	m_wv[k] = wv;
+}
+
+//-----------------------------------------------------------------------------
+void FEReactiveVEGenerations::erase(int i)
+{
+	assert((i >= 0) && (i < m_ng));
+
+	// move the generations on the shorter side of i
+	if (i < m_ng / 2)
+	{
+		for (int k = i; k > 0; --k)
+		{
+			int k0 = index(k - 1), k1 = index(k);
+			m_Uv[k1] = m_Uv[k0];
+			m_Jv[k1] = m_Jv[k0];
+			m_v [k1] = m_v [k0];
+			m_f [k1] = m_f [k0];
+			m_wv[k1] = m_wv[k0];
+		}
+		m_head = index(1);
+	}
+	else
+	{
+		for (int k = i; k < m_ng - 1; ++k)
+		{
+			int k0 = index(k), k1 = index(k + 1);
+			m_Uv[k0] = m_Uv[k1];
+			m_Jv[k0] = m_Jv[k1];
+			m_v [k0] = m_v [k1];
+			m_f [k0] = m_f [k1];
+			m_wv[k0] = m_wv[k1];
+		}
+	}
+	m_ng--;
+}
+
+//-----------------------------------------------------------------------------
+void FEReactiveVEGenerations::merge(int i, double w0, double w1)
+{
+	assert((i >= 0) && (i < m_ng - 1));
+
+	// use equal weights when both generations have fully relaxed
+	double w = w0 + w1;
+	if (w <= 0) { w0 = w1 = 0.5; w = 1.0; }
+
+	int k0 = index(i), k1 = index(i + 1);
+	m_v [k1] = (w0*m_v [k0] + w1*m_v [k1])/w;
+	m_Uv[k1] = (m_Uv[k0]*w0 + m_Uv[k1]*w1)/w;
+	m_Jv[k1] = m_Uv[k1].det();
+	m_f [k1] = (w0*m_f [k0] + w1*m_f [k1])/w;
+	m_wv[k1] = (w0*m_wv[k0] + w1*m_wv[k1])/w;
+
+	erase(i);
+}
+
+//-----------------------------------------------------------------------------
+//! Replacing two generations by their weighted average changes the bond stress
+//! by an amount that is proportional to the difference of their reference 
+//! configurations, and to the harmonic mean of their mass fractions.
+double FEReactiveVEGenerations::mergeError(int i, double w0, double w1) const
+{
+	double w = w0 + w1;
+	if (w <= 0) return 0.0;
+	return (w0*w1/w)*(Uv(i + 1) - Uv(i)).norm();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // FEReactiveVEMaterialPoint
@@ -65,14 +187,10 @@ FEMaterialPointData* FEReactiveVEMaterialPoint::Copy()
 void FEReactiveVEMaterialPoint::Init()
 {
 	// initialize data to zero
-	m_Uv.clear();
-	m_Jv.clear();
-	m_v.clear();
-	m_f.clear();
+	m_gen.clear();
     
     m_Et = 0;
     m_Em = 0;
-    m_wv.clear();
     
     // don't forget to initialize the base class
 	FEMaterialPointData::Init();
@@ -93,18 +211,21 @@ void FEReactiveVEMaterialPoint::Serialize(DumpStream& ar)
     
     if (ar.IsSaving())
     {
-        int n = (int)m_Uv.size();
+        int n = m_gen.size();
         ar << n;
-        for (int i=0; i<n; ++i) ar << m_Uv[i] << m_Jv[i] << m_v[i] << m_f[i];
+        for (int i=0; i<n; ++i) ar << m_gen.Uv(i) << m_gen.Jv(i) << m_gen.v(i) << m_gen.f(i) << m_gen.wv(i);
     }
     else
     {
         int n;
         ar >> n;
-		m_Uv.resize(n);
-		m_Jv.resize(n);
-		m_v.resize(n);
-		m_f.resize(n);
-        for (int i=0; i<n; ++i) ar >> m_Uv[i] >> m_Jv[i] >> m_v[i] >> m_f[i];
+        m_gen.clear();
+        for (int i=0; i<n; ++i)
+        {
+            mat3ds Uv;
+            double Jv, v, f, wv;
+            ar >> Uv >> Jv >> v >> f >> wv;
+            m_gen.push_back(Uv, Jv, v, f, wv);
+        }
     }
 }
@@ -30,7 +30,7 @@ SOFTWARE.*/
 #include "FECore/FEMaterialPoint.h"
 #include "FEReactiveViscoelastic.h"
 #include "FEUncoupledReactiveViscoelastic.h"
-#include <deque>
+#include <vector>
 
 class FEReactiveViscoelasticMaterial;
 class FEUncoupledReactiveViscoelasticMaterial;
@@ -48,6 +48,72 @@ public:
     FEMaterialPointData* Copy();
 };
 
+//-----------------------------------------------------------------------------
+//! Storage for the generations of a reactive viscoelastic material point.
+//! The generations are kept in a ring buffer, with one contiguous array for each
+//! generation variable. Generation 0 is the oldest generation and generation
+//! size()-1 the most recent one. The buffer only grows when a generation is added
+//! to a full buffer, so its capacity is bounded by the number of generations the
+//! material allows at a point.
+class FEReactiveVEGenerations
+{
+public:
+	FEReactiveVEGenerations();
+
+	//! number of generations
+	int size() const { return m_ng; }
+
+	//! no generations
+	bool empty() const { return (m_ng == 0); }
+
+	//! number of generations that can be stored without growing the buffer
+	int capacity() const { return (int)m_v.size(); }
+
+	//! remove all generations
+	void clear();
+
+	//! add a new generation
+	void push_back(const mat3ds& Uv, double Jv, double v, double f, double wv);
+
+	//! remove generation i
+	void erase(int i);
+
+	//! Merge generation i into generation i+1, using the bond mass fractions w0 and w1 
+	//! of these generations as weights. 
+	void merge(int i, double w0, double w1);
+
+	//! Estimate of the error introduced by merging generations i and i+1 with bond 
+	//! mass fractions w0 and w1.
+	double mergeError(int i, double w0, double w1) const;
+
+public:
+	mat3ds& Uv(int i) { return m_Uv[index(i)]; }
+	double& Jv(int i) { return m_Jv[index(i)]; }
+	double& v (int i) { return m_v [index(i)]; }
+	double& f (int i) { return m_f [index(i)]; }
+	double& wv(int i) { return m_wv[index(i)]; }
+
+	const mat3ds& Uv(int i) const { return m_Uv[index(i)]; }
+	double Jv(int i) const { return m_Jv[index(i)]; }
+	double v (int i) const { return m_v [index(i)]; }
+	double f (int i) const { return m_f [index(i)]; }
+	double wv(int i) const { return m_wv[index(i)]; }
+
+private:
+	int index(int i) const { int k = m_head + i; int n = capacity(); return (k < n ? k : k - n); }
+
+	void grow();
+
+private:
+	std::vector<mat3ds>	m_Uv;	//!< right stretch tensor at tv (when generation u starts breaking)
+	std::vector<double>	m_Jv;	//!< determinant of Uv (store for efficiency)
+	std::vector<double>	m_v;	//!< time tv when generation starts breaking
+	std::vector<double>	m_f;	//!< mass fraction when generation starts breaking
+	std::vector<double>	m_wv;	//!< total mass fraction of weak bonds
+	int		m_head;			//!< position of the oldest generation
+	int		m_ng;			//!< number of generations
+};
+
 //-----------------------------------------------------------------------------
 //! Material point data for reactive viscoelastic materials
 class FEReactiveVEMaterialPoint : public FEMaterialPointData
@@ -70,14 +136,10 @@ public:
     
 public:
     // multigenerational material data
-    deque <mat3ds> m_Uv;	//!< right stretch tensor at tv (when generation u starts breaking)
-    deque <double> m_Jv;	//!< determinant of Uv (store for efficiency)
-    deque <double> m_v;     //!< time tv when generation starts breaking
-    deque <double> m_f;     //!< mass fraction when generation starts breaking
+    FEReactiveVEGenerations m_gen;  //!< breaking generations (including their weak bond mass fraction)
     
 public:
     // weak bond recruitment parameters
     double m_Et;            //!< trial strain value at time t
     double m_Em;            //!< max strain value up to time t
-    deque <double> m_wv;    //!< total mass fraction of weak bonds
 };
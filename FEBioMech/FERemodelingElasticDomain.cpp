@@ -32,6 +32,7 @@ SOFTWARE.*/
 #include "FECore/FEAnalysis.h"
 #include <FECore/FEModel.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -93,9 +94,9 @@ void FERemodelingElasticDomain::StiffnessMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = 3*el.Nodes();
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 		ke.zero();
 
 		// calculate geometrical stiffness
@@ -115,7 +116,7 @@ void FERemodelingElasticDomain::StiffnessMatrix(FELinearSystem& LS)
 				ke[j][i] = ke[i][j];
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -47,7 +47,9 @@ FEResidualVector::~FEResidualVector()
 void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
 {
     
-    vector<double>& R = m_R;
+    // in reduction mode we assemble into the thread's buffer
+    ReductionBuffer* buf = ThreadBuffer();
+    vector<double>& R = (buf ? buf->R : m_R);
     
     int i, I, n;
     
@@ -56,20 +58,29 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
     {
         // assemble the element residual into the global residual
         int ndof = (int)fe.size();
-        for (i=0; i<ndof; ++i)
+        if (buf)
         {
-            
-            I = elm[i];
-            
-            if ( I >= 0){
-#pragma omp atomic
-                R[I] += fe[i];
+            for (i=0; i<ndof; ++i)
+            {
+                I = elm[i];
+                if (I >= 0) buf->AddR(I, fe[i]);
+                else if (-I-2 >= 0) buf->AddFr(-I-2, -fe[i]);
             }
-            // TODO: Find another way to store reaction forces
-            
-            else if (-I-2 >= 0){
+        }
+        else
+        {
+            for (i=0; i<ndof; ++i)
+            {
+                I = elm[i];
+                if ( I >= 0){
+#pragma omp atomic
+                    R[I] += fe[i];
+                }
+                // TODO: Find another way to store reaction forces
+                else if (-I-2 >= 0){
 #pragma omp atomic
-                m_Fr[-I-2] -= fe[i];
+                    m_Fr[-I-2] -= fe[i];
+                }
             }
         }
         
@@ -83,12 +94,14 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 		if (LCM.LinearConstraints())
 		{
 			LCM.AssembleResidual(R, en, elm, fe);
+			if (buf) buf->Touch();
 		}
         
         // If there are rigid bodies we need to look for rigid dofs
 		FEMechModel* fem = dynamic_cast<FEMechModel*>(&m_fem);
         if (fem && (fem->RigidBodies() > 0))
         {
+            if (buf) buf->Touch();
             int *lm;
             for (i=0; i<ndof; i+=ndn)
             {
@@ -207,16 +220,26 @@ void FEResidualVector::Assemble(int node_id, int dof, double f)
 	int n = node.m_ID[dof];
 
 	// assemble into global vector
+	ReductionBuffer* buf = ThreadBuffer();
 	if (n >= 0) {
+		if (buf) buf->AddR(n, f);
+		else
+		{
 #pragma omp atomic
-		m_R[n] += f;
+			m_R[n] += f;
+		}
 	}
 	else {
 		FESolidSolver2* solver = dynamic_cast<FESolidSolver2*>(m_fem.GetCurrentStep()->GetFESolver());
 		if (solver)
 		{
 			FERigidSolver* rigidSolver = solver->GetRigidSolver();
-			rigidSolver->AssembleResidual(node_id, dof, f, m_R);
+			if (buf)
+			{
+				rigidSolver->AssembleResidual(node_id, dof, f, buf->R);
+				buf->Touch();
+			}
+			else rigidSolver->AssembleResidual(node_id, dof, f, m_R);
 		}
 	}
 }
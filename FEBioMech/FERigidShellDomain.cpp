@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include <FECore/FELinearSystem.h>
 #include <FECore/FEModel.h>
 #include "FEBioMech.h"
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 FERigidShellDomainOld::FERigidShellDomainOld(FEModel* pfem) : FEElasticShellDomainOld(pfem) {}
@@ -174,16 +175,16 @@ void FERigidShellDomain::BodyForce(FEGlobalVector& R, FEBodyForce& bf)
 #pragma omp parallel for
 	for (int i = 0; i < NS; ++i)
 	{
-		// element force vector
-		vector<double> fe;
-		vector<int> lm;
+		// scratch buffers for the element force vector and LM vector
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<int>& lm = scratch.LM();
 
 		// get the element
 		FEShellElement& el = m_Elem[i];
 
 		// create the element force vector and initialize to zero
 		int ndof = 3 * el.Nodes();
-		fe.assign(ndof, 0);
+		vector<double>& fe = scratch.Vector(ndof);
 
 		// apply body forces to shells
 		ElementBodyForce(bf, el, fe);
@@ -252,16 +253,16 @@ void FERigidShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
 		FEShellElement& el = m_Elem[iel];
 
 		// create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = 3 * el.Nodes();
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 		ke.zero();
 
 		// calculate inertial stiffness
 		ElementBodyForceStiffness(bf, el, ke);
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -489,6 +489,8 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
     FENormalProjection np(ms);
     np.SetTolerance(m_stol);
     np.SetSearchRadius(m_srad);
+    np.SetSearchTree(ms.GetSearchTree());
+    np.SetNeighborList(ms.GetFacetNeighbors());
     np.Init();
     
     double psf = GetPenaltyScaleFactor();
@@ -526,6 +528,7 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
         if (ss.IsShellBottom()) for (int i=0; i<NN; ++i) normal[i] = -normal[i];
         
         // loop over all nodes
+#pragma omp parallel for schedule(dynamic)
         for (int i=0; i<NN; ++i)
         {
             FENode& node = ss.Node(i);
@@ -600,8 +603,9 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
                 }
             }
             
-            // find the intersection point with the secondary surface
-            if (pme == 0 && bupseg) pme = np.Project(r, nu, rs);
+            // find the intersection point with the secondary surface,
+            // starting the search from the previous facet
+            if (pme == 0 && bupseg) pme = np.ProjectFrom(data.m_pme, r, nu, rs);
             
             data.m_pme = pme;
             data.m_nu = nu;
@@ -941,11 +945,6 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
 {
     const int MN = FEElement::MAX_NODES;
     
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
-    double detJ[MN], w[MN], Hm[MN];
-    double N[MN*6];
-    
     m_ss.m_Ft = vec3d(0,0,0);
     m_ms.m_Ft = vec3d(0,0,0);
     
@@ -957,10 +956,20 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
         FESlidingElasticSurface& ss = (np == 0? m_ss : m_ms);
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
+        // contact forces of each primary element, summed after the loop
+        // so that the totals do not depend on the thread scheduling
+        int NE = ss.Elements();
+        vector<vec3d> Fs(NE, vec3d(0,0,0)), Fm(NE, vec3d(0,0,0));
+        
         // loop over all primary elements
-        //#pragma omp parallel for private(sLM, mLM, LM, en, fe, detJ, w, Hm, N)
-        for (int i=0; i<ss.Elements(); ++i)
+#pragma omp parallel for schedule(static) shared(NE)
+        for (int i=0; i<NE; ++i)
         {
+            vector<int> sLM, mLM, LM, en;
+            vector<double> fe;
+            double detJ[MN], w[MN], Hm[MN];
+            double N[MN*6];
+            
             // get the surface element
             FESurfaceElement& se = ss.Element(i);
             
@@ -1068,12 +1077,12 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
                         // calculate contact forces
                         for (int k=0; k<nseln; ++k)
                         {
-                            ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+                            Fs[i] += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
                         }
                         
                         for (int k = 0; k<nmeln; ++k)
                         {
-                            ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+                            Fm[i] += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
                         }
                         
                         // assemble the global residual
@@ -1082,6 +1091,12 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
                 }
             }
         }
+        
+        for (int i=0; i<NE; ++i)
+        {
+            ss.m_Ft += Fs[i];
+            ms.m_Ft += Fm[i];
+        }
     }
 }
 
@@ -1093,11 +1108,6 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
     
     const int MN = FEElement::MAX_NODES;
     
-    double detJ[MN], w[MN], Hm[MN];
-    double N[MN*6];
-    vector<int> sLM, mLM, LM, en;
-    FEElementMatrix ke;
-    
     double psf = GetPenaltyScaleFactor();
     
     // do single- or two-pass
@@ -1109,9 +1119,13 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
         // loop over all primary elements
-        //#pragma omp parallel for private(detJ, w, Hm, N, sLM, mLM, LM, en, ke)
-        for (int i=0; i<ss.Elements(); ++i)
+        ParallelAssemble(LS, ss, [&](int i)
         {
+            double detJ[MN], w[MN], Hm[MN];
+            double N[MN*6];
+            vector<int> sLM, mLM, LM, en;
+            FEElementMatrix ke;
+            
             // get ths primary element
             FESurfaceElement& se = ss.Element(i);
             
@@ -1526,7 +1540,7 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
                     }
                 }
             }
-        }
+        });
     }
 }
 
@@ -523,19 +523,22 @@ void FESlidingInterface::Activate()
 
 void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface& ms, bool bupseg, bool bmove)
 {
-	// node projection data
-	double r, s;
-	vec3d q;
-
 	FEClosestPointProjection cpp(ms);
 	cpp.SetTolerance(m_stol);
 	cpp.SetSearchRadius(m_sradius);
 	cpp.HandleSpecialCases(true);
+	cpp.SetSearchTree(ms.GetSearchTree());
 	cpp.Init();
 
 	// loop over all primary surface nodes
+	// (each node only updates its own projection data)
+#pragma omp parallel for schedule(dynamic)
 	for (int i=0; i<ss.Nodes(); ++i)
 	{
+		// node projection data
+		double r, s;
+		vec3d q;
+
 		// get the node
 		FENode& node = ss.Node(i);
 
@@ -695,25 +698,7 @@ void FESlidingInterface::Update()
 
 void FESlidingInterface::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	// element contact force vector
-	vector<double> fe;
-
-	// the lm array for this force vector
-	vector<int> lm;
-
-	// the en array
-	vector<int> en;
-
-	// the elements LM vectors
-	vector<int> sLM;
-	vector<int> mLM;
-
 	const int MN = FEElement::MAX_NODES;
-	vec3d r0[MN];
-	double w[MN];
-	double* Gr, *Gs;
-	double detJ[MN];
-	vec3d dxr, dxs;
 
 	// do two-pass
 	int npass = (m_btwo_pass?2:1);
@@ -725,8 +710,28 @@ void FESlidingInterface::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 		// loop over all primary surface facets
 		int ne = ss.Elements();
+#pragma omp parallel for schedule(static) shared(ne)
 		for (int j=0; j<ne; ++j)
 		{
+			// element contact force vector
+			vector<double> fe;
+
+			// the lm array for this force vector
+			vector<int> lm;
+
+			// the en array
+			vector<int> en;
+
+			// the elements LM vectors
+			vector<int> sLM;
+			vector<int> mLM;
+
+			vec3d r0[MN];
+			double w[MN];
+			double* Gr, *Gs;
+			double detJ[MN];
+			vec3d dxr, dxs;
+
 			// get the next element
 			FESurfaceElement& sel = ss.Element(j);
 			int nseln = sel.Nodes();
@@ -1038,20 +1043,7 @@ void FESlidingInterface::ContactNodalForce(int m, FESlidingSurface& ss, FESurfac
 
 void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	FEElementMatrix ke;
-
 	const int MAXMN = FEElement::MAX_NODES;
-	vector<int> lm(3*(MAXMN + 1));
-	vector<int> en(MAXMN+1);
-
-	double *Gr, *Gs, w[MAXMN];
-	vec3d r0[MAXMN];
-
-	double detJ[MAXMN];
-	vec3d dxr, dxs;
-
-	vector<int> sLM;
-	vector<int> mLM;
 
 	// do two-pass
 	int npass = (m_btwo_pass?2:1);
@@ -1061,10 +1053,29 @@ void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& t
 		FESlidingSurface& ss = (np==0?m_ss:m_ms);	
 		FESlidingSurface& ms = (np==0?m_ms:m_ss);	
 
+		// the secondary facets that the nodes of a primary facet are paired with
+		auto pairs = [&](int j, vector<FESurfaceElement*>& pe) {
+			FESurfaceElement& se = ss.Element(j);
+			for (int n=0; n<se.Nodes(); ++n) pe.push_back(ss.m_data[se.m_lnode[n]].m_pme);
+		};
+
 		// loop over all primary surface elements
-		int ne = ss.Elements();
-		for (int j=0; j<ne; ++j)
+		ParallelAssemble(LS, ss, [&](int j)
 		{
+			FEElementMatrix ke;
+
+			vector<int> lm(3*(MAXMN + 1));
+			vector<int> en(MAXMN+1);
+
+			double *Gr, *Gs, w[MAXMN];
+			vec3d r0[MAXMN];
+
+			double detJ[MAXMN];
+			vec3d dxr, dxs;
+
+			vector<int> sLM;
+			vector<int> mLM;
+
 			// unpack the next element
 			FESurfaceElement& se = ss.Element(j);
 			int nseln = se.Nodes();
@@ -1147,7 +1158,7 @@ void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& t
 					LS.Assemble(ke);
 				}
 			}
-		}
+		}, pairs);
 	}
 }
 
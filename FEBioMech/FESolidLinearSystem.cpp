@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FESolidSolver.h"
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/FEModel.h>
+#include "FEMechModel.h"
 
 FESolidLinearSystem::FESolidLinearSystem(FESolver* solver, FERigidSolver* rigidSolver, FEGlobalMatrix& K, std::vector<double>& F, std::vector<double>& u, bool bsymm, double alpha, int nreq) : FELinearSystem(solver, K, F, u, bsymm)
 {
@@ -45,6 +46,14 @@ void FESolidLinearSystem::StiffnessAssemblyScaleFactor(double a)
 	m_stiffnessScale = a;
 }
 
+// The rigid body stiffness needs the full element matrices
+bool FESolidLinearSystem::UpperTriangularAssembly() const
+{
+	if (FELinearSystem::UpperTriangularAssembly() == false) return false;
+	FEMechModel* fem = dynamic_cast<FEMechModel*>(m_solver->GetFEModel());
+	return ((fem == nullptr) || (fem->RigidBodies() == 0));
+}
+
 void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 {
 	// Rigid joints require a different assembly approach in that we can do 
@@ -77,6 +86,7 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 		FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
 		if (LCM.LinearConstraints() > 0)
 		{
+			assert(ke.IsUpperTriangular() == false);
 			#pragma omp critical 
 			LCM.AssembleStiffness(m_K, m_F, m_u, ke.Nodes(), ke.RowIndices(), ke.ColumnsIndices(), ke);
 		}
@@ -109,8 +119,12 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 						if (I >= 0)
 						{
 							// dof i is not a prescribed degree of freedom
-							#pragma omp atomic
-							m_F[I] -= ke[i][j] * ui[J];
+							if (m_batomic)
+							{
+								#pragma omp atomic
+								m_F[I] -= ke.value(i, j) * ui[J];
+							}
+							else m_F[I] -= ke.value(i, j) * ui[J];
 						}
 					}
 
@@ -42,6 +42,9 @@ public:
 	// The contributions of prescribed degrees of freedom will be stored in m_F
 	void Assemble(const FEElementMatrix& ke) override;
 
+	// see if element matrices of which only the upper triangle is set can be assembled
+	bool UpperTriangularAssembly() const override;
+
 	// scale factor for stiffness matrix
 	void StiffnessAssemblyScaleFactor(double a);
 
@@ -70,6 +70,8 @@ BEGIN_FECORE_CLASS(FESolidSolver2, FENewtonSolver)
 		ADD_PARAMETER(m_logSolve  , "logSolve"    );
 		ADD_PARAMETER(m_arcLength , "arc_length"  );
 		ADD_PARAMETER(m_al_scale  , "arc_length_scale");
+		ADD_PARAMETER(m_domainTasks, "domain_tasks");
+		ADD_PARAMETER(m_reduceResidual, "residual_reduction");
 	END_PARAM_GROUP();
 END_FECORE_CLASS();
 
@@ -91,6 +93,8 @@ m_dofBW(pfem), m_dofBA(pfem)
 	m_nreq = 0;
 
 	m_logSolve = false;
+	m_domainTasks = true;
+	m_reduceResidual = false;
 
 	// default Newmark parameters (trapezoidal rule)
     m_rhoi = -2;
@@ -198,6 +202,10 @@ bool FESolidSolver2::Init()
         m_alphaf = m_alpham = m_alpha;
     }
     
+	// the residual reduction is only reproducible if the elements are always 
+	// processed by the same threads
+	m_tasks.SetStaticSchedule(m_reduceResidual);
+
 	// allocate vectors
 //	m_Fn.assign(m_neq, 0);
 	m_Fr.assign(m_neq, 0);
@@ -1193,14 +1201,18 @@ bool FESolidSolver2::StiffnessMatrix()
 	FESolidLinearSystem LS(this, &m_rigidSolver, *m_pK, m_Fd, m_ui, (m_msymm == REAL_SYMMETRIC), m_alpha, m_nreq);
 
 	// calculate the stiffness matrix for each domain
+	// (domains that support it are evaluated together afterwards)
+	m_tasks.Clear();
 	for (int i=0; i<mesh.Domains(); ++i) 
 	{
 		if (mesh.Domain(i).IsActive()) 
 		{
 			FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
-			dom.StiffnessMatrix(LS);
+			if ((m_domainTasks == false) || (dom.StiffnessMatrixTasks(LS, m_tasks) == false))
+				dom.StiffnessMatrix(LS);
 		}
 	}
+	m_tasks.Run();
 
 	// calculate the body force stiffness matrix for each non-rigid domain
 	for (int j = 0; j<fem.ModelLoads(); ++j)
@@ -1291,11 +1303,13 @@ void FESolidSolver2::ContactForces(FEGlobalVector& R)
 {
 	FEModel& fem = *GetFEModel();
 	const FETimeInfo& tp = fem.GetTime();
+	if (m_reduceResidual) R.BeginReduction();
 	for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
 	{
 		FEContactInterface* pci = dynamic_cast<FEContactInterface*>(fem.SurfacePairConstraint(i));
 		if (pci->IsActive()) pci->LoadVector(R, tp);
 	}
+	if (m_reduceResidual) R.EndReduction();
 }
 
 //-----------------------------------------------------------------------------
@@ -1390,11 +1404,19 @@ bool FESolidSolver2::Residual(vector<double>& R)
 void FESolidSolver2::InternalForces(FEGlobalVector& R)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
+	if (m_reduceResidual) R.BeginReduction();
+	m_tasks.Clear();
 	for (int i = 0; i<mesh.Domains(); ++i)
 	{
 		FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(&mesh.Domain(i));
-		if (edom) edom->InternalForces(R);
+		if (edom && ((m_domainTasks == false) || (edom->InternalForcesTasks(R, m_tasks) == false)))
+			edom->InternalForces(R);
 	}
+
+	// evaluate all the domains that were added to the task list
+	m_tasks.Run();
+
+	if (m_reduceResidual) R.EndReduction();
 }
 
 //-----------------------------------------------------------------------------
@@ -1405,12 +1427,23 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 	const FETimeInfo& tp = fem.GetTime();
 	FEMesh& mesh = fem.GetMesh();
 
+	// the model loads and inertial forces are assembled in reduction mode
+	if (m_reduceResidual) RHS.BeginReduction();
+
 	// apply loads
+	// (the body forces of domains that support it are evaluated together afterwards)
+	m_tasks.Clear();
 	for (int j = 0; j<fem.ModelLoads(); ++j)
 	{
 		FEModelLoad* pml = fem.ModelLoad(j);
-		if (pml->IsActive()) pml->LoadVector(RHS);
+		if (pml->IsActive())
+		{
+			FEBodyForce* pbf = dynamic_cast<FEBodyForce*>(pml);
+			if (m_domainTasks && pbf) pbf->LoadVectorTasks(RHS, m_tasks);
+			else pml->LoadVector(RHS);
+		}
 	}
+	m_tasks.Run();
 
 	// calculate inertial forces for dynamic problems
 	if (fem.GetCurrentStep()->m_nanalysis == FESolidAnalysis::DYNAMIC)
@@ -1429,6 +1462,8 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 		m_rigidSolver.InertialForces(RHS, tp);
 	}
 
+	if (m_reduceResidual) RHS.EndReduction();
+
 	// calculate forces due to surface loads
 /*	int nsl = fem.SurfaceLoads();
 	for (int i = 0; i<nsl; ++i)
@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include "FECore/FEGlobalVector.h"
 #include "FERigidSolver.h"
 #include <FECore/FEDofList.h>
+#include <FECore/FETaskList.h>
 
 //-----------------------------------------------------------------------------
 //! The FESolidSolver2 class solves large deformation solid mechanics problems
@@ -138,6 +139,8 @@ public:
 	double	m_Dtol;			//!< displacement tolerance
 
 	bool	m_logSolve;		//!< flag to use Aggarwal's log method
+	bool	m_domainTasks;	//!< evaluate all domains in one parallel region
+	bool	m_reduceResidual;	//!< assemble residual in thread buffers instead of with atomics
 
 	// equation numbers
 	int		m_nreq;			//!< start of rigid body equations
@@ -164,6 +167,9 @@ public:
 	double	m_al_ds;		//!< arc-length constraint
 	double	m_al_gamma;		//!< acr-length increment at current iteration
 
+protected:
+	FETaskList	m_tasks;	//!< task list for evaluating the domains
+
 protected:
 	FEDofList	m_dofU, m_dofV;
 	FEDofList	m_dofQ;
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FEElasticMaterial.h"
 #include <FECore/FEModel.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 BEGIN_FECORE_CLASS(FEUDGHexDomain, FEElasticSolidDomain)
@@ -80,15 +81,15 @@ void FEUDGHexDomain::InternalForces(FEGlobalVector& R)
 		// get the element force vector and initialize it to zero
 		int ndof = 3*el.Nodes();
 
-		// element force vector
-		vector<double> fe;
-		fe.assign(ndof, 0);
+		// scratch buffers for the element force vector and LM vector
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<double>& fe = scratch.Vector(ndof);
 
 		// calculate internal force vector
 		UDGInternalForces(el, fe);
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 
 		// assemble element 'fe'-vector into global R vector
@@ -242,11 +243,11 @@ void FEUDGHexDomain::StiffnessMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 
 		// create the element's stiffness matrix
 		int ndof = 3*el.Nodes();
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 		ke.zero();
 
 		// calculate material stiffness
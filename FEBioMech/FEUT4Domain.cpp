@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FECore/FEMesh.h"
 #include "FECore/FEModel.h"
 #include "FECore/FEGlobalMatrix.h"
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 // This function converts the Cauchy stress to a 2nd-PK stress
@@ -527,10 +528,9 @@ void FEUT4Domain::NodalInternalForces(FEGlobalVector& R)
 //! This function calculates the element contribution to the residual
 void FEUT4Domain::ElementInternalForces(FEGlobalVector& R)
 {
-	// element force vector
-	vector<double> fe;
-
-	vector<int> lm;
+	// scratch buffers for the element force vector and LM vector
+	FEElementScratch& scratch = FEElementScratch::Get();
+	vector<int>& lm = scratch.LM();
 
 	int NE = (int)m_Elem.size();
 	for (int i=0; i<NE; ++i)
@@ -540,7 +540,7 @@ void FEUT4Domain::ElementInternalForces(FEGlobalVector& R)
 
 		// get the element force vector and initialize it to zero
 		int ndof = 3*el.Nodes();
-		fe.assign(ndof, 0);
+		vector<double>& fe = scratch.Vector(ndof);
 
 		// calculate internal force vector
 		ElementInternalForces(el, fe);
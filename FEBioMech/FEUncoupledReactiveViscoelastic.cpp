@@ -47,6 +47,8 @@ BEGIN_FECORE_CLASS(FEUncoupledReactiveViscoelasticMaterial, FEUncoupledMaterial)
 	ADD_PARAMETER(m_btype, FE_RANGE_CLOSED(1, 2), "kinetics");
 	ADD_PARAMETER(m_ttype, FE_RANGE_CLOSED(0, 2), "trigger" );
     ADD_PARAMETER(m_emin , FE_RANGE_GREATER_OR_EQUAL(0.0), "emin");
+    ADD_PARAMETER(m_gmax , FE_RANGE_GREATER_OR_EQUAL(0), "max_generations");
+    ADD_PARAMETER(m_gtol , FE_RANGE_GREATER_OR_EQUAL(0.0), "merge_tol");
 
 	// set material properties
 	ADD_PROPERTY(m_pBase, "elastic");
@@ -65,6 +67,9 @@ FEUncoupledReactiveViscoelasticMaterial::FEUncoupledReactiveViscoelasticMaterial
     m_ttype = 0;
     m_emin = 0;
 
+    m_gmax = 0;
+    m_gtol = 0;
+    
     m_nmax = 0;
 
     m_pBase = nullptr;
@@ -80,6 +85,11 @@ FEUncoupledReactiveViscoelasticMaterial::FEUncoupledReactiveViscoelasticMaterial
 //! data initialization
 bool FEUncoupledReactiveViscoelasticMaterial::Init()
 {
+    if (m_gmax == 1) {
+        feLogError("max_generations must be 0 (no limit) or at least 2");
+        return false;
+    }
+    
     if (!m_pBase->Init()) return false;
     if (!m_pBond->Init()) return false;
     if (!m_pRelx->Init()) return false;
@@ -184,8 +194,8 @@ bool FEUncoupledReactiveViscoelasticMaterial::NewGeneration(FEMaterialPoint& mp)
     // the last generation, in which case store the current state
     // evaluate the relative deformation gradient
     mat3d F = ep.m_F;
-    int lg = (int)pt.m_Uv.size() - 1;
-    mat3ds Ui = (lg > -1) ? pt.m_Uv[lg].inverse() : mat3dd(1);
+    int lg = pt.m_gen.size() - 1;
+    mat3ds Ui = (lg > -1) ? pt.m_gen.Uv(lg).inverse() : mat3dd(1);
     mat3d Fu = F*Ui;
     
     switch (m_ttype) {
@@ -241,13 +251,13 @@ double FEUncoupledReactiveViscoelasticMaterial::BreakingBondMassFraction(FEMater
     
     // current time
     double time = CurrentTime();
-    double dtv = time - pt.m_v[ig];
+    double dtv = time - pt.m_gen.v(ig);
 
     switch (m_btype) {
         case 1:
         {
             if (dtv >= 0)
-                w = pt.m_f[ig]*m_pRelx->Relaxation(mp, dtv, D);
+                w = pt.m_gen.f(ig)*m_pRelx->Relaxation(mp, dtv, D);
         }
             break;
         case 2:
@@ -257,7 +267,7 @@ double FEUncoupledReactiveViscoelasticMaterial::BreakingBondMassFraction(FEMater
             }
             else
             {
-                double dtu = time - pt.m_v[ig-1];
+                double dtu = time - pt.m_gen.v(ig-1);
                 w = m_pRelx->Relaxation(mp, dtv, D) - m_pRelx->Relaxation(mp, dtu, D);
             }
         }
@@ -289,15 +299,15 @@ double FEUncoupledReactiveViscoelasticMaterial::ReformingBondMassFraction(FEMate
     double J = ep.m_J;
     
     // get current number of generations
-    int ng = (int)pt.m_Uv.size();
+    int ng = pt.m_gen.size();
     
-    double f = (!pt.m_wv.empty()) ? pt.m_wv.back() : 1;
+    double f = (!pt.m_gen.empty()) ? pt.m_gen.wv(ng-1) : 1;
     
     for (int ig=0; ig<ng-1; ++ig)
     {
         // evaluate deformation gradient when this generation starts breaking
-        ep.m_F = pt.m_Uv[ig];
-        ep.m_J = pt.m_Jv[ig];
+        ep.m_F = pt.m_gen.Uv(ig);
+        ep.m_J = pt.m_gen.Jv(ig);
         // evaluate the breaking bond mass fraction for this generation
         f -= BreakingBondMassFraction(mp, ig, D);
     }
@@ -344,7 +354,7 @@ mat3ds FEUncoupledReactiveViscoelasticMaterial::DevStressWeakBonds(FEMaterialPoi
     mat3ds s; s.zero();
     
     // current number of breaking generations
-    int ng = (int)pt.m_Uv.size();
+    int ng = pt.m_gen.size();
     
     // no bonds have broken
     if (ng == 0) {
@@ -362,14 +372,14 @@ mat3ds FEUncoupledReactiveViscoelasticMaterial::DevStressWeakBonds(FEMaterialPoi
         // calculate the bond stresses for breaking generations
         for (int ig=0; ig<ng; ++ig) {
             // evaluate bond mass fraction for this generation
-            ep.m_F = pt.m_Uv[ig];
-            ep.m_J = pt.m_Jv[ig];
+            ep.m_F = pt.m_gen.Uv(ig);
+            ep.m_J = pt.m_gen.Jv(ig);
             w = BreakingBondMassFraction(wb, ig, D);
             // evaluate relative deformation gradient for this generation
             if (ig > 0) {
-                ep.m_F = F*pt.m_Uv[ig-1].inverse();
-                ep.m_J = J/pt.m_Jv[ig-1];
-                if (fp) fp->SetPreStretch(pt.m_Uv[ig-1]);
+                ep.m_F = F*pt.m_gen.Uv(ig-1).inverse();
+                ep.m_J = J/pt.m_gen.Jv(ig-1);
+                if (fp) fp->SetPreStretch(pt.m_gen.Uv(ig-1));
             }
             else {
                 ep.m_F = F;
@@ -379,7 +389,7 @@ mat3ds FEUncoupledReactiveViscoelasticMaterial::DevStressWeakBonds(FEMaterialPoi
             // evaluate bond stress
             sb = m_pBond->DevStress(wb);
             // add bond stress to total stress
-            s += (ig > 0) ? sb*w/pt.m_Jv[ig-1] : sb*w;
+            s += (ig > 0) ? sb*w/pt.m_gen.Jv(ig-1) : sb*w;
         }
         
         // restore safe copy of deformation gradient
@@ -433,7 +443,7 @@ tens4ds FEUncoupledReactiveViscoelasticMaterial::DevTangentWeakBonds(FEMaterialP
     tens4ds c; c.zero();
     
     // current number of breaking generations
-    int ng = (int)pt.m_Uv.size();
+    int ng = pt.m_gen.size();
     
     // no bonds have broken
     if (ng == 0) {
@@ -451,14 +461,14 @@ tens4ds FEUncoupledReactiveViscoelasticMaterial::DevTangentWeakBonds(FEMaterialP
         // calculate the bond tangents for breaking generations
         for (int ig=0; ig<ng; ++ig) {
             // evaluate bond mass fraction for this generation
-            ep.m_F = pt.m_Uv[ig];
-            ep.m_J = pt.m_Jv[ig];
+            ep.m_F = pt.m_gen.Uv(ig);
+            ep.m_J = pt.m_gen.Jv(ig);
             w = BreakingBondMassFraction(wb, ig, D);
             // evaluate relative deformation gradient for this generation
             if (ig > 0) {
-                ep.m_F = F*pt.m_Uv[ig-1].inverse();
-                ep.m_J = J/pt.m_Jv[ig-1];
-                if (fp) fp->SetPreStretch(pt.m_Uv[ig-1]);
+                ep.m_F = F*pt.m_gen.Uv(ig-1).inverse();
+                ep.m_J = J/pt.m_gen.Jv(ig-1);
+                if (fp) fp->SetPreStretch(pt.m_gen.Uv(ig-1));
             }
             else {
                 ep.m_F = F;
@@ -468,7 +478,7 @@ tens4ds FEUncoupledReactiveViscoelasticMaterial::DevTangentWeakBonds(FEMaterialP
             // evaluate bond tangent
             cb = m_pBond->DevTangent(wb);
             // add bond tangent to total tangent
-            c += (ig > 0) ? cb*w/pt.m_Jv[ig-1] : cb*w;
+            c += (ig > 0) ? cb*w/pt.m_gen.Jv(ig-1) : cb*w;
         }
         
         // restore safe copy of deformation gradient
@@ -522,7 +532,7 @@ double FEUncoupledReactiveViscoelasticMaterial::WeakBondDevSED(FEMaterialPoint&
     double sed = 0;
     
     // current number of breaking generations
-    int ng = (int)pt.m_Uv.size();
+    int ng = pt.m_gen.size();
     
     // no bonds have broken
     if (ng == 0) {
@@ -540,14 +550,14 @@ double FEUncoupledReactiveViscoelasticMaterial::WeakBondDevSED(FEMaterialPoint&
         // calculate the strain energy density for breaking generations
         for (int ig=0; ig<ng; ++ig) {
             // evaluate bond mass fraction for this generation
-            ep.m_F = pt.m_Uv[ig];
-            ep.m_J = pt.m_Jv[ig];
+            ep.m_F = pt.m_gen.Uv(ig);
+            ep.m_J = pt.m_gen.Jv(ig);
             w = BreakingBondMassFraction(wb, ig, D);
             // evaluate relative deformation gradient for this generation
             if (ig > 0) {
-                ep.m_F = F*pt.m_Uv[ig-1].inverse();
-                ep.m_J = J/pt.m_Jv[ig-1];
-                if (fp) fp->SetPreStretch(pt.m_Uv[ig-1]);
+                ep.m_F = F*pt.m_gen.Uv(ig-1).inverse();
+                ep.m_J = J/pt.m_gen.Jv(ig-1);
+                if (fp) fp->SetPreStretch(pt.m_gen.Uv(ig-1));
             }
             else {
                 ep.m_F = F;
@@ -591,11 +601,14 @@ void FEUncoupledReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& m
     
     mat3ds D = ep.RateOfDeformation();
     
+    // merge generations to respect the maximum number of generations and the merge tolerance
+    MergeGenerations(mp, D);
+    
     // keep safe copy of deformation gradient
     mat3d F = ep.m_F;
     double J = ep.m_J;
     
-    int ng = (int)pt.m_v.size();
+    int ng = pt.m_gen.size();
     m_nmax = max(m_nmax, ng);
     
     // don't cull if we have too few generations
@@ -605,23 +618,14 @@ void FEUncoupledReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& m
     if (ng < m_nmax) return;
 
     // always check oldest generation
-    ep.m_F = pt.m_Uv[0];
-    ep.m_J = pt.m_Jv[0];
+    ep.m_F = pt.m_gen.Uv(0);
+    ep.m_J = pt.m_gen.Jv(0);
     double w0 = BreakingBondMassFraction(mp, 0, D);
     if (w0 < m_wmin) {
-        ep.m_F = pt.m_Uv[1];
-        ep.m_J = pt.m_Jv[1];
+        ep.m_F = pt.m_gen.Uv(1);
+        ep.m_J = pt.m_gen.Jv(1);
         double w1 = BreakingBondMassFraction(mp, 1, D);
-        pt.m_v[1] = (w0*pt.m_v[0] + w1*pt.m_v[1])/(w0+w1);
-        pt.m_Uv[1] = (pt.m_Uv[0]*w0 + pt.m_Uv[1]*w1)/(w0+w1);
-        pt.m_Jv[1] = pt.m_Uv[1].det();
-        pt.m_f[1] = (w0*pt.m_f[0] + w1*pt.m_f[1])/(w0+w1);
-        pt.m_wv[1] = (w0*pt.m_wv[0] + w1*pt.m_wv[1])/(w0+w1);
-        pt.m_Uv.pop_front();
-        pt.m_Jv.pop_front();
-        pt.m_v.pop_front();
-        pt.m_f.pop_front();
-        pt.m_wv.pop_front();
+        pt.m_gen.merge(0, w0, w1);
     }
     
     // restore safe copy of deformation gradient
@@ -631,6 +635,76 @@ void FEUncoupledReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& m
     return;
 }
 
+//-----------------------------------------------------------------------------
+//! Merge pairs of breaking generations while the number of generations exceeds
+//! the maximum, or while a pair can be merged with an error below the merge tolerance.
+//! The pair with the smallest merge error is merged first. The most recent generation
+//! is never merged, since it is still reforming.
+void FEUncoupledReactiveViscoelasticMaterial::MergeGenerations(FEMaterialPoint& mp, const mat3ds& D)
+{
+    if ((m_gmax == 0) && (m_gtol <= 0)) return;
+    
+    // get the elastic material point data
+    FEElasticMaterialPoint& ep = *mp.ExtractData<FEElasticMaterialPoint>();
+    
+    // get the reactive viscoelastic point data
+    FEReactiveVEMaterialPoint& pt = *mp.ExtractData<FEReactiveVEMaterialPoint>();
+    
+    // keep safe copy of deformation gradient
+    mat3d F = ep.m_F;
+    double J = ep.m_J;
+    
+    while (pt.m_gen.size() > 2)
+    {
+        int ng = pt.m_gen.size();
+        
+        // find the pair of breaking generations with the smallest merge error
+        int imin = -1;
+        double emin = 0, wmin0 = 0, wmin1 = 0;
+        ep.m_F = pt.m_gen.Uv(0);
+        ep.m_J = pt.m_gen.Jv(0);
+        double w0 = BreakingBondMassFraction(mp, 0, D);
+        for (int ig=0; ig<ng-2; ++ig) {
+            ep.m_F = pt.m_gen.Uv(ig+1);
+            ep.m_J = pt.m_gen.Jv(ig+1);
+            double w1 = BreakingBondMassFraction(mp, ig+1, D);
+            double e = pt.m_gen.mergeError(ig, w0, w1);
+            if ((imin == -1) || (e < emin)) {
+                imin = ig;
+                emin = e;
+                wmin0 = w0;
+                wmin1 = w1;
+            }
+            w0 = w1;
+        }
+        
+        if (((m_gmax > 0) && (ng > m_gmax)) || (emin < m_gtol))
+        {
+            double v1 = pt.m_gen.v(imin+1);
+            pt.m_gen.merge(imin, wmin0, wmin1);
+            
+            // make sure the merged generation carries the bond mass fraction of both generations
+            if (m_btype == 1) {
+                ep.m_F = pt.m_gen.Uv(imin);
+                ep.m_J = pt.m_gen.Jv(imin);
+                double w = BreakingBondMassFraction(mp, imin, D);
+                if (w > 0) pt.m_gen.f(imin) *= (wmin0 + wmin1)/w;
+            }
+            else {
+                // the merged generation breaks from the start of the older generation
+                // to the start of the more recent one
+                pt.m_gen.v(imin) = v1;
+            }
+        }
+        else
+            break;
+    }
+    
+    // restore safe copy of deformation gradient
+    ep.m_F = F;
+    ep.m_J = J;
+}
+
 //-----------------------------------------------------------------------------
 //! Update specialized material points
 void FEUncoupledReactiveViscoelasticMaterial::UpdateSpecializedMaterialPoints(FEMaterialPoint& mp, const FETimeInfo& tp)
@@ -652,38 +726,37 @@ void FEUncoupledReactiveViscoelasticMaterial::UpdateSpecializedMaterialPoints(FE
     double Jv = ep.m_J;
 
     // if new generation not already created for current time, check if it should
-    if (pt.m_v.empty() || (pt.m_v.back() < tp.currentTime)) {
+    int ng = pt.m_gen.size();
+    if ((ng == 0) || (pt.m_gen.v(ng-1) < tp.currentTime)) {
         // check if the current deformation gradient is different from that of
         // the last generation, in which case store the current state
         if (NewGeneration(wb)) {
-            pt.m_v.push_back(tp.currentTime);
-            pt.m_Uv.push_back(Uv);
-            pt.m_Jv.push_back(Jv);
-            double f = (!pt.m_v.empty()) ? ReformingBondMassFraction(wb) : 1;
-            pt.m_f.push_back(f);
+            // the reforming bond mass fraction is evaluated with the weak bond mass fraction of the previous generation
+            pt.m_gen.push_back(Uv, Jv, tp.currentTime, 1, (ng > 0) ? pt.m_gen.wv(ng-1) : 1);
+            pt.m_gen.f(ng) = ReformingBondMassFraction(wb);
             if (m_pWCDF) {
                 pt.m_Et = ScalarStrain(wb);
                 if (pt.m_Et > pt.m_Em)
-                    pt.m_wv.push_back(m_pWCDF->cdf(mp,pt.m_Et));
+                    pt.m_gen.wv(ng) = m_pWCDF->cdf(mp,pt.m_Et);
                 else
-                    pt.m_wv.push_back(m_pWCDF->cdf(mp,pt.m_Em));
+                    pt.m_gen.wv(ng) = m_pWCDF->cdf(mp,pt.m_Em);
             }
-            else pt.m_wv.push_back(1);
+            else pt.m_gen.wv(ng) = 1;
             CullGenerations(wb);
         }
     }
     // otherwise, if we already have a generation for the current time, update the stored values
-    else if (pt.m_v.back() == tp.currentTime) {
-        pt.m_Uv.back() = Uv;
-        pt.m_Jv.back() = Jv;
+    else if (pt.m_gen.v(ng-1) == tp.currentTime) {
+        pt.m_gen.Uv(ng-1) = Uv;
+        pt.m_gen.Jv(ng-1) = Jv;
         if (m_pWCDF) {
             pt.m_Et = ScalarStrain(wb);
             if (pt.m_Et > pt.m_Em)
-                pt.m_wv.back() = m_pWCDF->cdf(mp,pt.m_Et);
+                pt.m_gen.wv(ng-1) = m_pWCDF->cdf(mp,pt.m_Et);
             else
-                pt.m_wv.back() = m_pWCDF->cdf(mp,pt.m_Em);
+                pt.m_gen.wv(ng-1) = m_pWCDF->cdf(mp,pt.m_Em);
         }
-        pt.m_f.back() = ReformingBondMassFraction(wb);
+        pt.m_gen.f(ng-1) = ReformingBondMassFraction(wb);
     }
 }
 
@@ -697,7 +770,7 @@ int FEUncoupledReactiveViscoelasticMaterial::RVEGenerations(FEMaterialPoint& mp)
     FEReactiveVEMaterialPoint& pt = *wb.ExtractData<FEReactiveVEMaterialPoint>();
     
     // return the bond mass fraction of the reforming generation
-    return (int)pt.m_v.size();
+    return pt.m_gen.size();
 }
 
 //-----------------------------------------------------------------------------
@@ -78,6 +78,9 @@ public:
     //! cull generations
     void CullGenerations(FEMaterialPoint& pt);
     
+    //! merge generations to limit their number, or when the merge error is small
+    void MergeGenerations(FEMaterialPoint& pt, const mat3ds& D);
+    
     //! evaluate bond mass fraction for a given generation
     double BreakingBondMassFraction(FEMaterialPoint& pt, const int ig, const mat3ds D);
     
@@ -121,6 +124,8 @@ public:
     int     m_btype;    //!< bond kinetics type
     int     m_ttype;    //!< bond breaking trigger type
     double  m_emin;     //!< strain threshold for triggering new generation
+    int     m_gmax;     //!< maximum number of generations at a point (0 = no limit)
+    double  m_gtol;     //!< merge tolerance for generations
 
     int     m_nmax;     //!< highest number of generations achieved in analysis
     
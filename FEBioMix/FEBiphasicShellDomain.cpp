@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FECore/FESolidDomain.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 FEBiphasicShellDomain::FEBiphasicShellDomain(FEModel* pfem) : FESSIShellDomain(pfem), FEBiphasicDomain(pfem), m_dof(pfem)
@@ -203,16 +204,16 @@ void FEBiphasicShellDomain::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 8*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForce(el, fe);
@@ -321,16 +322,16 @@ void FEBiphasicShellDomain::InternalForcesSS(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 8*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForceSS(el, fe);
@@ -438,15 +439,15 @@ void FEBiphasicShellDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         int neln = el.Nodes();
         int ndof = neln*8;
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementBiphasicStiffness(el, ke, bsymm);
         
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -467,15 +468,15 @@ void FEBiphasicShellDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         int neln = el.Nodes();
         int ndof = neln*8;
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementBiphasicStiffnessSS(el, ke, bsymm);
         
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -956,15 +957,15 @@ void FEBiphasicShellDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 #pragma omp parallel for
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 8*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // apply body forces
         ElementBodyForce(BF, el, fe);
@@ -1055,10 +1056,10 @@ void FEBiphasicShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         FEShellElement& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int neln = el.Nodes();
         int ndof = 8*neln;
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         ke.zero();
         
         // calculate inertial stiffness
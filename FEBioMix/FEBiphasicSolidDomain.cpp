@@ -35,6 +35,7 @@ SOFTWARE.*/
 #include <FEBioMech/FEBioMech.h>
 #include <FECore/FELinearSystem.h>
 #include "FEBioMix.h"
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 FEBiphasicSolidDomain::FEBiphasicSolidDomain(FEModel* pfem) : FESolidDomain(pfem), FEBiphasicDomain(pfem), m_dofU(pfem), m_dofSU(pfem), m_dofR(pfem), m_dof(pfem)
@@ -266,9 +267,9 @@ void FEBiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 	#pragma omp parallel for shared (NE)
 	for (int i=0; i<NE; ++i)
 	{
-		// element force vector
-		vector<double> fe;
-		vector<int> lm;
+		// scratch buffers for the element force vector and LM vector
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<int>& lm = scratch.LM();
 		
 		// get the element
 		FESolidElement& el = m_Elem[i];
@@ -278,7 +279,7 @@ void FEBiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 
 		// get the element force vector and initialize it to zero
 		int ndof = 4*nel_d;
-		fe.assign(ndof, 0);
+		vector<double>& fe = scratch.Vector(ndof);
 
 		// calculate internal force vector
 		ElementInternalForce(el, fe);
@@ -392,16 +393,16 @@ void FEBiphasicSolidDomain::InternalForcesSS(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 4*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForceSS(el, fe);
@@ -506,17 +507,14 @@ void FEBiphasicSolidDomain::ElementInternalForceSS(FESolidElement& el, vector<do
 void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 {
 	// repeat over all solid elements
-	int NE = (int)m_Elem.size();
-    
-    #pragma omp parallel for shared(NE)
-	for (int iel=0; iel<NE; ++iel)
+	ParallelAssemble(LS, [&](int iel)
 	{
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = el.Nodes()*4;
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 		
 		// calculate the element stiffness matrix
 		ElementBiphasicStiffness(el, ke, bsymm);
@@ -526,30 +524,27 @@ void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 		// have to create a new lm array and place the equation numbers in the right order.
 		// What we really ought to do is fix the UnpackLM function so that it returns
 		// the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------
 void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 {
 	// repeat over all solid elements
-	int NE = (int)m_Elem.size();
-
-	#pragma omp parallel for shared(NE)
-	for (int iel=0; iel<NE; ++iel)
+	ParallelAssemble(LS, [&](int iel)
 	{
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int ndof = el.Nodes()*4;
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 		
 		// calculate the element stiffness matrix
 		ElementBiphasicStiffnessSS(el, ke, bsymm);
@@ -559,13 +554,13 @@ void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 		// have to create a new lm array and place the equation numbers in the right order.
 		// What we really ought to do is fix the UnpackLM function so that it returns
 		// the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
 		// assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------
@@ -1030,11 +1025,10 @@ void FEBiphasicSolidDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
         int neln = el.Nodes();
         int ndof = 4*neln;
-        ke.resize(ndof, ndof);
-        ke.zero();
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate inertial stiffness
         ElementBodyForceStiffness(bf, el, ke);
@@ -1044,7 +1038,7 @@ void FEBiphasicSolidDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         // have to create a new lm array and place the equation numbers in the right order.
         // What we really ought to do is fix the UnpackLM function so that it returns
         // the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
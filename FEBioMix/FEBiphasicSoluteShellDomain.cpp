@@ -35,6 +35,7 @@ SOFTWARE.*/
 #include "FECore/DOFS.h"
 #include <FECore/FELinearSystem.h>
 #include "FEBiphasicAnalysis.h"
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 FEBiphasicSoluteShellDomain::FEBiphasicSoluteShellDomain(FEModel* pfem) : FESSIShellDomain(pfem), FEBiphasicSoluteDomain(pfem), m_dof(pfem)
@@ -310,16 +311,16 @@ void FEBiphasicSoluteShellDomain::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 10*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForce(el, fe);
@@ -439,16 +440,16 @@ void FEBiphasicSoluteShellDomain::InternalForcesSS(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 10*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForceSS(el, fe);
@@ -564,18 +565,18 @@ void FEBiphasicSoluteShellDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         
         // allocate stiffness matrix
         int neln = el.Nodes();
         int ndof = neln*10;
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementBiphasicSoluteStiffness(el, ke, bsymm);
 
 		// get lm vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -598,16 +599,16 @@ void FEBiphasicSoluteShellDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsy
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementScratch& scratch = FEElementScratch::Get();
         int neln = el.Nodes();
         int ndof = neln*10;
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementBiphasicSoluteStiffnessSS(el, ke, bsymm);
 
 		// get lm vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -35,6 +35,7 @@ SOFTWARE.*/
 #include "FECore/DOFS.h"
 #include <FEBioMech/FEBioMech.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 #ifndef SQR
 #define SQR(x) ((x)*(x))
@@ -579,16 +580,16 @@ void FEMultiphasicShellDomain::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = ndpn*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForce(el, fe);
@@ -752,16 +753,16 @@ void FEMultiphasicShellDomain::InternalForcesSS(FEGlobalVector& R)
 #pragma omp parallel for
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FEShellElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = ndpn*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForceSS(el, fe);
@@ -919,16 +920,16 @@ void FEMultiphasicShellDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		int neln = el.Nodes();
         int ndof = neln*ndpn;
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementMultiphasicStiffness(el, ke, bsymm);
 
 		// get lm vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -954,15 +955,15 @@ void FEMultiphasicShellDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
         int neln = el.Nodes();
         int ndof = neln*ndpn;
-        ke.resize(ndof, ndof);
+        FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
         
         // calculate the element stiffness matrix
         ElementMultiphasicStiffnessSS(el, ke, bsymm);
 
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -789,6 +789,8 @@ void FESlidingInterfaceBiphasic::ProjectSurface(FESlidingSurfaceBiphasic& ss, FE
     FENormalProjection np(ms);
     np.SetTolerance(m_stol);
     np.SetSearchRadius(m_srad);
+    np.SetSearchTree(ms.GetSearchTree());
+    np.SetNeighborList(ms.GetFacetNeighbors());
     np.Init();
     double psf = GetPenaltyScaleFactor();
     
@@ -816,6 +818,7 @@ void FESlidingInterfaceBiphasic::ProjectSurface(FESlidingSurfaceBiphasic& ss, FE
         for (int i=0; i<NN; ++i) normal[i].unit();
         
         // loop over all nodes
+#pragma omp parallel for schedule(dynamic)
         for (int i=0; i<NN; ++i)
         {
             FENode& node = ss.Node(i);
@@ -894,8 +897,9 @@ void FESlidingInterfaceBiphasic::ProjectSurface(FESlidingSurfaceBiphasic& ss, FE
                 }
             }
             
-            // find the intersection point with the secondary surface
-            if (pme == 0 && bupseg) pme = np.Project(r, nu, rs);
+            // find the intersection point with the secondary surface,
+            // starting the search from the previous facet
+            if (pme == 0 && bupseg) pme = np.ProjectFrom(pt.m_pme, r, nu, rs);
             
             pt.m_pme = pme;
             pt.m_nu = nu;
@@ -1063,8 +1067,10 @@ void FESlidingInterfaceBiphasic::Update()
             FENormalProjection np(ss);
             np.SetTolerance(m_stol);
             np.SetSearchRadius(m_srad);
+            np.SetSearchTree(ss.GetSearchTree());
             np.Init();
             
+#pragma omp parallel for schedule(dynamic)
             for (int n=0; n<ms.Nodes(); ++n)
             {
                 // get the node
@@ -1444,11 +1450,6 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
 {
     const int MN = FEElement::MAX_NODES;
     
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    double N[4*MN*2];
-    
     m_ss.m_Ft = vec3d(0,0,0);
     m_ms.m_Ft = vec3d(0,0,0);
     
@@ -1465,9 +1466,20 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
         FESlidingSurfaceBiphasic& ss = (np == 0? m_ss : m_ms);
         FESlidingSurfaceBiphasic& ms = (np == 0? m_ms : m_ss);
         
+        // contact forces of each primary element, summed after the loop
+        // so that the totals do not depend on the thread scheduling
+        int NE = ss.Elements();
+        vector<vec3d> Fs(NE, vec3d(0,0,0)), Fm(NE, vec3d(0,0,0));
+        
         // loop over all primary surface elements
-        for (int i=0; i<ss.Elements(); ++i)
+#pragma omp parallel for schedule(static) shared(NE)
+        for (int i=0; i<NE; ++i)
         {
+            vector<int> sLM, mLM, LM, en;
+            vector<double> fe;
+            double detJ[MN], w[MN], *Hs, Hm[MN];
+            double N[4*MN*2];
+            
             // get the surface element
             FESurfaceElement& se = ss.Element(i);
             
@@ -1578,10 +1590,10 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
                         
                         // calculate contact forces
                         for (int k=0; k<nseln; ++k)
-                            ss.m_Ft += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
+                            Fs[i] += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
                         
                         for (int k = 0; k<nmeln; ++k)
-                            ms.m_Ft += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                            Fm[i] += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
                         
                         // assemble the global residual
                         R.Assemble(en, LM, fe);
@@ -1617,6 +1629,12 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
                 }
             }
         }
+        
+        for (int i=0; i<NE; ++i)
+        {
+            ss.m_Ft += Fs[i];
+            ms.m_Ft += Fm[i];
+        }
     }
 }
 
@@ -1628,11 +1646,6 @@ void FESlidingInterfaceBiphasic::StiffnessMatrix(FELinearSystem& LS, const FETim
     
     const int MN = FEElement::MAX_NODES;
     
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    double N[4*MN*2];
-    vector<int> sLM, mLM, LM, en;
-    FEElementMatrix ke;
-    
     FEModel& fem = *GetFEModel();
     
     double psf = GetPenaltyScaleFactor();
@@ -1648,8 +1661,13 @@ void FESlidingInterfaceBiphasic::StiffnessMatrix(FELinearSystem& LS, const FETim
         FEMesh& mesh = *ms.GetMesh();
         
         // loop over all primary elements
-        for (int i=0; i<ss.Elements(); ++i)
+        ParallelAssemble(LS, ss, [&](int i)
         {
+            double detJ[MN], w[MN], *Hs, Hm[MN];
+            double N[4*MN*2];
+            vector<int> sLM, mLM, LM, en;
+            FEElementMatrix ke;
+            
             // get the primary element
             FESurfaceElement& se = ss.Element(i);
             
@@ -2261,7 +2279,7 @@ void FESlidingInterfaceBiphasic::StiffnessMatrix(FELinearSystem& LS, const FETim
                     }
                 }
             }
-        }
+        });
     }
 }
 
@@ -1092,17 +1092,9 @@ double FESlidingInterfaceMP::AutoConcentrationPenalty(FESurfaceElement& el,
 void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfaceMP& ms, bool bupseg, bool bmove)
 {
     FEMesh& mesh = GetFEModel()->GetMesh();
-    FESurfaceElement* pme;
-    vec3d r, nu;
-    double rs[2] = {0,0};
-    double Ln;
     
     const int MN = FEElement::MAX_NODES;
     int nsol = (int)m_sid.size();
-    double ps[MN], p1 = 0.0;
-    vector< vector<double> > cs(nsol, vector<double>(MN));
-    vector<double> c1(nsol);
-    c1.assign(nsol,0);
     
     double psf = GetPenaltyScaleFactor();
     
@@ -1110,6 +1102,8 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
     FENormalProjection np(ms);
     np.SetTolerance(m_stol);
     np.SetSearchRadius(m_srad);
+    np.SetSearchTree(ms.GetSearchTree());
+    np.SetNeighborList(ms.GetFacetNeighbors());
     np.Init();
     
     // if we need to project the nodes onto the secondary surface,
@@ -1136,6 +1130,7 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
         for (int i=0; i<NN; ++i) normal[i].unit();
         
         // loop over all nodes
+#pragma omp parallel for schedule(dynamic)
         for (int i=0; i<NN; ++i)
         {
             FENode& node = ss.Node(i);
@@ -1165,12 +1160,15 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
     }
     
     // loop over all integration points
-    // TODO: commenting this pragma line made my code recover slidingelastic test case results
-//#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
     for (int i=0; i<ss.Elements(); ++i)
     {
         FESurfaceElement& el = ss.Element(i);
         
+        double ps[MN], p1 = 0.0;
+        vector< vector<double> > cs(nsol, vector<double>(MN));
+        vector<double> c1(nsol, 0.0);
+        
         bool sporo = ss.m_bporo;
         
         int ne = el.Nodes();
@@ -1192,7 +1190,7 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
             FESlidingSurfaceMP::Data& pt = static_cast<FESlidingSurfaceMP::Data&>(*el.GetMaterialPoint(j));
 
             // calculate the global position of the integration point
-            r = ss.Local2Global(el, j);
+            vec3d r = ss.Local2Global(el, j);
             
             // get the pressure at the integration point
             if (sporo) p1 = el.eval(ps, j);
@@ -1201,10 +1199,11 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
             for (int isol=0; isol<nsol; ++isol) c1[isol] = el.eval(&cs[isol][0], j);
             
             // calculate the normal at this integration point
-            nu = ss.SurfaceNormal(el, j);
+            vec3d nu = ss.SurfaceNormal(el, j);
             
             // first see if the old intersected face is still good enough
-            pme = pt.m_pme;
+            FESurfaceElement* pme = pt.m_pme;
+            double rs[2] = {0,0};
             if (pme)
             {
                 double g;
@@ -1221,8 +1220,9 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
                 }
             }
             
-            // find the intersection point with the secondary surface
-            if (pme == 0 && bupseg) pme = np.Project(r, nu, rs);
+            // find the intersection point with the secondary surface,
+            // starting the search from the previous facet
+            if (pme == 0 && bupseg) pme = np.ProjectFrom(pt.m_pme, r, nu, rs);
             
             pt.m_pme = pme;
             pt.m_nu = nu;
@@ -1241,7 +1241,7 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
                 
                 double eps = m_epsn*pt.m_epsn*psf;
                 
-                Ln = pt.m_Lmd + eps*g;
+                double Ln = pt.m_Lmd + eps*g;
                 
                 pt.m_gap = (g <= m_srad? g : 0);
                 
@@ -1321,8 +1321,6 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
 
 void FESlidingInterfaceMP::Update()
 {
-    double rs[2]={0,0};
-    
     FEModel& fem = *GetFEModel();
     
     // get number of DOFS
@@ -1407,6 +1405,7 @@ void FESlidingInterfaceMP::Update()
         FENormalProjection project(ss);
         project.SetTolerance(m_stol);
         project.SetSearchRadius(m_srad);
+        project.SetSearchTree(ss.GetSearchTree());
         project.Init();
 
         // loop over all the nodes of the primary surface
@@ -1431,12 +1430,14 @@ void FESlidingInterfaceMP::Update()
         // the secondary surface is trickier since we need
         // to look at the primary's surface projection
         if (ms.m_bporo) {
+#pragma omp parallel for schedule(dynamic)
             for (int n=0; n<ms.Nodes(); ++n)
             {
                 // get the node
                 FENode& node = ms.Node(n);
                 
                 // project it onto the primary surface
+                double rs[2] = {0,0};
                 FESurfaceElement* pse = project.Project(node.m_rt, ms.m_nn[n], rs);
                 
                 if (pse)
@@ -1836,11 +1837,7 @@ vec3d FESlidingInterfaceMP::ContactTraction(FESlidingSurfaceMP& ss, const int ne
 //-----------------------------------------------------------------------------
 void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
     const int MN = FEElement::MAX_NODES;
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    double N[MN*10];
     int nsol = (int)m_sid.size();
     
     FEModel& fem = *GetFEModel();
@@ -1862,9 +1859,20 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
         FESlidingSurfaceMP& ms = (np == 0? m_ms : m_ss);
         vector<int>& sl = (np == 0? m_ssl : m_msl);
         
+        // contact forces of each primary element, summed after the loop
+        // so that the totals do not depend on the thread scheduling
+        int NE = ss.Elements();
+        vector<vec3d> Fs(NE, vec3d(0,0,0)), Fm(NE, vec3d(0,0,0));
+        
         // loop over all primary surface elements
-        for (int i=0; i<ss.Elements(); ++i)
+#pragma omp parallel for schedule(static) shared(NE)
+        for (int i=0; i<NE; ++i)
         {
+            vector<int> sLM, mLM, LM, en;
+            vector<double> fe;
+            double detJ[MN], w[MN], *Hs, Hm[MN];
+            double N[MN*10];
+            
             // get the surface element
             FESurfaceElement& se = ss.Element(i);
             
@@ -1974,10 +1982,10 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
                         
                         // calculate contact forces
                         for (int k=0; k<nseln; ++k)
-                            ss.m_Ft += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
+                            Fs[i] += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
                         
                         for (int k = 0; k<nmeln; ++k)
-                            ms.m_Ft += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                            Fm[i] += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
                         
                         // assemble the global residual
                         R.Assemble(en, LM, fe);
@@ -2043,19 +2051,20 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
                 }
             }
         }
+        
+        for (int i=0; i<NE; ++i)
+        {
+            ss.m_Ft += Fs[i];
+            ms.m_Ft += Fm[i];
+        }
     }
 }
 
 //-----------------------------------------------------------------------------
 void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-    int i, j, k, l;
-    vector<int> sLM, mLM, LM, en;
     const int MN = FEElement::MAX_NODES;
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    FEElementMatrix ke;
     int nsol = (int)m_sid.size();
-    vector<double> jn(nsol);
     
     FEModel& fem = *GetFEModel();
      
@@ -2090,8 +2099,14 @@ void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
         vector<int>& sl = (np == 0? m_ssl : m_msl);
         
         // loop over all primary surface elements
-        for (i=0; i<ss.Elements(); ++i)
+        ParallelAssemble(LS, ss, [&](int i)
         {
+            int j, k, l;
+            vector<int> sLM, mLM, LM, en;
+            double detJ[MN], w[MN], *Hs, Hm[MN];
+            FEElementMatrix ke;
+            vector<double> jn(nsol);
+            
             // get the next element
             FESurfaceElement& se = ss.Element(i);
             
@@ -2766,7 +2781,7 @@ void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
                     }
                 }
             }
-        }
+        });
     }
 }
 
@@ -476,6 +476,7 @@ void FETiedBiphasicInterface::InitialProjection(FETiedBiphasicSurface& ss, FETie
 	FENormalProjection np(ms);
 	np.SetTolerance(m_stol);
 	np.SetSearchRadius(m_srad);
+	np.SetSearchTree(ms.GetSearchTree());
 	np.Init();
 	
 	// loop over all integration points
@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include "FECore/DOFS.h"
 #include <FEBioMech/FEBioMech.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementScratch.h>
 
 #ifndef SQR
 #define SQR(x) ((x)*(x))
@@ -305,16 +306,16 @@ void FETriphasicDomain::InternalForces(FEGlobalVector& R)
 	#pragma omp parallel for shared (NE)
 	for (int i=0; i<NE; ++i)
 	{
-		// element force vector
-		vector<double> fe;
-		vector<int> lm;
+		// scratch buffers for the element force vector and LM vector
+		FEElementScratch& scratch = FEElementScratch::Get();
+		vector<int>& lm = scratch.LM();
 		
 		// get the element
 		FESolidElement& el = m_Elem[i];
 
 		// get the element force vector and initialize it to zero
 		int ndof = 6*el.Nodes();
-		fe.assign(ndof, 0);
+		vector<double>& fe = scratch.Vector(ndof);
 
 		// calculate internal force vector
 		ElementInternalForce(el, fe);
@@ -425,16 +426,16 @@ void FETriphasicDomain::InternalForcesSS(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // scratch buffers for the element force vector and LM vector
+        FEElementScratch& scratch = FEElementScratch::Get();
+        vector<int>& lm = scratch.LM();
         
         // get the element
         FESolidElement& el = m_Elem[i];
         
         // get the element force vector and initialize it to zero
         int ndof = 6*el.Nodes();
-        fe.assign(ndof, 0);
+        vector<double>& fe = scratch.Vector(ndof);
         
         // calculate internal force vector
         ElementInternalForceSS(el, fe);
@@ -536,18 +537,18 @@ void FETriphasicDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 
-		// get the lm vector
-		vector<int> lm;
-		UnpackLM(el, lm);
-		ke.SetIndices(lm);
-		
 		// allocate stiffness matrix
 		int neln = el.Nodes();
 		int ndpn = 6;
 		int ndof = neln*ndpn;
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
+
+		// get the lm vector
+		vector<int>& lm = scratch.LM();
+		UnpackLM(el, lm);
+		ke.SetIndices(lm);
 		
 		// calculate the element stiffness matrix
 		ElementTriphasicStiffness(el, ke, bsymm);
@@ -569,19 +570,19 @@ void FETriphasicDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 
 		// allocate stiffness matrix
 		int neln = el.Nodes();
 		int ndpn = 6;
 		int ndof = neln*ndpn;
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 		
 		// calculate the element stiffness matrix
 		ElementTriphasicStiffnessSS(el, ke, bsymm);
 
 		//  get the lm vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include <FECore/FEMesh.h>
 #include <FECore/FEGlobalMatrix.h>
 #include <FECore/log.h>
+#include <FECore/FEElementScratch.h>
 
 //-----------------------------------------------------------------------------
 // helper function for comparing two facets
@@ -1022,18 +1023,18 @@ void FEElasticSolidDomain2O::StiffnessMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementScratch& scratch = FEElementScratch::Get();
 		
 		// create the element's stiffness matrix
 		int ndof = 3*el.Nodes();
-		ke.resize(ndof, ndof);
+		FEElementMatrix& ke = scratch.Matrix(el, ndof, ndof);
 		ke.zero();
 
 		// calculate element stiffness
 		ElementStiffness(tp, iel, ke);
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = scratch.LM();
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -0,0 +1,151 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBatchStiffnessDiagnostic.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/Timer.h>
+#include <FECore/log.h>
+#include <FEBioMech/FEElasticSolidDomain.h>
+#include <math.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+FEBatchStiffnessDiagnostic::FEBatchStiffnessDiagnostic(FEModel* fem) : FECoreTask(fem)
+{
+	m_fp = nullptr;
+	m_bdone = false;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBatchStiffnessDiagnostic::Init(const char* szarg)
+{
+	return GetFEModel()->Init();
+}
+
+//-----------------------------------------------------------------------------
+bool batch_stiffness_diagnostic_cb(FEModel* fem, unsigned int when, void* pd)
+{
+	FEBatchStiffnessDiagnostic* diagnostic = (FEBatchStiffnessDiagnostic*)pd;
+	return diagnostic->Diagnose();
+}
+
+//-----------------------------------------------------------------------------
+bool FEBatchStiffnessDiagnostic::Run()
+{
+	FEModel& fem = *GetFEModel();
+
+	fem.AddCallback(batch_stiffness_diagnostic_cb, CB_MATRIX_REFORM, (void*)this);
+
+	m_fp = fopen("diagnostic.log", "wt");
+	fprintf(m_fp, "FEBio Batch Stiffness Diagnostics:\n");
+	fprintf(m_fp, "==================================\n");
+
+	fem.BlockLog();
+	bool bret = fem.Solve();
+	fem.UnBlockLog();
+	if (bret == false)
+	{
+		feLogError("FEBio error terminated. Aborting diagnostic.\n");
+	}
+	else fprintf(m_fp, "diagnostic completed.\n");
+
+	fclose(m_fp);
+	m_fp = nullptr;
+
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+// Calculate the material stiffness of all elements with both kernels and compare.
+bool FEBatchStiffnessDiagnostic::Diagnose()
+{
+	// we only need to do this once
+	if (m_bdone) return true;
+	m_bdone = true;
+
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	const int W = FEElasticSolidDomain::STIFFNESS_BATCH;
+	for (int nd = 0; nd < mesh.Domains(); ++nd)
+	{
+		FEElasticSolidDomain* dom = dynamic_cast<FEElasticSolidDomain*>(&mesh.Domain(nd));
+		if ((dom == nullptr) || (dom->ElementKernel() == FE_ELEM_INVALID_TYPE)) continue;
+
+		const int NE = dom->Elements();
+		const int ndof = 3 * dom->Element(0).Nodes();
+		const int nn = ndof*ndof;
+
+		matrix ke[W];
+		for (int l = 0; l < W; ++l) ke[l].resize(ndof, ndof);
+		std::vector<double> Kb(nn*W);
+
+		Timer tref, tbatch;
+		double max_err = 0.0, max_k = 0.0;
+		int elemList[W];
+		for (int i = 0; i < NE; i += W)
+		{
+			int nel = (i + W <= NE ? W : NE - i);
+			for (int l = 0; l < nel; ++l) elemList[l] = i + l;
+
+			// element-by-element kernel
+			tref.start();
+			for (int l = 0; l < nel; ++l)
+			{
+				ke[l].zero();
+				dom->ElementMaterialStiffness(dom->Element(i + l), ke[l]);
+			}
+			tref.stop();
+
+			// batched kernel
+			tbatch.start();
+			for (int k = 0; k < nn*W; ++k) Kb[k] = 0.0;
+			dom->ElementMaterialStiffnessBatch(elemList, nel, &Kb[0]);
+			tbatch.stop();
+
+			for (int l = 0; l < nel; ++l)
+			{
+				const double* pk = ke[l][0];
+				for (int k = 0; k < nn; ++k)
+				{
+					double err = fabs(pk[k] - Kb[k*W + l]);
+					if (err > max_err) max_err = err;
+					if (fabs(pk[k]) > max_k) max_k = fabs(pk[k]);
+				}
+			}
+		}
+
+		double rel_err = (max_k > 0 ? max_err / max_k : max_err);
+		fprintf(m_fp, "domain %s: %d elements of type %d\n", dom->GetName().c_str(), NE, dom->ElementKernel());
+		fprintf(m_fp, "\tmax error     : %lg (relative %lg)\n", max_err, rel_err);
+		fprintf(m_fp, "\telement kernel: %lg s\n", tref.GetTime());
+		fprintf(m_fp, "\tbatched kernel: %lg s\n", tbatch.GetTime());
+	}
+
+	return true;
+}
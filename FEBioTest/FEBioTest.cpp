@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include "FEMaterialTest.h"
 #include "FEResetTest.h"
 #include "FEStiffnessDiagnostic.h"
+#include "FEBatchStiffnessDiagnostic.h"
 
 namespace FEBioTest
 {
@@ -48,5 +49,6 @@ void InitModule()
 	REGISTER_FECORE_CLASS(FEResetTest, "reset_test");
 	REGISTER_FECORE_CLASS(FEMaterialTest, "material test");
 	REGISTER_FECORE_CLASS(FEStiffnessDiagnostic, "stiffness_test");
+	REGISTER_FECORE_CLASS(FEBatchStiffnessDiagnostic, "batch_stiffness_test");
 }
 }
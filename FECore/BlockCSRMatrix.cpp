@@ -0,0 +1,419 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "BlockCSRMatrix.h"
+#include <algorithm>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// Multiplies a BSR matrix with a vector. The block size is a compile time constant
+// so that the compiler can unroll and vectorize the block products.
+template <int BS> static void bsr_mult(int nbr, const int* pr, const int* pc, const double* pv, const double* x, double* r)
+{
+#pragma omp parallel for schedule(guided)
+	for (int I = 0; I < nbr; ++I)
+	{
+		double ri[BS] = { 0.0 };
+		for (int n = pr[I]; n < pr[I + 1]; ++n)
+		{
+			const double* a = pv + n*BS*BS;
+			const double* xj = x + pc[n]*BS;
+			for (int k = 0; k < BS; ++k)
+			{
+				double s = 0.0;
+				for (int l = 0; l < BS; ++l) s += a[k*BS + l] * xj[l];
+				ri[k] += s;
+			}
+		}
+		double* rI = r + I*BS;
+		for (int k = 0; k < BS; ++k) rI[k] = ri[k];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// same as above, but for any block size
+static void bsr_mult(int bs, int nbr, const int* pr, const int* pc, const double* pv, const double* x, double* r)
+{
+	const int bs2 = bs*bs;
+#pragma omp parallel for schedule(guided)
+	for (int I = 0; I < nbr; ++I)
+	{
+		double* rI = r + I*bs;
+		for (int k = 0; k < bs; ++k) rI[k] = 0.0;
+		for (int n = pr[I]; n < pr[I + 1]; ++n)
+		{
+			const double* a = pv + n*bs2;
+			const double* xj = x + pc[n]*bs;
+			for (int k = 0; k < bs; ++k)
+			{
+				double s = 0.0;
+				for (int l = 0; l < bs; ++l) s += a[k*bs + l] * xj[l];
+				rI[k] += s;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+BlockCSRMatrix::BlockCSRMatrix(int blockSize) : m_bs(blockSize)
+{
+	assert(m_bs > 0);
+	if (m_bs < 1) m_bs = 1;
+	m_nbr = m_nbc = 0;
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::Zero()
+{
+	std::fill(m_values.begin(), m_values.end(), 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::Clear()
+{
+	m_pointers.clear();
+	m_indices.clear();
+	m_values.clear();
+	m_nbr = m_nbc = 0;
+	SparseMatrix::Clear();
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::Create(SparseMatrixProfile& mp)
+{
+	const int nr = mp.Rows();
+	const int nc = mp.Columns();
+	const int bs = m_bs;
+
+	m_nbr = (nr + bs - 1) / bs;
+	m_nbc = (nc + bs - 1) / bs;
+
+	// The profile is stored by columns. We loop over the block columns and 
+	// visit all the block rows that have a nonzero in that block column. The tag 
+	// array makes sure each block is only visited once. Since we process the 
+	// block columns in order, the column indices of each block row end up sorted.
+	vector<int> tag(m_nbr, -1);
+	m_pointers.assign(m_nbr + 1, 0);
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		vector<int> pos;
+		if (pass == 1)
+		{
+			for (int I = 0; I < m_nbr; ++I) m_pointers[I + 1] += m_pointers[I];
+			m_indices.resize(m_pointers[m_nbr]);
+			pos.assign(m_pointers.begin(), m_pointers.end() - 1);
+			tag.assign(m_nbr, -1);
+		}
+
+		for (int JB = 0; JB < m_nbc; ++JB)
+		{
+			int j1 = std::min(nc, (JB + 1)*bs);
+			for (int j = JB*bs; j < j1; ++j)
+			{
+				SparseMatrixProfile::ColumnProfile& a = mp.Column(j);
+				int n = a.size();
+				for (int k = 0; k < n; ++k)
+				{
+					int IB0 = a[k].start / bs;
+					int IB1 = a[k].end / bs;
+					for (int IB = IB0; IB <= IB1; ++IB)
+					{
+						if (tag[IB] != JB)
+						{
+							tag[IB] = JB;
+							if (pass == 0) m_pointers[IB + 1]++;
+							else m_indices[pos[IB]++] = JB;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	int nblocks = (int)m_indices.size();
+	m_values.assign((size_t)nblocks*bs*bs, 0.0);
+
+	m_nrow = nr;
+	m_ncol = nc;
+	m_nsize = nblocks*bs*bs;
+}
+
+//-----------------------------------------------------------------------------
+int BlockCSRMatrix::findBlock(int I, int J) const
+{
+	const int* pi = &m_indices[0];
+	int n0 = m_pointers[I];
+	int n1 = m_pointers[I + 1];
+	const int* p = std::lower_bound(pi + n0, pi + n1, J);
+	if ((p == pi + n1) || (*p != J)) return -1;
+	return (int)(p - pi)*m_bs*m_bs;
+}
+
+//-----------------------------------------------------------------------------
+int BlockCSRMatrix::findSlot(int i, int j) const
+{
+	assert((i >= 0) && (i < m_nrow));
+	assert((j >= 0) && (j < m_ncol));
+	int n = findBlock(i / m_bs, j / m_bs);
+	if (n < 0) return -1;
+	return n + (i % m_bs)*m_bs + (j % m_bs);
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::Assemble(const matrix& ke, const vector<int>& lm)
+{
+	const int N = ke.rows();
+	const int bs = m_bs;
+	double* pv = &m_values[0];
+
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lm[i];
+		if (I < 0) continue;
+
+		int IB = I / bs;
+		int ii = I % bs;
+		const double* kei = ke[i];
+
+		// the dofs of a node are usually consecutive in lm, so we
+		// only need to look up the block when the block column changes
+		int JB0 = -1;
+		double* pb = nullptr;
+		for (int j = 0; j < N; ++j)
+		{
+			int J = lm[j];
+			if (J < 0) continue;
+
+			int JB = J / bs;
+			if (JB != JB0)
+			{
+				int n = findBlock(IB, JB);
+				assert(n >= 0);
+				pb = (n >= 0 ? pv + n + ii*bs : nullptr);
+				JB0 = JB;
+			}
+
+			if (pb)
+			{
+				double* pd = pb + (J % bs);
+				if (m_batomic)
+				{
+#pragma omp atomic
+					*pd += kei[j];
+				}
+				else *pd += kei[j];
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+		for (int j = 0; j < M; ++j)
+		{
+			int J = lmj[j];
+			if (J >= 0) add(I, J, ke[i][j]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool BlockCSRMatrix::check(int i, int j)
+{
+	return (findSlot(i, j) >= 0);
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::set(int i, int j, double v)
+{
+	int n = findSlot(i, j);
+	assert(n >= 0);
+	if (n >= 0)
+	{
+#pragma omp critical
+		m_values[n] = v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::add(int i, int j, double v)
+{
+	int n = findSlot(i, j);
+	assert(n >= 0);
+	if (n >= 0)
+	{
+		if (m_batomic)
+		{
+#pragma omp atomic
+			m_values[n] += v;
+		}
+		else m_values[n] += v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+double BlockCSRMatrix::get(int i, int j)
+{
+	int n = findSlot(i, j);
+	return (n >= 0 ? m_values[n] : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+double BlockCSRMatrix::diag(int i)
+{
+	int n = findSlot(i, i);
+	assert(n >= 0);
+	return (n >= 0 ? m_values[n] : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::scale(const vector<double>& L, const vector<double>& R)
+{
+	const int bs = m_bs;
+#pragma omp parallel for
+	for (int I = 0; I < m_nbr; ++I)
+	{
+		for (int n = m_pointers[I]; n < m_pointers[I + 1]; ++n)
+		{
+			double* a = &m_values[0] + (size_t)n*bs*bs;
+			int J = m_indices[n];
+			for (int k = 0; k < bs; ++k)
+			{
+				int i = I*bs + k;
+				if (i >= m_nrow) break;
+				for (int l = 0; l < bs; ++l)
+				{
+					int j = J*bs + l;
+					if (j >= m_ncol) break;
+					a[k*bs + l] *= L[i] * R[j];
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool BlockCSRMatrix::BuildScatterMap(const std::vector<int>& lm, std::vector<int>& slots)
+{
+	const int N = (int)lm.size();
+	slots.assign(N*N, -1);
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lm[i];
+		if (I < 0) continue;
+		for (int j = 0; j < N; ++j)
+		{
+			int J = lm[j];
+			if (J < 0) continue;
+			int n = findSlot(I, J);
+			if (n < 0) return false;
+			slots[i*N + j] = n;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void BlockCSRMatrix::ScatterAdd(const matrix& ke, const int* slots)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+	double* pv = &m_values[0];
+	for (int i = 0; i < N; ++i)
+	{
+		const double* kei = ke[i];
+		const int* si = slots + i*M;
+		for (int j = 0; j < M; ++j)
+		{
+			int n = si[j];
+			if (n >= 0)
+			{
+				if (m_batomic)
+				{
+#pragma omp atomic
+					pv[n] += kei[j];
+				}
+				else pv[n] += kei[j];
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool BlockCSRMatrix::mult_vector(double* x, double* r)
+{
+	if (m_nbr == 0) return true;
+
+	const int bs = m_bs;
+	const int* pr = &m_pointers[0];
+	const int* pc = &m_indices[0];
+	const double* pv = &m_values[0];
+
+	// If the matrix size is not a multiple of the block size, the last block
+	// row and column are padded, so we need padded copies of the vectors. 
+	double* px = x;
+	double* py = r;
+	vector<double> xp, rp;
+	if (m_ncol != m_nbc*bs)
+	{
+		xp.assign(m_nbc*bs, 0.0);
+		for (int i = 0; i < m_ncol; ++i) xp[i] = x[i];
+		px = &xp[0];
+	}
+	if (m_nrow != m_nbr*bs)
+	{
+		rp.resize(m_nbr*bs);
+		py = &rp[0];
+	}
+
+	switch (bs)
+	{
+	case 1: bsr_mult<1>(m_nbr, pr, pc, pv, px, py); break;
+	case 2: bsr_mult<2>(m_nbr, pr, pc, pv, px, py); break;
+	case 3: bsr_mult<3>(m_nbr, pr, pc, pv, px, py); break;
+	case 4: bsr_mult<4>(m_nbr, pr, pc, pv, px, py); break;
+	case 6: bsr_mult<6>(m_nbr, pr, pc, pv, px, py); break;
+	default:
+		bsr_mult(bs, m_nbr, pr, pc, pv, px, py);
+	}
+
+	if (py != r)
+	{
+		for (int i = 0; i < m_nrow; ++i) r[i] = py[i];
+	}
+
+	return true;
+}
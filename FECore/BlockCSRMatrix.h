@@ -0,0 +1,127 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "SparseMatrix.h"
+#include "fecore_api.h"
+
+//=============================================================================
+//! This class stores a sparse matrix in block compressed row storage (BSR)
+//! format. The matrix is partitioned in dense blocks of size bs x bs and only
+//! the nonzero blocks are stored, together with one column index per block.
+//! For vector-valued problems (e.g. 3 displacement dofs per node) this reduces
+//! the index storage by a factor of about bs^2 and allows the matrix-vector
+//! product to work on small dense blocks.
+//! Equations are grouped in blocks by their number, i.e. block row I covers
+//! the equations I*bs to (I+1)*bs - 1. The blocks therefore line up with the
+//! nodes when the equations of a node are numbered consecutively.
+//! The full matrix is stored, also for symmetric matrices.
+class FECORE_API BlockCSRMatrix : public SparseMatrix
+{
+public:
+	//! constructor
+	BlockCSRMatrix(int blockSize = 3);
+
+	//! return the block size
+	int BlockSize() const { return m_bs; }
+
+	//! return the number of block rows
+	int BlockRows() const { return m_nbr; }
+
+	//! return the number of nonzero blocks
+	int Blocks() const { return (int)m_indices.size(); }
+
+public:
+	//! zero matrix elements
+	void Zero() override;
+
+	//! Create the matrix structure from the SparseMatrixProfile
+	void Create(SparseMatrixProfile& mp) override;
+
+	//! Assemble the element matrix into the global matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! check if an entry was allocated
+	bool check(int i, int j) override;
+
+	//! set entry to value
+	void set(int i, int j, double v) override;
+
+	//! add value to entry
+	void add(int i, int j, double v) override;
+
+	//! retrieve value
+	double get(int i, int j) override;
+
+	//! get the diagonal value
+	double diag(int i) override;
+
+	//! release memory for storing data
+	void Clear() override;
+
+	//! scale matrix
+	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+	//! Build the scatter map of an element matrix
+	bool BuildScatterMap(const std::vector<int>& lm, std::vector<int>& slots) override;
+
+	//! Assemble an element matrix using a scatter map
+	void ScatterAdd(const matrix& ke, const int* slots) override;
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+public:
+	//! block row pointers (size BlockRows() + 1)
+	const int* BlockPointers() const { return &m_pointers[0]; }
+
+	//! block column indices (size Blocks())
+	const int* BlockIndices() const { return &m_indices[0]; }
+
+	//! block values (size Blocks()*bs*bs, each block stored row-wise)
+	double* BlockValues() { return &m_values[0]; }
+
+protected:
+	//! find the offset of block (I, J) in the values array, or -1 if the block is not allocated
+	int findBlock(int I, int J) const;
+
+	//! find the offset of entry (i, j) in the values array, or -1 if the entry is not allocated
+	int findSlot(int i, int j) const;
+
+private:
+	int		m_bs;		//!< block size
+	int		m_nbr;		//!< number of block rows
+	int		m_nbc;		//!< number of block columns
+
+	std::vector<int>	m_pointers;	//!< block row pointers
+	std::vector<int>	m_indices;	//!< block column indices
+	std::vector<double>	m_values;	//!< block values
+};
@@ -43,6 +43,7 @@ CompactMatrix::CompactMatrix(int offset)
 	m_offset = offset;
 
 	m_bdel = false;
+	m_snnz = -1;
 }
 
 
@@ -72,6 +73,10 @@ void CompactMatrix::Clear()
 	m_pindices = 0;
 	m_ppointers = 0;
 
+	m_sblock.clear();
+	m_sbuf.clear();
+	m_snnz = -1;
+
 	SparseMatrix::Clear();
 }
 
@@ -128,3 +133,192 @@ int CompactMatrix::bandWidth()
 
 	return kmax;
 }
+
+//-----------------------------------------------------------------------------
+// find the offset of an entry with a binary search
+// (this assumes that the indices are ordered)
+int CompactMatrix::findSlot(int outer, int inner) const
+{
+	int n0 = m_ppointers[outer] - m_offset;
+	int n1 = m_ppointers[outer + 1] - m_offset - 1;
+	inner += m_offset;
+	while (n0 <= n1)
+	{
+		int n = (n0 + n1) >> 1;
+		int m = m_pindices[n];
+		if (m == inner) return n;
+		else if (m < inner) n0 = n + 1;
+		else n1 = n - 1;
+	}
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+//! Build the scatter map for an element matrix. The scatter map is stored as a
+//! flat array of size N*N (where N = lm.size()) in row-major order.
+bool CompactMatrix::BuildScatterMap(const std::vector<int>& lm, std::vector<int>& slots)
+{
+	const int N = (int)lm.size();
+	slots.assign(N*N, -1);
+
+	bool bsymm = isSymmetric();
+	bool browBased = isRowBased();
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lm[i];
+		if (I < 0) continue;
+		for (int j = 0; j < N; ++j)
+		{
+			int J = lm[j];
+			if (J < 0) continue;
+
+			// symmetric matrices only store the lower-triangular part
+			if (bsymm && (I < J)) continue;
+
+			int n = (browBased ? findSlot(I, J) : findSlot(J, I));
+			if (n < 0) return false;
+			slots[i*N + j] = n;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! assemble an element matrix using its scatter map
+void CompactMatrix::ScatterAdd(const matrix& ke, const int* slots)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+	for (int i = 0; i < N; ++i)
+	{
+		const double* kei = ke[i];
+		const int* si = slots + i*M;
+		for (int j = 0; j < M; ++j)
+		{
+			int n = si[j];
+			if (n >= 0)
+			{
+				if (m_batomic)
+				{
+#pragma omp atomic
+					m_pd[n] += kei[j];
+				}
+				else m_pd[n] += kei[j];
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Same as ScatterAdd, but ke is symmetric and only its upper triangle is set. 
+//! Entries (i,j) below the diagonal are therefore taken from (j,i).
+void CompactMatrix::ScatterAddUpper(const matrix& ke, const int* slots)
+{
+	const int N = ke.rows();
+	for (int i = 0; i < N; ++i)
+	{
+		const int* si = slots + i*N;
+		for (int j = 0; j < N; ++j)
+		{
+			int n = si[j];
+			if (n >= 0)
+			{
+				double kij = (j >= i ? ke[i][j] : ke[j][i]);
+				if (m_batomic)
+				{
+#pragma omp atomic
+					m_pd[n] += kij;
+				}
+				else m_pd[n] += kij;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Prepare the parallel matrix-vector product of column-based formats. The columns 
+//! are divided in nthreads blocks with (roughly) the same number of nonzeroes. The blocks
+//! are only rebuilt when the thread count or the matrix structure changes.
+bool CompactMatrix::UpdateScatterBlocks(int nthreads)
+{
+	// small matrices are not worth the overhead
+	const int MIN_NONZEROES = 20000;
+
+	if (nthreads < 2) return false;
+	if (m_ppointers == nullptr) return false;
+
+	const int M = Columns();
+	const int nnz = m_ppointers[M] - m_ppointers[0];
+	if (nnz < MIN_NONZEROES) return false;
+
+	// see if we can reuse the blocks
+	if (((int)m_sblock.size() == nthreads) && (m_snnz == nnz) && (m_sblock.back().c1 == M)) return true;
+
+	bool bsymm = isSymmetric();
+
+	m_sblock.resize(nthreads);
+	int c = 0;
+	size_t off = 0;
+	for (int n = 0; n < nthreads; ++n)
+	{
+		ScatterBlock& b = m_sblock[n];
+
+		// find the column range
+		b.c0 = c;
+		if (n == nthreads - 1) c = M;
+		else
+		{
+			long long target = m_ppointers[0] + ((long long)nnz*(n + 1)) / nthreads;
+			while ((c < M) && (m_ppointers[c] < target)) ++c;
+		}
+		b.c1 = c;
+
+		// find the row range
+		b.rmin = Rows();
+		b.rmax = -1;
+		if (bsymm && (b.c1 > b.c0))
+		{
+			// the upper-triangular part is added to the rows of the columns
+			b.rmin = b.c0;
+			b.rmax = b.c1 - 1;
+		}
+		for (int i = m_ppointers[b.c0] - m_offset; i < m_ppointers[b.c1] - m_offset; ++i)
+		{
+			int r = m_pindices[i] - m_offset;
+			if (r < b.rmin) b.rmin = r;
+			if (r > b.rmax) b.rmax = r;
+		}
+		if (b.rmax < b.rmin) { b.rmin = 0; b.rmax = -1; }
+
+		b.off = off;
+		off += b.rmax - b.rmin + 1;
+	}
+	m_sbuf.resize(off);
+	m_snnz = nnz;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Combine the thread buffers of a parallel matrix-vector product into r. 
+//! Each row is reduced in block order, so that the result does not depend on the 
+//! order in which the threads finish.
+void CompactMatrix::ReduceScatterBlocks(double* r)
+{
+	const int N = Rows();
+	const int nb = (int)m_sblock.size();
+	const ScatterBlock* pb = m_sblock.data();
+	const double* buf = m_sbuf.data();
+#pragma omp for schedule(static)
+	for (int i = 0; i < N; ++i)
+	{
+		double ri = 0.0;
+		for (int n = 0; n < nb; ++n)
+		{
+			const ScatterBlock& b = pb[n];
+			if ((i >= b.rmin) && (i <= b.rmax)) ri += buf[b.off + (i - b.rmin)];
+		}
+		r[i] = ri;
+	}
+}
@@ -83,13 +83,49 @@ public:
 	//! calculate bandwidth of matrix
 	int bandWidth();
 
+public:
+	//! build the scatter map for an element matrix
+	bool BuildScatterMap(const std::vector<int>& lm, std::vector<int>& slots) override;
+
+	//! assemble an element matrix using its scatter map
+	void ScatterAdd(const matrix& ke, const int* slots) override;
+
+	//! assemble the upper triangle of a symmetric element matrix using its scatter map
+	void ScatterAddUpper(const matrix& ke, const int* slots) override;
+
+protected:
+	//! find the offset into the values array of an entry (or -1 if it is not stored).
+	//! The outer index is the row (column) and the inner index the column (row) for 
+	//! row-based (column-based) formats.
+	int findSlot(int outer, int inner) const;
+
+	//! Prepare the parallel matrix-vector product of column-based formats for nthreads threads.
+	//! Returns false if the product should be done serially.
+	bool UpdateScatterBlocks(int nthreads);
+
+	//! Combine the thread buffers of a parallel matrix-vector product into r. 
+	//! This must be called from inside the parallel region.
+	void ReduceScatterBlocks(double* r);
+
+protected:
+	// A block of consecutive columns that is processed by one thread in the parallel
+	// matrix-vector product of column-based formats. Since columns scatter into rows that 
+	// other threads may write to as well, each block writes to its own buffer, which 
+	// covers the rows rmin to rmax that the block touches. 
+	struct ScatterBlock
+	{
+		int		c0, c1;		// column range
+		int		rmin, rmax;	// row range
+		size_t	off;		// offset into buffer
+	};
+	std::vector<ScatterBlock>	m_sblock;	//!< blocks (one per thread)
+	std::vector<double>			m_sbuf;		//!< buffers of blocks
+	int							m_snnz;		//!< nr of nonzeroes when the blocks were built
+
 protected:
 	double*	m_pd;			//!< matrix values
 	int*	m_pindices;		//!< indices
 	int*	m_ppointers;	//!< pointers
 	int		m_offset;		//!< adjust array indices for fortran arrays
 	bool	m_bdel;			//!< delete data arrays in destructor
-
-protected:
-	std::vector<int>	P;
 };
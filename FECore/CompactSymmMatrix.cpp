@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactSymmMatrix.h"
+#include "sys.h"
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -38,37 +39,71 @@ CompactSymmMatrix::CompactSymmMatrix(int offset) : CompactMatrix(offset)
 }
 
 //-----------------------------------------------------------------------------
+//! Multiply with a vector. Since only the lower-triangular part is stored, each column 
+//! scatters into the rows below the diagonal. In parallel, each thread therefore processes 
+//! a block of columns into its own buffer and the buffers are summed afterwards.
 bool CompactSymmMatrix::mult_vector(double* x, double* r)
 {
 	// get row count
 	int N = Rows();
 	int M = Columns();
 
-	// zero result vector
-	for (int j = 0; j<N; ++j) r[j] = 0.0;
+	int nt = (omp_in_parallel() ? 1 : omp_get_max_threads());
+	if (UpdateScatterBlocks(nt) == false)
+	{
+		// zero result vector
+		for (int j = 0; j<N; ++j) r[j] = 0.0;
+
+		// loop over all columns
+		multColumns(x, r, 0, M, 0);
+		return true;
+	}
+
+	const int nb = (int)m_sblock.size();
+#pragma omp parallel
+	{
+		for (int n = omp_get_thread_num(); n < nb; n += omp_get_num_threads())
+		{
+			const ScatterBlock& b = m_sblock[n];
+			double* y = m_sbuf.data() + b.off;
+			for (int i = 0; i <= b.rmax - b.rmin; ++i) y[i] = 0.0;
+			multColumns(x, y, b.c0, b.c1, b.rmin);
+		}
+#pragma omp barrier
+		ReduceScatterBlocks(r);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void CompactSymmMatrix::multColumns(const double* x, double* r, int c0, int c1, int r0) const
+{
+	// we store the offset of the first row in the row indices
+	const int off = m_offset + r0;
 
 	// loop over all columns
-	for (int j = 0; j<M; ++j)
+	for (int j = c0; j<c1; ++j)
 	{
-		double* pv = m_pd + m_ppointers[j] - m_offset;
-		int* pi = m_pindices + m_ppointers[j] - m_offset;
+		const double* pv = m_pd + m_ppointers[j] - m_offset;
+		const int* pi = m_pindices + m_ppointers[j] - m_offset;
 		int n = m_ppointers[j + 1] - m_ppointers[j];
 
 		// add off-diagonal elements
 		for (int i = 1; i<n - 7; i += 8)
 		{
 			// add lower triangular element
-			r[pi[i    ] - m_offset] += pv[i    ] * x[j];
-			r[pi[i + 1] - m_offset] += pv[i + 1] * x[j];
-			r[pi[i + 2] - m_offset] += pv[i + 2] * x[j];
-			r[pi[i + 3] - m_offset] += pv[i + 3] * x[j];
-			r[pi[i + 4] - m_offset] += pv[i + 4] * x[j];
-			r[pi[i + 5] - m_offset] += pv[i + 5] * x[j];
-			r[pi[i + 6] - m_offset] += pv[i + 6] * x[j];
-			r[pi[i + 7] - m_offset] += pv[i + 7] * x[j];
+			r[pi[i    ] - off] += pv[i    ] * x[j];
+			r[pi[i + 1] - off] += pv[i + 1] * x[j];
+			r[pi[i + 2] - off] += pv[i + 2] * x[j];
+			r[pi[i + 3] - off] += pv[i + 3] * x[j];
+			r[pi[i + 4] - off] += pv[i + 4] * x[j];
+			r[pi[i + 5] - off] += pv[i + 5] * x[j];
+			r[pi[i + 6] - off] += pv[i + 6] * x[j];
+			r[pi[i + 7] - off] += pv[i + 7] * x[j];
 		}
 		for (int i = 0; i<(n - 1) % 8; ++i)
-			r[pi[n - 1 - i] - m_offset] += pv[n - 1 - i] * x[j];
+			r[pi[n - 1 - i] - off] += pv[n - 1 - i] * x[j];
 
 		// add diagonal element
 		double rj = pv[0] * x[j];
@@ -89,10 +124,8 @@ bool CompactSymmMatrix::mult_vector(double* x, double* r)
 		for (int i = 0; i<(n - 1) % 8; ++i)
 			rj += pv[n - 1 - i] * x[pi[n - 1 - i] - m_offset];
 
-		r[j] += rj;
+		r[j - r0] += rj;
 	}
-
-	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -190,6 +223,8 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 
 	// find the permutation array that sorts LM in ascending order
 	// we can use this to speed up the row search (i.e. loop over n below)
+	// (the buffer is thread-local since elements may be assembled concurrently)
+	static thread_local std::vector<int> P;
 	P.resize(N);
 	qsort(N, &LM[0], &P[0]);
 
@@ -221,14 +256,73 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == I)
 				{
-					#pragma omp atomic
-					pm[n] += ke[i][j];
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pm[n] += ke[i][j];
+					}
+					else pm[n] += ke[i][j];
 					break;
 				}
 		}
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Same as Assemble, but only the upper triangle of the symmetric matrix ke is set.
+//! Since the global matrix stores the lower triangle, each entry is read from the 
+//! element's upper triangle, regardless of the ordering of the equation numbers.
+void CompactSymmMatrix::AssembleUpper(const matrix& ke, const vector<int>& LM)
+{
+	// get the number of degrees of freedom
+	const int N = ke.rows();
+
+	// find the permutation array that sorts LM in ascending order
+	// (the buffer is thread-local since elements may be assembled concurrently)
+	static thread_local std::vector<int> P;
+	P.resize(N);
+	qsort(N, &LM[0], &P[0]);
+
+	// get the data pointers 
+	int* indices = Indices();
+	int* pointers = Pointers();
+	double* pd = Values();
+	int offset = Offset();
+
+	// find the starting index
+	int N0 = 0;
+	while ((N0<N) && (LM[P[N0]]<0)) ++N0;
+
+	// assemble element stiffness
+	for (int m = N0; m<N; ++m)
+	{
+		int j = P[m];
+		int J = LM[j];
+		int n = 0;
+		double* pm = pd + (pointers[J] - offset);
+		int* pi = indices + (pointers[J] - offset);
+		int l = pointers[J + 1] - pointers[J];
+		int M0 = m;
+		while ((M0>N0) && (LM[P[M0 - 1]] == J)) M0--;
+		for (int k = M0; k<N; ++k)
+		{
+			int i = P[k];
+			int I = LM[i] + offset;
+			double kij = (j >= i ? ke[i][j] : ke[j][i]);
+			for (; n<l; ++n)
+				if (pi[n] == I)
+				{
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pm[n] += kij;
+					}
+					else pm[n] += kij;
+					break;
+				}
+		}
+	}
+}
 
 //-----------------------------------------------------------------------------
 void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const vector<int>& LMj)
@@ -236,8 +330,6 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const
 	const int N = ke.rows();
 	const int M = ke.columns();
 
-	int* indices = Indices();
-	int* pointers = Pointers();
 	double* values = Values();
 
 	for (int i = 0; i<N; ++i)
@@ -251,16 +343,17 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const
 			// only add values to lower-diagonal part of stiffness matrix
 			if ((I >= J) && (J >= 0))
 			{
-				double* pv = values + (pointers[J] - m_offset);
-				int* pi = indices + (pointers[J] - m_offset);
-				int l = pointers[J + 1] - pointers[J];
-				for (int n = 0; n<l; ++n) 
-					if (pi[n] - m_offset == I)
+				// find the entry with a binary search in column J
+				int n = findSlot(J, I);
+				if (n >= 0)
+				{
+					if (m_batomic)
 					{
 						#pragma omp atomic
-						pv[n] += ke[i][j];
-						break;
+						values[n] += ke[i][j];
 					}
+					else values[n] += ke[i][j];
+				}
 			}
 		}
 	}
@@ -289,8 +382,12 @@ void CompactSymmMatrix::add(int i, int j, double v)
 			int m = pi[n];
 			if (m == i)
 			{
-				#pragma omp atomic
-				pd[n] += v;
+				if (m_batomic)
+				{
+					#pragma omp atomic
+					pd[n] += v;
+				}
+				else pd[n] += v;
 				return;
 			}
 			else if (m < i)
@@ -51,6 +51,9 @@ public:
 	//! assemble a matrix into the sparse matrix
 	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
 
+	//! Assemble an element matrix of which only the upper triangle is set
+	void AssembleUpper(const matrix& ke, const std::vector<int>& lm) override;
+
 	//! add a matrix item
 	void add(int i, int j, double v) override;
 
@@ -86,4 +89,8 @@ public:
 
 	//! do row (L) and column (R) scaling
 	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+protected:
+	//! multiply columns c0 to c1 with x and add to r, which stores the rows starting at r0
+	void multColumns(const double* x, double* r, int c0, int c1, int r0) const;
 };
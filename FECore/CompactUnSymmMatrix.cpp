@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactUnSymmMatrix.h"
+#include "sys.h"
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -191,6 +192,8 @@ void CRSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 
 	// find the permutation array that sorts LM in ascending order
 	// we can use this to speed up the row search (i.e. loop over n below)
+	// (the buffer is thread-local since elements may be assembled concurrently)
+	static thread_local std::vector<int> P;
 	P.resize(N);
 	qsort(N, &LM[0], &P[0]);
 
@@ -223,8 +226,12 @@ void CRSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == J)
 				{
+					if (m_batomic)
+					{
 #pragma omp atomic
-					pm[n] += kij;
+						pm[n] += kij;
+					}
+					else pm[n] += kij;
 					break;
 				}
 		}
@@ -270,8 +277,12 @@ void CRSSparseMatrix::add(int i, int j, double v)
 		int m = pi[n];
 		if (m == j)
 		{
+			if (m_batomic)
+			{
 #pragma omp atomic
-			pd[n] += v;
+				pd[n] += v;
+			}
+			else pd[n] += v;
 			return;
 		}
 		else if (m < j)
@@ -605,6 +616,8 @@ void CCSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 
 	// find the permutation array that sorts LM in ascending order
 	// we can use this to speed up the row search (i.e. loop over n below)
+	// (the buffer is thread-local since elements may be assembled concurrently)
+	static thread_local std::vector<int> P;
 	P.resize(N);
 	qsort(N, &LM[0], &P[0]);
 
@@ -633,8 +646,12 @@ void CCSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == I)
 				{
+					if (m_batomic)
+					{
 #pragma omp atomic
-					pm[n] += ke[i][j];
+						pm[n] += ke[i][j];
+					}
+					else pm[n] += ke[i][j];
 					break;
 				}
 		}
@@ -680,8 +697,12 @@ void CCSSparseMatrix::add(int i, int j, double v)
 		int m = pi[n];
 		if (m == i)
 		{
+			if (m_batomic)
+			{
 #pragma omp atomic
-			pd[n] += v;
+				pd[n] += v;
+			}
+			else pd[n] += v;
 			return;
 		}
 		else if (m < i)
@@ -762,21 +783,48 @@ bool CCSSparseMatrix::mult_vector(double* x, double* r)
 	const int N = Rows();
 	const int M = Columns();
 
-	// zero r
-	for (int i=0; i<N; ++i) r[i] = 0.0;
+	int nt = (omp_in_parallel() ? 1 : omp_get_max_threads());
+	if (UpdateScatterBlocks(nt) == false)
+	{
+		// zero r
+		for (int i=0; i<N; ++i) r[i] = 0.0;
+
+		// loop over all columns
+		multColumns(x, r, 0, M, 0);
+		return true;
+	}
 
-	// loop over all columns
-	for (int i = 0; i<M; ++i)
+	// columns scatter into rows of other threads, so each thread works on its own buffer
+	const int nb = (int)m_sblock.size();
+#pragma omp parallel
 	{
-		double* pv = m_pd + (m_ppointers[i] - m_offset);
-		int* pi = m_pindices + (m_ppointers[i] - m_offset);
-		int n = m_ppointers[i + 1] - m_ppointers[i];
-		for (int j = 0; j<n; j++)  r[pi[j] - m_offset] += pv[j] * x[i];
+		for (int n = omp_get_thread_num(); n < nb; n += omp_get_num_threads())
+		{
+			const ScatterBlock& b = m_sblock[n];
+			double* y = m_sbuf.data() + b.off;
+			for (int i = 0; i <= b.rmax - b.rmin; ++i) y[i] = 0.0;
+			multColumns(x, y, b.c0, b.c1, b.rmin);
+		}
+#pragma omp barrier
+		ReduceScatterBlocks(r);
 	}
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void CCSSparseMatrix::multColumns(const double* x, double* r, int c0, int c1, int r0) const
+{
+	const int off = m_offset + r0;
+	for (int i = c0; i<c1; ++i)
+	{
+		const double* pv = m_pd + (m_ppointers[i] - m_offset);
+		const int* pi = m_pindices + (m_ppointers[i] - m_offset);
+		int n = m_ppointers[i + 1] - m_ppointers[i];
+		for (int j = 0; j<n; j++)  r[pi[j] - off] += pv[j] * x[i];
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! calculate the inf norm
 double CCSSparseMatrix::infNorm() const
@@ -176,4 +176,8 @@ public:
 
 	//! do row (L) and column (R) scaling
 	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+protected:
+	//! multiply columns c0 to c1 with x and add to r, which stores the rows starting at r0
+	void multColumns(const double* x, double* r, int c0, int c1, int r0) const;
 };
@@ -28,7 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "FESurface.h"
-#include "FENNQuery.h"
+#include "FESurfaceBVH.h"
 #include "FEElemElemList.h"
 #include "FENodeElemList.h"
 
@@ -44,6 +44,10 @@ public:
 	//! Initialization
 	bool Init();
 
+	//! Use a persistent search tree instead of building a new one in Init. 
+	//! The tree must be attached to the same surface. Init will refit the tree.
+	void SetSearchTree(FESurfaceBVH* bvh) { m_pbvh = bvh; }
+
 	//! Project a point onto surface
 	FESurfaceElement* Project(const vec3d& x, vec3d& q, vec2d& r);
 
@@ -73,6 +77,9 @@ private:
 	bool ContainsElement(FESurfaceElement* el);
 	FESurfaceElement* ProjectSpecial(int closestPoint, const vec3d& x, vec3d& q, vec2d& r);
 
+	//! the search tree in use
+	const FESurfaceBVH& SearchTree() const { return (m_pbvh ? *m_pbvh : m_bvh); }
+
 protected:
 	double	m_tol;	//!< projection tolerance
 	double	m_rad;	//!< search radius
@@ -81,7 +88,8 @@ protected:
 
 protected:
 	FESurface&		m_surf;		//!< reference to surface
-	FENNQuery		m_SNQ;		//!< used to find the nearest neighbour
+	FESurfaceBVH	m_bvh;		//!< used to find the nearest neighbour
+	FESurfaceBVH*	m_pbvh;		//!< persistent search tree (if set)
 	FENodeElemList	m_NEL;		//!< node-element tree
 	FEElemElemList	m_EEL;		//!< element neighbor list
 };
@@ -29,6 +29,9 @@ SOFTWARE.*/
 #include "DumpStream.h"
 #include "FEMesh.h"
 #include "FEGlobalMatrix.h"
+#include "FELinearSystem.h"
+#include "FEMaterialPointArena.h"
+#include "log.h"
 
 //-----------------------------------------------------------------------------
 FEDomain::FEDomain(int nclass, FEModel* fem) : FEMeshPartition(nclass, fem)
@@ -53,24 +56,44 @@ void FEDomain::SetMatID(int mid)
 // This routine allocates the material point data for the element's integration points.
 // Currently, this has to be called after the elements have been assigned a type (since this
 // determines how many integration points an element gets). 
+// The material points are allocated from an arena, so that the material point data of the 
+// domain is laid out contiguously in element order.
 void FEDomain::CreateMaterialPointData()
 {
 	FEMaterial* pmat = GetMaterial();
+	if (pmat == nullptr) return;
+
 	FEMesh* mesh = GetMesh();
-	if (pmat) ForEachElement([=](FEElement& el) {
+	FEMaterialPointArena* arena = new FEMaterialPointArena;
+	int npoints = 0;
+	{
+		FEMaterialPointArena::Scope scope(arena);
+		ForEachElement([&](FEElement& el) {
 
-		vec3d r[FEElement::MAX_NODES];
-		int ne = el.Nodes();
-		for (int i = 0; i < ne; ++i) r[i] = mesh->Node(el.m_node[i]).m_r0;
+			vec3d r[FEElement::MAX_NODES];
+			int ne = el.Nodes();
+			for (int i = 0; i < ne; ++i) r[i] = mesh->Node(el.m_node[i]).m_r0;
 
-		for (int k = 0; k < el.GaussPoints(); ++k)
-		{
-			FEMaterialPoint* mp = new FEMaterialPoint(pmat->CreateMaterialPointData());
-			mp->m_r0 = el.Evaluate(r, k);
-			mp->m_index = k;
-			el.SetMaterialPointData(mp, k);
-		}
-	});
+			for (int k = 0; k < el.GaussPoints(); ++k)
+			{
+				FEMaterialPoint* mp = new FEMaterialPoint(pmat->CreateMaterialPointData());
+				mp->m_r0 = el.Evaluate(r, k);
+				mp->m_index = k;
+				el.SetMaterialPointData(mp, k);
+			}
+			npoints += el.GaussPoints();
+		});
+	}
+
+	// report the memory used by the material points
+	if (npoints > 0)
+	{
+		double mb = arena->Bytes() / (1024.0*1024.0);
+		feLogDebug("Material point data for domain %s: %d points, %.2lf MB (%d bytes per point)\n", GetName().c_str(), npoints, mb, (int)(arena->Bytes() / npoints));
+	}
+
+	// the arena is deleted once all its material points are deleted
+	arena->Release();
 }
 
 //-----------------------------------------------------------------------------
@@ -154,6 +177,82 @@ void FEDomain::IncrementalUpdate(std::vector<double>& ui, bool finalFlag)
 
 }
 
+//-----------------------------------------------------------------------------
+const FEElementColoring& FEDomain::ElementColoring()
+{
+	if (m_coloring.IsEmpty()) m_coloring.Create(*this);
+	return m_coloring;
+}
+
+//-----------------------------------------------------------------------------
+void FEDomain::ClearElementColoring()
+{
+	m_coloring.Clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEDomain::ParallelAssemble(FELinearSystem& LS, std::function<void(int iel)> f)
+{
+	if (LS.ColoredAssembly())
+	{
+		// Elements of the same color do not share nodes, so they can be 
+		// assembled concurrently without atomic updates.
+		const FEElementColoring& col = ElementColoring();
+		LS.SetAtomicAssembly(false);
+		for (int c = 0; c < col.Colors(); ++c)
+		{
+			const int* elemList = col.ElementList(c);
+			int NE = col.Elements(c);
+#pragma omp parallel for shared(NE)
+			for (int i = 0; i < NE; ++i) f(elemList[i]);
+		}
+		LS.SetAtomicAssembly(true);
+	}
+	else
+	{
+		int NE = Elements();
+#pragma omp parallel for shared(NE)
+		for (int i = 0; i < NE; ++i) f(i);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEDomain::ParallelAssembleBlocks(FELinearSystem& LS, int blockSize, std::function<void(const int* elemList, int n)> f)
+{
+	if (LS.ColoredAssembly())
+	{
+		const FEElementColoring& col = ElementColoring();
+		LS.SetAtomicAssembly(false);
+		for (int c = 0; c < col.Colors(); ++c)
+		{
+			const int* elemList = col.ElementList(c);
+			int NE = col.Elements(c);
+			int NB = (NE + blockSize - 1) / blockSize;
+#pragma omp parallel for shared(NE, NB)
+			for (int i = 0; i < NB; ++i)
+			{
+				int i0 = i*blockSize;
+				f(elemList + i0, (i0 + blockSize <= NE ? blockSize : NE - i0));
+			}
+		}
+		LS.SetAtomicAssembly(true);
+	}
+	else
+	{
+		int NE = Elements();
+		vector<int> elemList(NE);
+		for (int i = 0; i < NE; ++i) elemList[i] = i;
+
+		int NB = (NE + blockSize - 1) / blockSize;
+#pragma omp parallel for shared(NE, NB)
+		for (int i = 0; i < NB; ++i)
+		{
+			int i0 = i*blockSize;
+			f(&elemList[i0], (i0 + blockSize <= NE ? blockSize : NE - i0));
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // This is the default packing method. 
 // It stores all the degrees of freedom for the first node in the order defined
@@ -28,9 +28,11 @@ SOFTWARE.*/
 
 #pragma once
 #include "FEMeshPartition.h"
+#include "FEElementColoring.h"
 
 // forward declaration of material class
 class FEMaterial;
+class FELinearSystem;
 
 // Base class for solid and shell parts. Domains can also have materials assigned.
 class FECORE_API FEDomain : public FEMeshPartition
@@ -82,10 +84,30 @@ public:
 	//! indicates whether it is safe to commit the updates.
 	virtual void IncrementalUpdate(std::vector<double>& ui, bool finalFlag);
 
+public:
+	//! Get the element coloring of this domain (it is built the first time it is needed)
+	const FEElementColoring& ElementColoring();
+
+	//! Clear the element coloring (e.g. when the element connectivity has changed)
+	void ClearElementColoring();
+
+	//! Evaluate f for all elements (passing the element index) in parallel. The function f
+	//! is expected to assemble the element's contribution into the linear system. When 
+	//! the linear system allows it, the elements are processed color by color so that the 
+	//! assembly can proceed without atomic updates.
+	void ParallelAssemble(FELinearSystem& LS, std::function<void(int iel)> f);
+
+	//! Same as ParallelAssemble, but f is called for blocks of (at most) blockSize elements, 
+	//! passing the list of element indices and the number of elements in the block.
+	void ParallelAssembleBlocks(FELinearSystem& LS, int blockSize, std::function<void(const int* elemList, int n)> f);
+
 protected:
 	// helper function for activating dof lists
 	void Activate(const FEDofList& dof);
 
 	// helper function for unpacking element dofs
 	void UnpackLM(FEElement& el, const FEDofList& dof, vector<int>& lm);
+
+private:
+	FEElementColoring	m_coloring;	//!< element coloring for conflict-free assembly
 };
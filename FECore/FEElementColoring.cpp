@@ -0,0 +1,117 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "stdafx.h"
+#include "FEElementColoring.h"
+#include "FEDomain.h"
+#include "FEMesh.h"
+
+//-----------------------------------------------------------------------------
+FEElementColoring::FEElementColoring()
+{
+
+}
+
+//-----------------------------------------------------------------------------
+void FEElementColoring::Clear()
+{
+	m_elem.clear();
+	m_col.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEElementColoring::Create(FEDomain& dom)
+{
+	Clear();
+
+	const int NE = dom.Elements();
+	if (NE == 0) return;
+
+	// collect the element nodes
+	std::vector<int> ptr(NE + 1, 0), nodeList;
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = dom.ElementRef(i);
+		int neln = el.Nodes();
+		for (int j = 0; j < neln; ++j) nodeList.push_back(el.m_node[j]);
+		ptr[i + 1] = (int)nodeList.size();
+	}
+
+	Create(NE, dom.GetMesh()->Nodes(), ptr, nodeList);
+}
+
+//-----------------------------------------------------------------------------
+// Greedy coloring: each element gets the lowest color that is not already 
+// used by any of the elements it shares a node with.
+void FEElementColoring::Create(int NE, int NN, const std::vector<int>& ptr, const std::vector<int>& nodeList)
+{
+	Clear();
+	if (NE == 0) return;
+
+	// build the node-element list
+	std::vector<int> nval(NN + 1, 0);
+	for (int i = 0; i < ptr[NE]; ++i) nval[nodeList[i] + 1]++;
+	for (int n = 0; n < NN; ++n) nval[n + 1] += nval[n];
+	std::vector<int> nel(ptr[NE]);
+	std::vector<int> pos(nval.begin(), nval.end() - 1);
+	for (int i = 0; i < NE; ++i)
+		for (int j = ptr[i]; j < ptr[i + 1]; ++j) nel[pos[nodeList[j]]++] = i;
+
+	// the color of each element (-1 = not yet colored)
+	std::vector<int> tag(NE, -1);
+
+	// mark[c] == i if color c is used by a neighbor of element i
+	std::vector<int> mark;
+
+	int ncol = 0;
+	for (int i = 0; i < NE; ++i)
+	{
+		for (int j = ptr[i]; j < ptr[i + 1]; ++j)
+		{
+			int n = nodeList[j];
+			for (int k = nval[n]; k < nval[n + 1]; ++k)
+			{
+				int c = tag[nel[k]];
+				if (c >= 0) mark[c] = i;
+			}
+		}
+
+		// find the first free color
+		int c = 0;
+		while ((c < ncol) && (mark[c] == i)) ++c;
+		if (c == ncol) { mark.push_back(-1); ncol++; }
+		tag[i] = c;
+	}
+
+	// count the elements per color
+	m_col.assign(ncol + 1, 0);
+	for (int i = 0; i < NE; ++i) m_col[tag[i] + 1]++;
+	for (int c = 0; c < ncol; ++c) m_col[c + 1] += m_col[c];
+
+	// sort the elements by color (preserving the element order within a color)
+	m_elem.resize(NE);
+	pos.assign(m_col.begin(), m_col.end() - 1);
+	for (int i = 0; i < NE; ++i) m_elem[pos[tag[i]]++] = i;
+}
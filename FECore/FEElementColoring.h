@@ -0,0 +1,68 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+
+class FEDomain;
+
+//-----------------------------------------------------------------------------
+//! This class partitions the elements of a domain into colors such that no two
+//! elements of the same color share a node. Elements of the same color can 
+//! therefore be assembled concurrently without the need to protect the updates 
+//! of the global matrix and vectors. 
+class FECORE_API FEElementColoring
+{
+public:
+	FEElementColoring();
+
+	//! build the coloring for a domain
+	void Create(FEDomain& dom);
+
+	//! Build the coloring for a list of NE "elements" whose (global) node numbers are
+	//! stored in compressed format: the nodes of element i are nodeList[ptr[i]], ..., nodeList[ptr[i+1]-1].
+	//! The node numbers must be smaller than NN. 
+	void Create(int NE, int NN, const std::vector<int>& ptr, const std::vector<int>& nodeList);
+
+	//! clear the coloring
+	void Clear();
+
+	//! see if the coloring was created
+	bool IsEmpty() const { return m_col.empty(); }
+
+	//! number of colors
+	int Colors() const { return (m_col.empty() ? 0 : (int)m_col.size() - 1); }
+
+	//! number of elements in color c
+	int Elements(int c) const { return m_col[c + 1] - m_col[c]; }
+
+	//! list of (domain) element indices of color c
+	const int* ElementList(int c) const { return &m_elem[0] + m_col[c]; }
+
+private:
+	std::vector<int>	m_elem;	//!< element indices, sorted by color
+	std::vector<int>	m_col;	//!< start index into m_elem for each color
+};
@@ -0,0 +1,161 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEElementScratch.h"
+#include "FEElement.h"
+#include <atomic>
+
+//-----------------------------------------------------------------------------
+// counts the allocations done by the scratch buffers
+static std::atomic<int> scratch_allocs(0);
+
+//-----------------------------------------------------------------------------
+FEElementScratch::FEElementScratch()
+{
+	int nmax = FEElement::MAX_NODES * DEFAULT_NODE_DOFS;
+	m_lm.reserve(nmax);
+	m_fe.reserve(nmax);
+	m_lmcap = m_lm.capacity();
+}
+
+//-----------------------------------------------------------------------------
+FEElementScratch::~FEElementScratch()
+{
+	for (size_t i = 0; i < m_ke.size(); ++i) delete m_ke[i].ke;
+	m_ke.clear();
+}
+
+//-----------------------------------------------------------------------------
+FEElementScratch& FEElementScratch::Get()
+{
+	static thread_local FEElementScratch scratch;
+	return scratch;
+}
+
+//-----------------------------------------------------------------------------
+int FEElementScratch::Allocations()
+{
+	return scratch_allocs;
+}
+
+//-----------------------------------------------------------------------------
+void FEElementScratch::ResetAllocations()
+{
+	scratch_allocs = 0;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<int>& FEElementScratch::LM()
+{
+	// the LM vector is filled by the caller (e.g. UnpackLM), so we can only
+	// detect that it had to grow the next time it is requested.
+	if (m_lm.capacity() != m_lmcap)
+	{
+		m_lmcap = m_lm.capacity();
+		scratch_allocs++;
+	}
+	return m_lm;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<double>& FEElementScratch::Vector(int n)
+{
+	if ((size_t) n > m_fe.capacity()) scratch_allocs++;
+	m_fe.assign(n, 0.0);
+	return m_fe;
+}
+
+//-----------------------------------------------------------------------------
+double* FEElementScratch::Buffer(size_t n)
+{
+	if (n > m_buf.size())
+	{
+		m_buf.resize(n);
+		scratch_allocs++;
+	}
+	return m_buf.data();
+}
+
+//-----------------------------------------------------------------------------
+// capacity of the index vectors of an element matrix
+static size_t index_capacity(const FEElementMatrix& ke)
+{
+	return ke.Nodes().capacity() + ke.RowIndices().capacity() + ke.ColumnsIndices().capacity();
+}
+
+//-----------------------------------------------------------------------------
+FEElementMatrix& FEElementScratch::Matrix(const FEElement& el, int nr, int nc)
+{
+	// find a matrix of the requested size
+	MATRIX* pm = nullptr;
+	for (size_t i = 0; i < m_ke.size(); ++i)
+	{
+		FEElementMatrix& ke = *m_ke[i].ke;
+		if ((ke.rows() == nr) && (ke.columns() == nc)) { pm = &m_ke[i]; break; }
+	}
+
+	// allocate a new one if needed
+	if (pm == nullptr)
+	{
+		MATRIX m = { new FEElementMatrix(nr, nc), 0 };
+		m_ke.push_back(m);
+		pm = &m_ke.back();
+		scratch_allocs++;
+	}
+	FEElementMatrix& ke = *pm->ke;
+
+	// The index vectors only allocate when they need to grow. Since the indices
+	// may be set by the caller, we check this the next time the matrix is requested.
+	ke.SetElement(el);
+	size_t cap = index_capacity(ke);
+	if (cap != pm->cap)
+	{
+		pm->cap = cap;
+		scratch_allocs++;
+	}
+
+	ke.zero();
+	ke.SetUpperTriangular(false);
+	return ke;
+}
+
+//-----------------------------------------------------------------------------
+FEElementMatrix& FEElementScratch::Matrix(const FEElement& el, const std::vector<int>& lm, int nr, int nc)
+{
+	FEElementMatrix& ke = Matrix(el, nr, nc);
+	ke.SetIndices(lm);
+	return ke;
+}
+
+//-----------------------------------------------------------------------------
+FEElementMatrix& FEElementScratch::Matrix(const FEElement& el, const std::vector<int>& lmi, const std::vector<int>& lmj, int nr, int nc)
+{
+	FEElementMatrix& ke = Matrix(el, nr, nc);
+	ke.SetIndices(lmi, lmj);
+	return ke;
+}
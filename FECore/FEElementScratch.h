@@ -0,0 +1,93 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "FEGlobalMatrix.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Scratch buffers for element loops. 
+//! Each thread owns one instance (see FEElementScratch::Get) which holds the
+//! LM vector, element vector and element matrices that are otherwise allocated
+//! for every element. The buffers keep their memory between calls so that, once
+//! they have grown to the largest element of the model, element loops do not
+//! allocate anymore. Only one buffer of each kind (and one matrix per size) can 
+//! be in use at a time by a thread.
+class FECORE_API FEElementScratch
+{
+	enum { DEFAULT_NODE_DOFS = 8 };	// dofs per node that the initial buffers can accommodate
+
+public:
+	FEElementScratch();
+	~FEElementScratch();
+
+	//! get the scratch buffers of the calling thread
+	static FEElementScratch& Get();
+
+	//! total number of (re)allocations done by the scratch buffers of all threads
+	static int Allocations();
+
+	//! reset the allocation counter
+	static void ResetAllocations();
+
+public:
+	//! LM vector
+	std::vector<int>& LM();
+
+	//! element vector of size n, initialized to zero
+	std::vector<double>& Vector(int n);
+
+	//! work buffer of (at least) n values. The buffer is not initialized.
+	double* Buffer(size_t n);
+
+	//! element matrix of size nr x nc for element el, initialized to zero
+	FEElementMatrix& Matrix(const FEElement& el, int nr, int nc);
+
+	//! element matrix of size nr x nc for element el, initialized to zero
+	FEElementMatrix& Matrix(const FEElement& el, const std::vector<int>& lm, int nr, int nc);
+
+	//! element matrix of size nr x nc for element el, initialized to zero
+	FEElementMatrix& Matrix(const FEElement& el, const std::vector<int>& lmi, const std::vector<int>& lmj, int nr, int nc);
+
+private:
+	FEElementScratch(const FEElementScratch&) = delete;
+	void operator = (const FEElementScratch&) = delete;
+
+private:
+	struct MATRIX
+	{
+		FEElementMatrix*	ke;		//!< the element matrix
+		size_t				cap;	//!< capacity of its index vectors at last call
+	};
+
+private:
+	std::vector<int>	m_lm;		//!< LM vector
+	std::vector<double>	m_fe;		//!< element vector
+	std::vector<double>	m_buf;		//!< work buffer
+	std::vector<MATRIX>	m_ke;		//!< element matrices (one for each size)
+	size_t				m_lmcap;	//!< capacity of LM vector at last call
+};
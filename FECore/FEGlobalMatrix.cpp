@@ -31,16 +31,21 @@ SOFTWARE.*/
 #include "FEModel.h"
 #include "FEDomain.h"
 #include "FESurface.h"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el)
 {
+	m_pel = &el;
+	m_bupper = false;
 	m_node = el.m_node;
 }
 
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke) : matrix(ke)
 {
+	m_pel = ke.m_pel;
+	m_bupper = ke.m_bupper;
 	m_node = ke.m_node;
 	m_lmi = ke.m_lmi;
 	m_lmj = ke.m_lmj;
@@ -49,6 +54,8 @@ FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke) : matrix(ke)
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke, double scale)
 {
+	m_pel = ke.m_pel;
+	m_bupper = ke.m_bupper;
 	m_node = ke.m_node;
 	m_lmi = ke.m_lmi;
 	m_lmj = ke.m_lmj;
@@ -60,6 +67,8 @@ FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke, double scale)
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el, const vector<int>& lmi) : matrix((int)lmi.size(), (int)lmi.size())
 {
+	m_pel = &el;
+	m_bupper = false;
 	m_node = el.m_node;
 	m_lmi = lmi;
 	m_lmj = lmi;
@@ -68,16 +77,35 @@ FEElementMatrix::FEElementMatrix(const FEElement& el, const vector<int>& lmi) :
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el, vector<int>& lmi, vector<int>& lmj) : matrix((int)lmi.size(), (int)lmj.size())
 {
+	m_pel = &el;
+	m_bupper = false;
 	m_node = el.m_node;
 	m_lmi = lmi;
 	m_lmj = lmj;
 };
 
+//-----------------------------------------------------------------------------
+void FEElementMatrix::SetElement(const FEElement& el)
+{
+	m_pel = &el;
+	m_node = el.m_node;
+}
+
 //-----------------------------------------------------------------------------
 // assignment operator
 void FEElementMatrix::operator = (const matrix& ke)
 {
 	matrix::operator=(ke);
+	m_bupper = false;
+}
+
+//-----------------------------------------------------------------------------
+void FEElementMatrix::FillLowerTriangle()
+{
+	if (m_bupper == false) return;
+	for (int i = 0; i < m_nr; ++i)
+		for (int j = 0; j < i; ++j) m_pr[i][j] = m_pr[j][i];
+	m_bupper = false;
 }
 
 
@@ -90,6 +118,7 @@ FEGlobalMatrix::FEGlobalMatrix(SparseMatrix* pK, bool del)
 	m_pMP = 0;
 	m_nlm = 0;
 	m_delA = del;
+	m_bscatter = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -169,10 +198,83 @@ void FEGlobalMatrix::build_end()
 {
 	if (m_nlm > 0) build_flush();
 	m_pA->Create(*m_pMP);
+
+	// the scatter maps are no longer valid
+	m_scatter.clear();
 }
 
 //-----------------------------------------------------------------------------
 bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
+{
+	// matrix-free operators only need the dimensions
+	if (m_pA->NeedsProfile() == false)
+	{
+		SparseMatrixProfile MP(neq, neq);
+		m_pA->Create(MP);
+		return true;
+	}
+
+	// build the matrix profile
+	BuildProfile(pfem, neq, breset);
+
+	// create the sparse matrix from the profile
+	CreateFromProfile(pfem);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Create the sparse matrix from the current profile
+void FEGlobalMatrix::CreateFromProfile(FEModel* pfem)
+{
+	// All done! We can now finish building the profile and create 
+	// the actual sparse matrix. This is done in the following function
+	build_end();
+
+	// prepare the scatter map cache
+	if (m_bscatter) InitScatterMaps(pfem);
+}
+
+//-----------------------------------------------------------------------------
+//! Update the profile of the matrix after the "dynamic" elements (e.g. contact) 
+//! changed their connectivity. The static part of the profile is not rebuilt. 
+//! If the new profile fits in the structure of the current sparse matrix, the old
+//! profile is kept and the function returns false, indicating that the current
+//! sparse matrix can be reused. Otherwise, the new profile is padded with the old
+//! one (so that small changes in connectivity later on are likely to fit), and the 
+//! function returns true. In that case, the sparse matrix needs to be recreated by 
+//! calling CreateFromProfile.
+bool FEGlobalMatrix::UpdateProfile(FEModel* pfem, int neq)
+{
+	// we need a matrix and the static profile
+	if ((m_pMP == nullptr) || (m_pA->Rows() != neq) || (m_MPs.Rows() != neq))
+	{
+		BuildProfile(pfem, neq, true);
+		return true;
+	}
+
+	// build the new profile, but hang on to the old one
+	SparseMatrixProfile* oldMP = m_pMP; m_pMP = nullptr;
+	BuildProfile(pfem, neq, false);
+
+	// If the new profile fits in the old profile, we can reuse the current matrix.
+	if (oldMP->Contains(*m_pMP))
+	{
+		delete m_pMP;
+		m_pMP = oldMP;
+		return false;
+	}
+
+	// pad the new profile with the old one
+	m_pMP->Merge(*oldMP);
+	delete oldMP;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Build the matrix profile of a model.
+void FEGlobalMatrix::BuildProfile(FEModel* pfem, int neq, bool breset)
 {
 	// The first time we come here we build the "static" profile.
 	// This static profile stores the contribution to the matrix profile
@@ -196,6 +298,11 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 		{
 			m_MPs.Clear();
 
+			// the connectivity may have changed, so the element colorings
+			// need to be rebuilt the next time they are needed.
+			FEMesh& mesh = pfem->GetMesh();
+			for (int i = 0; i < mesh.Domains(); ++i) mesh.Domain(i).ClearElementColoring();
+
 			// build the matrix profile
 			pfem->BuildMatrixProfile(*this, true);
 
@@ -213,11 +320,9 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 		// Add the "dynamic" profile
 		pfem->BuildMatrixProfile(*this, false);
 	}
-	// All done! We can now finish building the profile and create 
-	// the actual sparse matrix. This is done in the following function
-	build_end();
 
-	return true;
+	// make sure the LM buffer is flushed
+	if (m_nlm > 0) build_flush();
 }
 
 //-----------------------------------------------------------------------------
@@ -316,5 +421,66 @@ bool FEGlobalMatrix::Create(const FESurface& surf, const std::vector<int>& equat
 
 void FEGlobalMatrix::Assemble(const FEElementMatrix& ke)
 {
-	m_pA->Assemble(ke, ke.RowIndices(), ke.ColumnsIndices());
+	// see if we can use a cached scatter map
+	const int* slots = (m_bscatter ? FindScatterMap(ke) : nullptr);
+	if (ke.IsUpperTriangular())
+	{
+		if (slots) m_pA->ScatterAddUpper(ke, slots);
+		else m_pA->AssembleUpper(ke, ke.RowIndices());
+	}
+	else if (slots) m_pA->ScatterAdd(ke, slots);
+	else m_pA->Assemble(ke, ke.RowIndices(), ke.ColumnsIndices());
+}
+
+//-----------------------------------------------------------------------------
+// Allocate the scatter maps for all the domains' elements. The maps themselves
+// are built when an element is assembled for the first time. Since elements are 
+// only assembled by one thread at a time, this does not need to be synchronized.
+void FEGlobalMatrix::InitScatterMaps(FEModel* fem)
+{
+	m_scatter.clear();
+	FEMesh& mesh = fem->GetMesh();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		m_scatter[&dom].resize(dom.Elements());
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Find the scatter map for an element matrix. Only element matrices of the model's 
+// domains that have identical row and column indices are cached. If the indices 
+// don't match the ones the map was built for (e.g. a different set of dofs is assembled),
+// null is returned and the regular assembly routine is used.
+const int* FEGlobalMatrix::FindScatterMap(const FEElementMatrix& ke)
+{
+	const FEElement* pe = ke.Element();
+	if (pe == nullptr) return nullptr;
+
+	auto it = m_scatter.find(pe->GetMeshPartition());
+	if (it == m_scatter.end()) return nullptr;
+
+	std::vector<ElementScatterMap>& maps = it->second;
+	int lid = pe->GetLocalID();
+	if ((lid < 0) || (lid >= (int)maps.size())) return nullptr;
+
+	// Note that the index vectors can be longer than the matrix (e.g. the LM vector
+	// of a solid element also contains the shell dofs), so only the first N are compared.
+	const int N = ke.rows();
+	const vector<int>& lmi = ke.RowIndices();
+	const vector<int>& lmj = ke.ColumnsIndices();
+	if ((ke.columns() != N) || ((int)lmi.size() < N) || ((int)lmj.size() < N)) return nullptr;
+	if (std::equal(lmi.begin(), lmi.begin() + N, lmj.begin()) == false) return nullptr;
+
+	ElementScatterMap& map = maps[lid];
+	if (map.lm.empty())
+	{
+		// If the map cannot be built, the indices are still stored, but with an 
+		// empty slot list, so that the build is not attempted again for this element.
+		map.lm.assign(lmi.begin(), lmi.begin() + N);
+		if (m_pA->BuildScatterMap(map.lm, map.slots) == false) map.slots.clear();
+	}
+	else if (((int)map.lm.size() != N) || (std::equal(map.lm.begin(), map.lm.end(), lmi.begin()) == false)) return nullptr;
+
+	return (map.slots.empty() ? nullptr : &map.slots[0]);
 }
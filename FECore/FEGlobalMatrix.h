@@ -31,12 +31,14 @@ SOFTWARE.*/
 #include "SparseMatrix.h"
 #include "FESolver.h"
 #include <vector>
+#include <map>
 
 //-----------------------------------------------------------------------------
 class FEModel;
 class FEMesh;
 class FESurface;
 class FEElement;
+class FEMeshPartition;
 
 //-----------------------------------------------------------------------------
 //! This class represents an element matrix, i.e. a matrix of values and the row and
@@ -45,8 +47,8 @@ class FECORE_API FEElementMatrix : public matrix
 {
 public:
 	// default constructor
-	FEElementMatrix(){}
-	FEElementMatrix(int nr, int nc) : matrix(nr, nc) {}
+	FEElementMatrix() : m_pel(nullptr), m_bupper(false) {}
+	FEElementMatrix(int nr, int nc) : matrix(nr, nc), m_pel(nullptr), m_bupper(false) {}
 	FEElementMatrix(const FEElement& el);
 
 	// constructor for symmetric matrices
@@ -82,7 +84,27 @@ public:
 	// get the nodes
 	const std::vector<int>& Nodes() const { return m_node; }
 
+	// get the element this matrix was created for (can be null)
+	const FEElement* Element() const { return m_pel; }
+
+	// set the element this matrix is for (this also copies the element's nodes)
+	void SetElement(const FEElement& el);
+
+	// Flag a symmetric matrix of which only the upper triangle (j >= i) is set.
+	void SetUpperTriangular(bool b) { m_bupper = b; }
+
+	// see if only the upper triangle is set
+	bool IsUpperTriangular() const { return m_bupper; }
+
+	// get entry (i,j), taking into account that only the upper triangle may be set
+	double value(int i, int j) const { return (m_bupper && (i > j) ? m_pr[j][i] : m_pr[i][j]); }
+
+	// copy the upper triangle to the lower triangle, so that all entries are set
+	void FillLowerTriangle();
+
 private:
+	const FEElement*	m_pel;	//!< the element (if any)
+	bool				m_bupper;	//!< only the upper triangle is set
 	std::vector<int>	m_node;	//!< node indices
 	std::vector<int>	m_lmi;	//!< row indices
 	std::vector<int>	m_lmj;	//!< column indices
@@ -116,6 +138,13 @@ public:
 	//! construct the stiffness matrix from a FEM object
 	bool Create(FEModel* pfem, int neq, bool breset);
 
+	//! Update the profile after the dynamic part changed. Returns true if the 
+	//! sparse matrix needs to be recreated (with CreateFromProfile).
+	bool UpdateProfile(FEModel* pfem, int neq);
+
+	//! create the sparse matrix from the current profile
+	void CreateFromProfile(FEModel* pfem);
+
 	//! construct the stiffness matrix from a mesh
 	bool Create(FEMesh& mesh, int neq);
 
@@ -153,6 +182,12 @@ public:
 	//! get the sparse matrix profile
 	SparseMatrixProfile* GetSparseMatrixProfile() { return m_pMP; }
 
+	//! Turn on/off the caching of element scatter maps. When turned on, the offsets into 
+	//! the sparse matrix of the element matrices of the model's domains are cached
+	//! the first time an element is assembled, so that subsequent assemblies become a
+	//! direct indexed add. The cache is cleared when the matrix is (re)created.
+	void UseScatterMaps(bool b) { m_bscatter = b; }
+
 public:
 	void build_begin(int neq);
 	void build_add(std::vector<int>& lm);
@@ -170,4 +205,25 @@ protected:
 	SparseMatrixProfile		m_MPs;		//!< the "static" part of the matrix profile
 	vector< vector<int> >	m_LM;		//!< used for building the stiffness matrix
 	int	m_nlm;				//!< nr of elements in m_LM array
+
+protected:
+	// build the matrix profile of a model
+	void BuildProfile(FEModel* pfem, int neq, bool breset);
+
+protected:
+	// find (or build) the scatter map of an element matrix
+	const int* FindScatterMap(const FEElementMatrix& ke);
+
+	// allocate the scatter map cache for the domains of a model
+	void InitScatterMaps(FEModel* fem);
+
+	// cached scatter map of an element
+	struct ElementScatterMap
+	{
+		std::vector<int>	lm;		//!< the indices the map was built for
+		std::vector<int>	slots;	//!< offsets into the sparse matrix' values (empty if the map could not be built)
+	};
+
+	bool	m_bscatter;		//!< use cached scatter maps
+	std::map<const FEMeshPartition*, std::vector<ElementScatterMap> >	m_scatter;
 };
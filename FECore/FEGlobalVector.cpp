@@ -30,10 +30,12 @@ SOFTWARE.*/
 #include "FEGlobalVector.h"
 #include "vec3d.h"
 #include "FEModel.h"
+#include "sys.h"
 
 //-----------------------------------------------------------------------------
 FEGlobalVector::FEGlobalVector(FEModel& fem, vector<double>& R, vector<double>& Fr) : m_fem(fem), m_R(R), m_Fr(Fr)
 {
+	m_breduce = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -42,6 +44,91 @@ FEGlobalVector::~FEGlobalVector()
 
 }
 
+//-----------------------------------------------------------------------------
+void FEGlobalVector::BeginReduction()
+{
+	int nt = omp_get_max_threads();
+	if ((int)m_buf.size() != nt) m_buf.resize(nt);
+
+	// Only the parts of the buffers that were assembled into are cleared in EndReduction, 
+	// so the buffers only need to be zeroed when they are (re)allocated.
+	for (ReductionBuffer& b : m_buf)
+	{
+		if (b.R.size() != m_R.size()) b.R.assign(m_R.size(), 0.0);
+		if (b.Fr.size() != m_Fr.size()) b.Fr.assign(m_Fr.size(), 0.0);
+		b.r0 = (int)m_R.size(); b.r1 = -1;
+		b.f0 = (int)m_Fr.size(); b.f1 = -1;
+	}
+
+	m_breduce = true;
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalVector::EndReduction()
+{
+	if (m_breduce == false) return;
+	m_breduce = false;
+
+	// find the range that was assembled into
+	const int nb = (int)m_buf.size();
+	int r0 = (int)m_R.size(), r1 = -1;
+	int f0 = (int)m_Fr.size(), f1 = -1;
+	for (ReductionBuffer& b : m_buf)
+	{
+		if (b.r0 < r0) r0 = b.r0;
+		if (b.r1 > r1) r1 = b.r1;
+		if (b.f0 < f0) f0 = b.f0;
+		if (b.f1 > f1) f1 = b.f1;
+	}
+
+	// Add the buffers to the vector. The buffers are always added in the same order, 
+	// so the result does not depend on how the threads are scheduled.
+	ReductionBuffer* pb = m_buf.data();
+#pragma omp parallel
+	{
+#pragma omp for schedule(static)
+		for (int i = r0; i <= r1; ++i)
+		{
+			double ri = 0.0;
+			for (int n = 0; n < nb; ++n)
+			{
+				if ((i >= pb[n].r0) && (i <= pb[n].r1)) ri += pb[n].R[i];
+			}
+			m_R[i] += ri;
+		}
+
+#pragma omp for schedule(static)
+		for (int i = f0; i <= f1; ++i)
+		{
+			double fi = 0.0;
+			for (int n = 0; n < nb; ++n)
+			{
+				if ((i >= pb[n].f0) && (i <= pb[n].f1)) fi += pb[n].Fr[i];
+			}
+			m_Fr[i] += fi;
+		}
+
+		// clear the buffers for the next time
+#pragma omp for schedule(static)
+		for (int n = 0; n < nb; ++n)
+		{
+			ReductionBuffer& b = pb[n];
+			for (int i = b.r0; i <= b.r1; ++i) b.R[i] = 0.0;
+			for (int i = b.f0; i <= b.f1; ++i) b.Fr[i] = 0.0;
+			b.r0 = (int)m_R.size(); b.r1 = -1;
+			b.f0 = (int)m_Fr.size(); b.f1 = -1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+FEGlobalVector::ReductionBuffer* FEGlobalVector::ThreadBuffer()
+{
+	if (m_breduce == false) return nullptr;
+	int n = omp_get_thread_num();
+	return (n < (int)m_buf.size() ? &m_buf[n] : nullptr);
+}
+
 //-----------------------------------------------------------------------------
 void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
 {
@@ -49,6 +136,18 @@ void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>&
 
 	// assemble the element residual into the global residual
 	int ndof = (int)fe.size();
+	ReductionBuffer* buf = ThreadBuffer();
+	if (buf)
+	{
+		for (int i = 0; i<ndof; ++i)
+		{
+			int I = elm[i];
+			if (I >= 0) buf->AddR(I, fe[i]);
+			else if (-I - 2 >= 0) buf->AddFr(-I - 2, -fe[i]);
+		}
+		return;
+	}
+
 	for (int i=0; i<ndof; ++i)
 	{
 		int I = elm[i];
@@ -70,6 +169,14 @@ void FEGlobalVector::Assemble(vector<int>& lm, vector<double>& fe)
 {
 	vector<double>& R = m_R;
 	const int n = (int) lm.size();
+	ReductionBuffer* buf = ThreadBuffer();
+	if (buf)
+	{
+		for (int i = 0; i<n; ++i)
+			if (lm[i] >= 0) buf->AddR(lm[i], fe[i]);
+		return;
+	}
+
 	for (int i=0; i<n; ++i)
 	{
 		int nid = lm[i];
@@ -90,7 +197,12 @@ void FEGlobalVector::Assemble(int nodeId, int dof, double f)
 
 	// assemble into global vector
 	if (n >= 0) {
+		ReductionBuffer* buf = ThreadBuffer();
+		if (buf) buf->AddR(n, f);
+		else
+		{
 #pragma omp atomic
-		m_R[n] += f;
+			m_R[n] += f;
+		}
 	}
 }
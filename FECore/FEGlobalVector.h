@@ -65,8 +65,41 @@ public:
 
 	operator std::vector<double>& () { return m_R; }
 
+public:
+	//! Start assembling in reduction mode. In this mode, each thread assembles into its own 
+	//! buffer without atomic updates, and the buffers are added to the vector in EndReduction.
+	//! For a fixed number of threads (and a static assignment of work to threads) the result 
+	//! is then reproducible.
+	void BeginReduction();
+
+	//! add the thread buffers to the vector and leave the reduction mode
+	void EndReduction();
+
+protected:
+	// Buffer of a thread in reduction mode. It keeps track of the range of entries that 
+	// were assembled into, so that only those need to be reduced and cleared.
+	struct ReductionBuffer
+	{
+		std::vector<double>	R, Fr;
+		int		r0, r1;		// range of R that was assembled into
+		int		f0, f1;		// range of Fr that was assembled into
+		char	pad[64];	// avoid false sharing of the ranges
+
+		void AddR(int i, double v) { R[i] += v; if (i < r0) r0 = i; if (i > r1) r1 = i; }
+		void AddFr(int i, double v) { Fr[i] += v; if (i < f0) f0 = i; if (i > f1) f1 = i; }
+
+		// mark the entire vector as modified (used when R is passed on to other code)
+		void Touch() { r0 = 0; r1 = (int)R.size() - 1; }
+	};
+
+	//! Get the buffer of the calling thread (or null when not in reduction mode)
+	ReductionBuffer* ThreadBuffer();
+
 protected:
 	FEModel&			m_fem;	//!< model
 	std::vector<double>&		m_R;	//!< residual
 	std::vector<double>&		m_Fr;	//!< nodal reaction forces \todo I want to remove this
+
+	bool							m_breduce;	//!< reduction mode flag
+	std::vector<ReductionBuffer>	m_buf;		//!< thread buffers for reduction mode
 };
@@ -109,6 +109,10 @@ bool FELinearSolver::Init()
 		}
 	}
 
+	// pass the equation ordering to the linear solver
+	vector<int> perm;
+	if (EquationOrdering(perm)) m_pls->SetPermutation(perm);
+
 	// allocate storage for the sparse matrix that will hold the stiffness matrix data
 	// we let the solver allocate the correct type of matrix format
 	Matrix_Type mtype = MatrixType();
@@ -145,6 +149,7 @@ bool FELinearSolver::Init()
 		feLogError("Failed allocating stiffness matrix\n\n");
 		return false;
 	}
+	m_pK->UseScatterMaps(m_bscatter);
 
 	// Set the matrix formation flag
 	m_breform = true;
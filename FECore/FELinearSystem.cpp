@@ -35,6 +35,7 @@ SOFTWARE.*/
 FELinearSystem::FELinearSystem(FESolver* solver, FEGlobalMatrix& K, vector<double>& F, vector<double>& u, bool bsymm) : m_K(K), m_F(F), m_u(u), m_solver(solver)
 {
 	m_bsymm = bsymm;
+	m_batomic = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -50,6 +51,15 @@ bool FELinearSystem::IsSymmetric() const
 	return m_bsymm;
 }
 
+//-----------------------------------------------------------------------------
+// The linear constraints need the full element matrices.
+bool FELinearSystem::UpperTriangularAssembly() const
+{
+	if (m_bsymm == false) return false;
+	FEModel* fem = m_solver->GetFEModel();
+	return (fem->GetLinearConstraintManager().LinearConstraints() == 0);
+}
+
 //-----------------------------------------------------------------------------
 // Get the solver that is using this linear system
 FESolver* FELinearSystem::GetSolver()
@@ -57,6 +67,28 @@ FESolver* FELinearSystem::GetSolver()
 	return m_solver;
 }
 
+//-----------------------------------------------------------------------------
+// See if element matrices can be assembled color by color. This requires that the 
+// solver requested it and that there are no linear constraints, since those 
+// can couple degrees of freedom of elements that have the same color.
+bool FELinearSystem::ColoredAssembly() const
+{
+	if ((m_solver == nullptr) || (m_solver->m_assembly != ASSEMBLY_SCHEME::COLORED_ASSEMBLY)) return false;
+
+	FEModel* fem = m_solver->GetFEModel();
+	FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
+	return (LCM.LinearConstraints() == 0);
+}
+
+//-----------------------------------------------------------------------------
+// turn on/off the atomic updates of the global matrix and the prescribed dof vector
+void FELinearSystem::SetAtomicAssembly(bool b)
+{
+	m_batomic = b;
+	SparseMatrix* K = m_K.GetSparseMatrixPtr();
+	if (K) K->SetAtomicAssembly(b);
+}
+
 //-----------------------------------------------------------------------------
 //! assemble global stiffness matrix
 void FELinearSystem::Assemble(const FEElementMatrix& ke)
@@ -88,8 +120,12 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 				if (I >= 0)
 				{
 					// dof i is not a prescribed degree of freedom
+					if (m_batomic)
+					{
 #pragma omp atomic
-					m_F[I] -= ke[i][j] * m_u[J];
+						m_F[I] -= ke.value(i, j) * m_u[J];
+					}
+					else m_F[I] -= ke.value(i, j) * m_u[J];
 				}
 			}
 
@@ -98,16 +134,19 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 		}
 	}
 
-#pragma omp critical
-	{
+	// adjust for linear constraints
+	// (Only enter the critical section when there are linear constraints.)
 	FEModel* fem = m_solver->GetFEModel();
 	FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
 	if (LCM.LinearConstraints())
 	{
+		assert(ke.IsUpperTriangular() == false);
+#pragma omp critical
+		{
 		const vector<int>& en = ke.Nodes();
 		LCM.AssembleStiffness(m_K, m_F, m_u, en, lmi, lmj, ke);
+		} // omp critical
 	}
-	} // omp critical
 }
 
 //-----------------------------------------------------------------------------
@@ -55,6 +55,16 @@ public:
 	// Get the solver that is using this linear system
 	FESolver* GetSolver();
 
+	// see if element matrices can be assembled color by color, without atomic updates
+	bool ColoredAssembly() const;
+
+	// turn on/off the atomic updates of the global matrix and the prescribed dof vector
+	void SetAtomicAssembly(bool b);
+
+	// See if element matrices of which only the upper triangle is set can be assembled
+	// (see FEElementMatrix::IsUpperTriangular). This requires a symmetric system. 
+	virtual bool UpperTriangularAssembly() const;
+
 public:
 	// Assembly routine
 	// This assembles the element stiffness matrix ke into the global matrix.
@@ -70,6 +80,7 @@ public:
 
 protected:
 	bool					m_bsymm;	//!< symmetry flag
+	bool					m_batomic;	//!< use atomic updates during assembly
 	FESolver*				m_solver;
 	FEGlobalMatrix&			m_K;	//!< The global stiffness matrix
 	std::vector<double>&	m_F;	//!< Contributions from prescribed degrees of freedom
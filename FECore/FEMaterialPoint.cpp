@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FEMaterialPoint.h"
 #include "DumpStream.h"
 #include <string.h>
+#include <atomic>
 
 FEMaterialPointData::FEMaterialPointData(FEMaterialPointData* ppt)
 {
@@ -82,6 +83,18 @@ FEMaterialPoint::FEMaterialPoint(FEMaterialPointData* data)
 {
 	m_data = data;
 	m_elem = nullptr;
+	ClearDataSlots();
+}
+
+int FEMaterialPoint::NewDataSlot()
+{
+	static std::atomic<int> slots(0);
+	return slots++;
+}
+
+void FEMaterialPoint::ClearDataSlots()
+{
+	m_slot.clear();
 }
 
 FEMaterialPoint::~FEMaterialPoint()
@@ -98,6 +111,7 @@ FEMaterialPoint* FEMaterialPoint::Copy()
 {
 	FEMaterialPoint* mp = new FEMaterialPoint(*this);
 	if (m_data) mp->m_data = m_data->Copy();
+	mp->ClearDataSlots();
 	return mp;
 }
 
@@ -108,6 +122,9 @@ void FEMaterialPoint::Update(const FETimeInfo& timeInfo)
 
 void FEMaterialPoint::Serialize(DumpStream& ar)
 {
+	// the data may be reallocated when loading
+	if (ar.IsLoading()) ClearDataSlots();
+
 	if (ar.IsShallow() == false)
 	{
 		ar & m_r0 & m_J0 & m_Jt;
@@ -120,6 +137,7 @@ void FEMaterialPoint::Append(FEMaterialPointData* pt)
 	if (pt == nullptr) return;
 	assert(m_data);
 	if (m_data) m_data->Append(pt);
+	ClearDataSlots();
 }
 
 //=================================================================================================
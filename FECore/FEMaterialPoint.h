@@ -31,7 +31,9 @@ SOFTWARE.*/
 #include "mat3d.h"
 #include "quatd.h"
 #include "FETimeInfo.h"
+#include "FEMaterialPointArena.h"
 #include <vector>
+#include <atomic>
 
 class FEElement;
 class FEMaterialPoint;
@@ -52,6 +54,10 @@ public:
 	FEMaterialPointData(FEMaterialPointData* ppt = 0);
 	virtual ~FEMaterialPointData();
 
+	// material point data is allocated from the active material point arena (if any)
+	static void* operator new(size_t n) { return FEMaterialPointArena::Allocate(n); }
+	static void operator delete(void* p) { FEMaterialPointArena::Free(p); }
+
 public:
 	//! The init function is used to intialize data
 	virtual void Init();
@@ -103,10 +109,23 @@ protected:
 //-----------------------------------------------------------------------------
 class FECORE_API FEMaterialPoint
 {
+public:
+	// Number of data types for which the material point caches the result of ExtractData.
+	// Each type that is extracted is assigned a slot the first time it is requested (see 
+	// DataSlot), so the slots are taken by the types that are used first. 
+	enum { MAX_DATA_SLOTS = 8 };
+
+	// get the slot of a material point data type
+	template <class T> static int DataSlot();
+
 public:
 	FEMaterialPoint(FEMaterialPointData* data = nullptr);
 	virtual ~FEMaterialPoint();
 
+	// material points are allocated from the active material point arena (if any)
+	static void* operator new(size_t n) { return FEMaterialPointArena::Allocate(n); }
+	static void operator delete(void* p) { FEMaterialPointArena::Free(p); }
+
 	//! The init function is used to intialize data
 	virtual void Init();
 
@@ -136,6 +155,13 @@ public:
 	template <class T> T* ExtractData();
 	template <class T> const T* ExtractData() const;
 
+private:
+	// assign a new data slot
+	static int NewDataSlot();
+
+	// clear the cached data
+	void ClearDataSlots();
+
 public:
 	vec3d		m_r0;		//!< material point position
 	vec3d		m_rt;		//!< current point position
@@ -150,6 +176,23 @@ public:
 
 protected:
 	FEMaterialPointData* m_data;
+
+private:
+	// The data found by ExtractData for each data slot, or null if the slot was not looked 
+	// up yet. Data that was not found is marked by the address of the material point itself.
+	// The slots are filled on first use, which can happen concurrently in the parallel 
+	// element and contact loops. All threads store the same value, so relaxed atomic
+	// access is sufficient. Copies of a material point start with empty slots.
+	struct DATA_SLOTS
+	{
+		std::atomic<void*>	p[MAX_DATA_SLOTS];
+
+		DATA_SLOTS() { clear(); }
+		DATA_SLOTS(const DATA_SLOTS&) { clear(); }
+		DATA_SLOTS& operator = (const DATA_SLOTS&) { clear(); return *this; }
+		void clear() { for (int i = 0; i < MAX_DATA_SLOTS; ++i) p[i].store(nullptr, std::memory_order_relaxed); }
+	};
+	DATA_SLOTS	m_slot;
 };
 
 //-----------------------------------------------------------------------------
@@ -221,15 +264,35 @@ template <class T> inline const T* FEMaterialPointData::ExtractData() const
 }
 
 //-----------------------------------------------------------------------------
+template <class T> inline int FEMaterialPoint::DataSlot()
+{
+	static const int slot = NewDataSlot();
+	return slot;
+}
+
+//-----------------------------------------------------------------------------
+// The data of a material point does not change after it is created (except via Append,
+// which clears the cache), so the result of the search can be cached.
 template <class T> inline T* FEMaterialPoint::ExtractData()
 {
-	return (m_data ? m_data->ExtractData<T>() : nullptr);
+	if (m_data == nullptr) return nullptr;
+
+	const int n = DataSlot<T>();
+	if (n >= MAX_DATA_SLOTS) return m_data->ExtractData<T>();
+
+	void* p = m_slot.p[n].load(std::memory_order_relaxed);
+	if (p == nullptr)
+	{
+		p = const_cast<void*>(static_cast<const void*>(m_data->ExtractData<T>()));
+		m_slot.p[n].store((p ? p : (void*)this), std::memory_order_relaxed);
+	}
+	return (p == (void*)this ? nullptr : static_cast<T*>(p));
 }
 
 //-----------------------------------------------------------------------------
 template <class T> inline const T* FEMaterialPoint::ExtractData() const
 {
-	return (m_data ? m_data->ExtractData<T>() : nullptr);
+	return const_cast<FEMaterialPoint*>(this)->ExtractData<T>();
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,160 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEMaterialPointArena.h"
+#include <new>
+#include <map>
+#include <mutex>
+#include <cstddef>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+// Allocations from an arena have the same alignment as those from the heap.
+const size_t ALIGNMENT = alignof(std::max_align_t);
+
+// the active arena of each thread
+static thread_local FEMaterialPointArena* active_arena = nullptr;
+
+//-----------------------------------------------------------------------------
+// The address ranges of the blocks of all arenas, indexed by their start address. 
+// This is how Free finds the arena of an object. 
+struct ARENA_BLOCK
+{
+	char*					end;
+	FEMaterialPointArena*	arena;
+};
+static std::map<char*, ARENA_BLOCK> arena_blocks;
+static std::mutex arena_mutex;
+
+//-----------------------------------------------------------------------------
+FEMaterialPointArena::Scope::Scope(FEMaterialPointArena* arena)
+{
+	m_prev = active_arena;
+	active_arena = arena;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointArena::Scope::~Scope()
+{
+	active_arena = m_prev;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointArena::FEMaterialPointArena(size_t blockSize) : m_refs(1)
+{
+	m_blockSize = blockSize;
+	m_used = 0;
+	m_objects = 0;
+	m_bytes = 0;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointArena::~FEMaterialPointArena()
+{
+	{
+		std::lock_guard<std::mutex> lock(arena_mutex);
+		for (size_t i = 0; i < m_block.size(); ++i) arena_blocks.erase(m_block[i]);
+	}
+	for (size_t i = 0; i < m_block.size(); ++i) ::operator delete(m_block[i]);
+	m_block.clear();
+	m_blockCap.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointArena::Release()
+{
+	assert(active_arena != this);
+	if (--m_refs == 0) delete this;
+}
+
+//-----------------------------------------------------------------------------
+size_t FEMaterialPointArena::Capacity() const
+{
+	size_t cap = 0;
+	for (size_t i = 0; i < m_blockCap.size(); ++i) cap += m_blockCap[i];
+	return cap;
+}
+
+//-----------------------------------------------------------------------------
+void* FEMaterialPointArena::allocate(size_t n)
+{
+	// see if it fits in the last block
+	if (m_block.empty() || (m_used + n > m_blockCap.back()))
+	{
+		size_t cap = (n > m_blockSize ? n : m_blockSize);
+		char* block = static_cast<char*>(::operator new(cap));
+		m_block.push_back(block);
+		m_blockCap.push_back(cap);
+		m_used = 0;
+
+		std::lock_guard<std::mutex> lock(arena_mutex);
+		arena_blocks[block] = ARENA_BLOCK{ block + cap, this };
+	}
+
+	void* p = m_block.back() + m_used;
+	m_used += n;
+	m_objects++;
+	m_bytes += n;
+	m_refs++;
+	return p;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointArena* FEMaterialPointArena::Find(void* p)
+{
+	char* pc = static_cast<char*>(p);
+	std::lock_guard<std::mutex> lock(arena_mutex);
+	if (arena_blocks.empty()) return nullptr;
+
+	// find the last block that starts at or before p
+	std::map<char*, ARENA_BLOCK>::iterator it = arena_blocks.upper_bound(pc);
+	if (it == arena_blocks.begin()) return nullptr;
+	--it;
+	return (pc < it->second.end ? it->second.arena : nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void* FEMaterialPointArena::Allocate(size_t n)
+{
+	FEMaterialPointArena* arena = active_arena;
+	if (arena == nullptr) return ::operator new(n);
+
+	// round up to keep the next allocation aligned
+	n = ((n + ALIGNMENT - 1) / ALIGNMENT)*ALIGNMENT;
+	return arena->allocate(n);
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointArena::Free(void* p)
+{
+	if (p == nullptr) return;
+	FEMaterialPointArena* arena = Find(p);
+	if (arena == nullptr) ::operator delete(p);
+	else if (--arena->m_refs == 0) delete arena;
+}
@@ -0,0 +1,108 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+#include <atomic>
+#include <stddef.h>
+
+//-----------------------------------------------------------------------------
+//! Arena for the material point objects (FEMaterialPoint and FEMaterialPointData) of
+//! a domain. While an arena is active on a thread (see FEMaterialPointArena::Scope), 
+//! the material point objects that this thread creates are placed one after another 
+//! in large blocks, so that the data of consecutive integration points is contiguous
+//! in memory instead of being scattered over the heap. 
+//! The objects can still be deleted individually. The memory of the arena is released 
+//! when the arena itself was released (see Release) and all its objects were deleted.
+//! 
+//! Note that the arena only changes where the objects are placed, not their layout:
+//! - Memory of deleted objects is not reused, so the arena is meant for objects that are
+//!   created together and live equally long, like the material points of a domain.
+//! - The blocks of all arenas are registered, so that Free can find the arena an object
+//!   belongs to from its address. Objects allocated from the heap carry no extra data.
+//! - There is no structure-of-arrays view of the point data. The materials access the 
+//!   point data through the material point classes, so a second layout would have to
+//!   be kept in sync by every material.
+class FECORE_API FEMaterialPointArena
+{
+public:
+	//! activates an arena on the calling thread for the lifetime of the scope
+	class FECORE_API Scope
+	{
+	public:
+		Scope(FEMaterialPointArena* arena);
+		~Scope();
+
+	private:
+		FEMaterialPointArena*	m_prev;
+	};
+
+public:
+	FEMaterialPointArena(size_t blockSize = 1 << 20);
+
+	//! Release the arena. This must be called by the creator of the arena after it
+	//! is done allocating. The arena deletes itself once all its objects are deleted.
+	void Release();
+
+	//! number of objects allocated
+	int Objects() const { return m_objects; }
+
+	//! total number of bytes in use by the objects (including the alignment padding)
+	size_t Bytes() const { return m_bytes; }
+
+	//! total number of bytes reserved by the arena
+	size_t Capacity() const;
+
+public:
+	//! Allocate n bytes from the active arena of the calling thread, or from the heap 
+	//! when no arena is active.
+	static void* Allocate(size_t n);
+
+	//! free memory that was allocated with Allocate
+	static void Free(void* p);
+
+private:
+	~FEMaterialPointArena();
+	FEMaterialPointArena(const FEMaterialPointArena&) = delete;
+	void operator = (const FEMaterialPointArena&) = delete;
+
+	void* allocate(size_t n);
+
+	//! find the arena that owns the memory at p, or null if it is not in an arena
+	static FEMaterialPointArena* Find(void* p);
+
+private:
+	size_t				m_blockSize;	//!< size of the blocks
+	std::vector<char*>	m_block;		//!< allocated blocks
+	std::vector<size_t>	m_blockCap;		//!< capacity of each block
+	size_t				m_used;			//!< bytes used in the last block
+	int					m_objects;		//!< number of objects allocated
+	size_t				m_bytes;		//!< bytes allocated
+	std::atomic<int>	m_refs;			//!< number of live objects (+1 until the arena is released)
+};
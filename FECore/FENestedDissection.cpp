@@ -0,0 +1,565 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FENestedDissection.h"
+#include "FENodeNodeList.h"
+#include "FEMesh.h"
+#include <algorithm>
+#include <queue>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// graphs with less vertices than this are not coarsened any further
+#define COARSEST_SIZE	64
+
+// allowed imbalance of a bisection (relative to half the total weight)
+#define MAX_IMBALANCE	0.05
+
+// max number of moves without improvement in a refinement pass
+#define MAX_BAD_MOVES	64
+
+//-----------------------------------------------------------------------------
+// weighted graph that is used during the bisection
+struct NDGraph
+{
+	int		n = 0;
+	vector<int>	xadj, adj;
+	vector<int>	ewgt;	// edge weights
+	vector<int>	vwgt;	// vertex weights
+	int		wtotal = 0;	// total vertex weight
+};
+
+//-----------------------------------------------------------------------------
+// simple (deterministic) random number generator
+static unsigned int nd_rand(unsigned int& seed)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return (seed >> 8);
+}
+
+//-----------------------------------------------------------------------------
+// Coarsens the graph g by heavy-edge matching. On return, cmap maps the vertices of g 
+// to the vertices of the coarse graph gc. Returns the number of coarse vertices.
+static int nd_coarsen(const NDGraph& g, NDGraph& gc, vector<int>& cmap, unsigned int& seed)
+{
+	int n = g.n;
+	cmap.assign(n, -1);
+
+	// visit vertices in random order
+	vector<int> order(n);
+	for (int i = 0; i < n; ++i) order[i] = i;
+	for (int i = n - 1; i > 0; --i) swap(order[i], order[nd_rand(seed) % (i + 1)]);
+
+	vector<int> match(n, -1);
+	int nc = 0;
+	for (int k = 0; k < n; ++k)
+	{
+		int v = order[k];
+		if (match[v] >= 0) continue;
+		int u = v, wmax = -1;
+		for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+		{
+			int w = g.adj[j];
+			if ((match[w] < 0) && (g.ewgt[j] > wmax)) { wmax = g.ewgt[j]; u = w; }
+		}
+		match[v] = u;
+		match[u] = v;
+		cmap[v] = cmap[u] = nc++;
+	}
+
+	// build the coarse graph
+	gc.n = nc;
+	gc.wtotal = g.wtotal;
+	gc.vwgt.assign(nc, 0);
+	gc.xadj.assign(nc + 1, 0);
+	gc.adj.clear();
+	gc.ewgt.clear();
+	gc.adj.reserve(g.adj.size());
+	gc.ewgt.reserve(g.adj.size());
+	vector<int> pos(nc, -1);
+	for (int c = 0, k = 0; k < n; ++k)
+	{
+		int v = order[k];
+		if (cmap[v] != c) continue;
+		int u = match[v];
+		int n0 = (int)gc.adj.size();
+		gc.vwgt[c] = g.vwgt[v] + (u != v ? g.vwgt[u] : 0);
+		for (int l = 0; l < 2; ++l)
+		{
+			int w = (l == 0 ? v : u);
+			if ((l == 1) && (u == v)) break;
+			for (int j = g.xadj[w]; j < g.xadj[w + 1]; ++j)
+			{
+				int cw = cmap[g.adj[j]];
+				if (cw == c) continue;
+				if ((pos[cw] >= n0) && (pos[cw] < (int)gc.adj.size()) && (gc.adj[pos[cw]] == cw)) gc.ewgt[pos[cw]] += g.ewgt[j];
+				else
+				{
+					pos[cw] = (int)gc.adj.size();
+					gc.adj.push_back(cw);
+					gc.ewgt.push_back(g.ewgt[j]);
+				}
+			}
+		}
+		gc.xadj[c + 1] = (int)gc.adj.size();
+		c++;
+	}
+
+	return nc;
+}
+
+//-----------------------------------------------------------------------------
+// calculates the edge cut of a bisection
+static int nd_edgecut(const NDGraph& g, const vector<int>& part)
+{
+	int cut = 0;
+	for (int v = 0; v < g.n; ++v)
+		for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+			if (part[g.adj[j]] != part[v]) cut += g.ewgt[j];
+	return cut / 2;
+}
+
+//-----------------------------------------------------------------------------
+// Fiduccia-Mattheyses refinement of a bisection. Vertices are moved in order of 
+// decreasing gain, as long as the balance constraint is satisfied. After each pass
+// the moves after the best cut that was encountered are undone.
+static void nd_refine(const NDGraph& g, vector<int>& part, int npasses)
+{
+	int n = g.n;
+	int maxw = (int)(0.5*g.wtotal*(1.0 + MAX_IMBALANCE)) + 1;
+	for (int v = 0; v < n; ++v) if (g.vwgt[v] >= maxw) maxw = g.vwgt[v] + 1;
+
+	vector<int> gain(n);
+	vector<char> locked(n);
+	vector<int> moves;
+	for (int pass = 0; pass < npasses; ++pass)
+	{
+		int pw[2] = { 0, 0 };
+		for (int v = 0; v < n; ++v) pw[part[v]] += g.vwgt[v];
+
+		priority_queue< pair<int, int> > heap;
+		for (int v = 0; v < n; ++v)
+		{
+			int ed = 0, id = 0;
+			for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+			{
+				if (part[g.adj[j]] == part[v]) id += g.ewgt[j]; else ed += g.ewgt[j];
+			}
+			gain[v] = ed - id;
+			locked[v] = 0;
+			if (ed > 0) heap.push(pair<int, int>(gain[v], v));
+		}
+
+		int cut = nd_edgecut(g, part);
+		int bestCut = cut;
+		int bestBal = abs(pw[0] - pw[1]);
+		size_t best = 0;
+		int nbad = 0;
+		moves.clear();
+		while ((heap.empty() == false) && (nbad < MAX_BAD_MOVES))
+		{
+			int gv = heap.top().first;
+			int v = heap.top().second;
+			heap.pop();
+			if (locked[v] || (gv != gain[v])) continue;
+
+			int from = part[v], to = 1 - from;
+			if (pw[to] + g.vwgt[v] > maxw) continue;
+
+			// move the vertex
+			part[v] = to;
+			pw[from] -= g.vwgt[v];
+			pw[to] += g.vwgt[v];
+			cut -= gv;
+			locked[v] = 1;
+			moves.push_back(v);
+
+			for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+			{
+				int u = g.adj[j];
+				if (part[u] == to) gain[u] -= 2 * g.ewgt[j]; else gain[u] += 2 * g.ewgt[j];
+				if (locked[u] == 0) heap.push(pair<int, int>(gain[u], u));
+			}
+
+			int bal = abs(pw[0] - pw[1]);
+			if ((cut < bestCut) || ((cut == bestCut) && (bal < bestBal)))
+			{
+				bestCut = cut;
+				bestBal = bal;
+				best = moves.size();
+				nbad = 0;
+			}
+			else nbad++;
+		}
+
+		// undo the moves after the best cut
+		for (size_t i = best; i < moves.size(); ++i) part[moves[i]] = 1 - part[moves[i]];
+
+		if (best == 0) break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Initial bisection of the coarsest graph by greedy graph growing from a few
+// different seeds. The bisection with the smallest (refined) edge cut is returned.
+static void nd_initial(const NDGraph& g, vector<int>& part, unsigned int& seed)
+{
+	int n = g.n;
+	part.assign(n, 1);
+	if (n < 2) return;
+
+	vector<int> trial(n), queue(n);
+	int bestCut = -1;
+	for (int ntry = 0; ntry < 4; ++ntry)
+	{
+		// grow part 0 from the seed until it contains half the weight
+		trial.assign(n, 1);
+		int root = nd_rand(seed) % n;
+		int qh = 0, qt = 0, w = 0;
+		queue[qt++] = root; trial[root] = 0; w += g.vwgt[root];
+		while (2 * w < g.wtotal)
+		{
+			if (qh == qt)
+			{
+				// the graph is not connected, so start a new region
+				int v = 0;
+				while (trial[v] == 0) v++;
+				queue[qt++] = v; trial[v] = 0; w += g.vwgt[v];
+				continue;
+			}
+			int v = queue[qh++];
+			for (int j = g.xadj[v]; (j < g.xadj[v + 1]) && (2 * w < g.wtotal); ++j)
+			{
+				int u = g.adj[j];
+				if (trial[u] == 1) { trial[u] = 0; w += g.vwgt[u]; queue[qt++] = u; }
+			}
+		}
+
+		nd_refine(g, trial, 4);
+
+		int cut = nd_edgecut(g, trial);
+		if ((bestCut < 0) || (cut < bestCut)) { bestCut = cut; part = trial; }
+	}
+}
+
+//-----------------------------------------------------------------------------
+// multilevel bisection of graph g
+static void nd_bisect(const NDGraph& g, vector<int>& part, unsigned int& seed)
+{
+	// coarsen
+	vector<NDGraph> G;
+	vector< vector<int> > cmap;
+	const NDGraph* gl = &g;
+	while (gl->n > COARSEST_SIZE)
+	{
+		NDGraph gc;
+		vector<int> map;
+		int nc = nd_coarsen(*gl, gc, map, seed);
+		if (nc > 0.9*gl->n) break;
+		G.push_back(gc);
+		cmap.push_back(map);
+		gl = &G.back();
+	}
+
+	// initial partition
+	vector<int> cpart;
+	nd_initial(*gl, cpart, seed);
+
+	// uncoarsen and refine
+	for (int l = (int)G.size() - 1; l >= 0; --l)
+	{
+		const NDGraph& gf = (l == 0 ? g : G[l - 1]);
+		const vector<int>& map = cmap[l];
+		vector<int> fpart(gf.n);
+		for (int i = 0; i < gf.n; ++i) fpart[i] = cpart[map[i]];
+		nd_refine(gf, fpart, 4);
+		cpart.swap(fpart);
+	}
+	part.swap(cpart);
+}
+
+//-----------------------------------------------------------------------------
+// Finds a vertex separator from the edge cut of the bisection by a greedy vertex cover
+// of the cut edges. Vertices in the separator are assigned to part 2.
+static void nd_separator(const NDGraph& g, vector<int>& part)
+{
+	int n = g.n;
+	vector<int> cnt(n, 0);
+	priority_queue< pair<int, int> > heap;
+	for (int v = 0; v < n; ++v)
+	{
+		for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+			if (part[g.adj[j]] != part[v]) cnt[v]++;
+		if (cnt[v] > 0) heap.push(pair<int, int>(cnt[v], v));
+	}
+
+	while (heap.empty() == false)
+	{
+		int c = heap.top().first;
+		int v = heap.top().second;
+		heap.pop();
+		if ((c == 0) || (c != cnt[v]) || (part[v] == 2)) continue;
+
+		int p = part[v];
+		part[v] = 2;
+		cnt[v] = 0;
+		for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+		{
+			int u = g.adj[j];
+			if ((part[u] != 2) && (part[u] != p))
+			{
+				cnt[u]--;
+				if (cnt[u] > 0) heap.push(pair<int, int>(cnt[u], u));
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Nested dissection of a graph with vertex weights. 
+static void nd_order(int n, const vector<int>& xadj, const vector<int>& adj, const vector<int>& vwgt, int leafSize, vector<int>& iperm)
+{
+	iperm.resize(n);
+	for (int i = 0; i < n; ++i) iperm[i] = i;
+	if (n == 0) return;
+
+	unsigned int seed = 12345u;
+
+	vector<int> loc(n, -1);		// local index of vertex in subgraph (or -1)
+	vector<int> queue(n);
+	vector<int> tmp(n);
+
+	// ranges of iperm that still need to be split
+	vector< pair<int, int> > jobs;
+	jobs.push_back(pair<int, int>(0, n));
+	while (jobs.empty() == false)
+	{
+		int lo = jobs.back().first;
+		int hi = jobs.back().second;
+		jobs.pop_back();
+		int nv = hi - lo;
+		if (nv < 2) continue;
+
+		int wtotal = 0;
+		for (int i = lo; i < hi; ++i) wtotal += vwgt[iperm[i]];
+		if (wtotal <= leafSize) continue;
+
+		// local numbering of the subgraph
+		for (int i = 0; i < nv; ++i) loc[iperm[lo + i]] = i;
+
+		// if the subgraph is not connected, split off the first component
+		int qh = 0, qt = 0;
+		queue[qt++] = iperm[lo];
+		vector<char> visited(nv, 0);
+		visited[0] = 1;
+		while (qh < qt)
+		{
+			int v = queue[qh++];
+			for (int j = xadj[v]; j < xadj[v + 1]; ++j)
+			{
+				int lw = loc[adj[j]];
+				if ((lw >= 0) && (visited[lw] == 0)) { visited[lw] = 1; queue[qt++] = adj[j]; }
+			}
+		}
+		if (qt < nv)
+		{
+			int m = lo;
+			for (int i = 0; i < qt; ++i) tmp[m++] = queue[i];
+			for (int i = 0; i < nv; ++i) if (visited[i] == 0) tmp[m++] = iperm[lo + i];
+			for (int i = 0; i < nv; ++i) loc[iperm[lo + i]] = -1;
+			for (int i = lo; i < hi; ++i) iperm[i] = tmp[i];
+			jobs.push_back(pair<int, int>(lo, lo + qt));
+			jobs.push_back(pair<int, int>(lo + qt, hi));
+			continue;
+		}
+
+		// build the local graph
+		NDGraph g;
+		g.n = nv;
+		g.wtotal = wtotal;
+		g.vwgt.resize(nv);
+		g.xadj.assign(nv + 1, 0);
+		for (int i = 0; i < nv; ++i)
+		{
+			int v = iperm[lo + i];
+			g.vwgt[i] = vwgt[v];
+			for (int j = xadj[v]; j < xadj[v + 1]; ++j)
+			{
+				int lw = loc[adj[j]];
+				if ((lw >= 0) && (lw != i)) g.adj.push_back(lw);
+			}
+			g.xadj[i + 1] = (int)g.adj.size();
+		}
+		g.ewgt.assign(g.adj.size(), 1);
+		for (int i = 0; i < nv; ++i) loc[iperm[lo + i]] = -1;
+
+		// find the separator
+		vector<int> part;
+		nd_bisect(g, part, seed);
+		nd_separator(g, part);
+
+		// reorder range as [part 0, part 1, separator]
+		int na = 0, nb = 0;
+		for (int i = 0; i < nv; ++i) { if (part[i] == 0) na++; else if (part[i] == 1) nb++; }
+		if ((na == 0) || (nb == 0)) continue;
+
+		int ia = lo, ib = lo + na, is = lo + na + nb;
+		for (int i = 0; i < nv; ++i)
+		{
+			int v = iperm[lo + i];
+			if (part[i] == 0) tmp[ia++] = v;
+			else if (part[i] == 1) tmp[ib++] = v;
+			else tmp[is++] = v;
+		}
+		for (int i = lo; i < hi; ++i) iperm[i] = tmp[i];
+
+		jobs.push_back(pair<int, int>(lo, lo + na));
+		jobs.push_back(pair<int, int>(lo + na, lo + na + nb));
+	}
+}
+
+//=============================================================================
+FENestedDissection::FENestedDissection()
+{
+	m_leafSize = 32;
+}
+
+//-----------------------------------------------------------------------------
+// Vertices with the same adjacency (e.g. the equations of a node) are merged first, 
+// which makes the dissection of matrix graphs considerably cheaper.
+void FENestedDissection::Apply(int n, const vector<int>& xadj, const vector<int>& adj, vector<int>& iperm)
+{
+	// find vertices with identical adjacency (including the vertex itself)
+	vector<long long> key(n);
+	vector<int> order(n);
+	for (int i = 0; i < n; ++i)
+	{
+		long long h = i;
+		for (int j = xadj[i]; j < xadj[i + 1]; ++j) h += adj[j];
+		key[i] = h;
+		order[i] = i;
+	}
+	sort(order.begin(), order.end(), [&](int a, int b) {
+		int da = xadj[a + 1] - xadj[a], db = xadj[b + 1] - xadj[b];
+		if (da != db) return da < db;
+		if (key[a] != key[b]) return key[a] < key[b];
+		return a < b;
+	});
+
+	vector<int> rep(n, -1);	// representative of each vertex
+	vector<int> mark(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		int i = order[k];
+		if (rep[i] >= 0) continue;
+		rep[i] = i;
+		int di = xadj[i + 1] - xadj[i];
+		bool marked = false;
+		for (int l = k + 1; l < n; ++l)
+		{
+			int j = order[l];
+			if ((xadj[j + 1] - xadj[j] != di) || (key[j] != key[i])) break;
+			if (rep[j] >= 0) continue;
+			if (marked == false)
+			{
+				mark[i] = i;
+				for (int m = xadj[i]; m < xadj[i + 1]; ++m) mark[adj[m]] = i;
+				marked = true;
+			}
+			bool same = (mark[j] == i);
+			for (int m = xadj[j]; same && (m < xadj[j + 1]); ++m) same = (mark[adj[m]] == i);
+			if (same) rep[j] = i;
+		}
+	}
+
+	// build the compressed graph
+	vector<int> cid(n, -1);
+	int nc = 0;
+	for (int i = 0; i < n; ++i) if (rep[i] == i) cid[i] = nc++;
+	vector<int> vwgt(nc, 0);
+	for (int i = 0; i < n; ++i) vwgt[cid[rep[i]]]++;
+
+	vector<int> cxadj(nc + 1, 0), cadj;
+	cadj.reserve(adj.size());
+	for (int i = 0; i < n; ++i)
+	{
+		if (rep[i] != i) continue;
+		int ci = cid[i];
+		for (int j = xadj[i]; j < xadj[i + 1]; ++j)
+		{
+			int w = adj[j];
+			if (rep[w] == w) cadj.push_back(cid[w]);
+		}
+		cxadj[ci + 1] = (int)cadj.size();
+	}
+
+	// order the compressed graph
+	vector<int> ciperm;
+	nd_order(nc, cxadj, cadj, vwgt, (m_leafSize > 1 ? m_leafSize : 1), ciperm);
+
+	// expand to the original vertices
+	vector<int> cp(nc + 1, 0), members(n);
+	for (int i = 0; i < n; ++i) cp[cid[rep[i]] + 1]++;
+	for (int i = 0; i < nc; ++i) cp[i + 1] += cp[i];
+	vector<int> pos(cp.begin(), cp.end() - 1);
+	for (int i = 0; i < n; ++i) members[pos[cid[rep[i]]]++] = i;
+
+	iperm.resize(n);
+	int k = 0;
+	for (int c = 0; c < nc; ++c)
+	{
+		int v = ciperm[c];
+		for (int m = cp[v]; m < cp[v + 1]; ++m) iperm[k++] = members[m];
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! This function applies the nested dissection algorithm to the node graph of a mesh.
+//! The new node number is stored in P. To be precise, P stores for each new
+//! node the old node that corresponds to this node.
+void FENestedDissection::Apply(FEMesh& mesh, vector<int>& P)
+{
+	int N = mesh.Nodes();
+
+	// create the node-node list
+	FENodeNodeList NL;
+	NL.Create(mesh);
+
+	// convert to compressed format
+	vector<int> xadj(N + 1, 0), adj;
+	for (int i = 0; i < N; ++i)
+	{
+		int nval = NL.Valence(i);
+		int* pn = NL.NodeList(i);
+		for (int j = 0; j < nval; ++j) if (pn[j] != i) adj.push_back(pn[j]);
+		xadj[i + 1] = (int)adj.size();
+	}
+
+	Apply(N, xadj, adj, P);
+}
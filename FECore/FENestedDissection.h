@@ -0,0 +1,63 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include "fecore_api.h"
+
+class FEMesh;
+
+//-----------------------------------------------------------------------------
+//! This class calculates a fill-reducing ordering with multilevel nested dissection.
+
+//! The graph is recursively split in two parts by a vertex separator, which is 
+//! numbered after the two parts. Each bisection is found with a multilevel scheme:
+//! the graph is coarsened by heavy-edge matching, bisected on the coarsest level 
+//! by greedy graph growing, and the edge cut is refined with Fiduccia-Mattheyses
+//! passes while the partition is projected back to the original graph. The vertex
+//! separator is then a (greedy) vertex cover of the cut edges.
+//! In contrast to FENodeReorder, which minimizes the bandwidth (which suits the 
+//! skyline solver), this ordering reduces the fill-in of sparse direct solvers.
+
+class FECORE_API FENestedDissection
+{
+public:
+	//! default constructor
+	FENestedDissection();
+
+	//! calculates the permutation vector for the nodes of a mesh
+	//! On return, P stores for each new node the old node that corresponds to this node.
+	void Apply(FEMesh& mesh, std::vector<int>& P);
+
+	//! calculates the ordering of a graph, stored in compressed format (without self-loops).
+	//! On return, iperm[k] is the vertex that is numbered k.
+	void Apply(int n, const std::vector<int>& xadj, const std::vector<int>& adj, std::vector<int>& iperm);
+
+public:
+	int		m_leafSize;		//!< subgraphs that are smaller than this are not dissected further
+};
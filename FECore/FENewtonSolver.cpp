@@ -57,6 +57,7 @@ BEGIN_FECORE_CLASS(FENewtonSolver, FESolver)
 		ADD_PARAMETER(m_breformtimestep     , "reform_each_time_step");
 		ADD_PARAMETER(m_breformAugment      , "reform_augment");
 		ADD_PARAMETER(m_bdivreform          , "diverge_reform");
+		ADD_PARAMETER(m_breuseProfile       , "reuse_matrix_profile");
 //		ADD_PARAMETER(m_bdoreforms          , "do_reforms"  );
 		ADD_PARAMETER(m_Rmin, FE_RANGE_GREATER_OR_EQUAL(0.0), "min_residual");
 		ADD_PARAMETER(m_Rmax, FE_RANGE_GREATER_OR_EQUAL(0.0), "max_residual");
@@ -99,6 +100,7 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
 	m_force_partition = 0;
 	m_breformtimestep = true;
 	m_breformAugment = false;
+	m_breuseProfile = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -275,6 +277,13 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 {
 	{
 		TRACK_TIME(TimerID::Timer_Reform);
+
+		// When only the "dynamic" part of the profile (e.g. contact) changed, we first
+		// check if the current matrix can still store it. If so, we can reuse the matrix
+		// and the linear solver's symbolic factorization.
+		bool bupdate = ((breset == false) && m_breuseProfile);
+		if (bupdate && (m_pK->UpdateProfile(GetFEModel(), m_neq) == false)) return true;
+
 		// clean up the solver
 		m_plinsolve->Destroy();
 
@@ -283,7 +292,10 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 
 		// create the stiffness matrix
 		feLog("===== reforming stiffness matrix:\n");
-		if (m_pK->Create(GetFEModel(), m_neq, breset) == false)
+		bool bret = true;
+		if (bupdate) m_pK->CreateFromProfile(GetFEModel());
+		else bret = m_pK->Create(GetFEModel(), m_neq, breset);
+		if (bret == false)
 		{
 			feLogError("An error occured while building the stiffness matrix\n\n");
 			return false;
@@ -367,6 +379,10 @@ bool FENewtonSolver::AllocateLinearSystem()
 		m_plinsolve->SetPartitions(m_part);
 	}
 
+	// pass the equation ordering to the linear solver
+	vector<int> perm;
+	if (EquationOrdering(perm)) m_plinsolve->SetPermutation(perm);
+
 	feLogInfo("Selecting linear solver %s", m_plinsolve->GetTypeStr());
 
 	Matrix_Type mtype = MatrixType();
@@ -404,6 +420,7 @@ bool FENewtonSolver::AllocateLinearSystem()
 		feLogError("Failed allocating stiffness matrix.");
 		return false;
 	}
+	m_pK->UseScatterMaps(m_bscatter);
 
 	return true;
 }
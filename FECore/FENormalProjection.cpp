@@ -29,19 +29,31 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FENormalProjection.h"
 #include "FEMesh.h"
+#include "FEElemElemList.h"
 
 //-----------------------------------------------------------------------------
 FENormalProjection::FENormalProjection(FESurface& s) : m_surf(s)
 {
 	m_tol = 0.0;
 	m_rad = 0.0;
+	m_maxWalk = 8;
+	m_pbvh = nullptr;
+	m_pEEL = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 void FENormalProjection::Init()
 {
-	m_OT.Attach(&m_surf);
-	m_OT.Init(m_tol);
+	if (m_pbvh)
+	{
+		assert(m_pbvh->GetSurface() == &m_surf);
+		m_pbvh->Update(m_tol);
+	}
+	else
+	{
+		m_bvh.Attach(&m_surf);
+		m_bvh.Build(m_tol);
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -53,12 +65,13 @@ void FENormalProjection::Init()
 FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	vector<int> selist;
+	const FESurfaceBVH& bvh = (m_pbvh ? *m_pbvh : m_bvh);
+	bvh.FindRayCandidates(r, n, selist, m_rad);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
+	vector<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g = 0;
 	FESurfaceElement* pei = 0;
@@ -97,12 +110,13 @@ FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	vector<int> selist;
+	const FESurfaceBVH& bvh = (m_pbvh ? *m_pbvh : m_bvh);
+	bvh.FindRayCandidates(r, n, selist, m_rad);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
+	vector<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g = 0;
 	FESurfaceElement* pei = 0;
@@ -132,6 +146,98 @@ FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 	return 0;
 }
 
+//-----------------------------------------------------------------------------
+// distance of the center of a facet to the line through r with unit direction t
+static double RayDistance(FESurface& surf, FESurfaceElement& el, const vec3d& r, const vec3d& t)
+{
+	FEMesh& mesh = *surf.GetMesh();
+	int N = el.Nodes();
+	vec3d c(0, 0, 0);
+	if (!surf.IsShellBottom()) for (int i = 0; i < N; ++i) c += mesh.Node(el.m_node[i]).m_rt;
+	else for (int i = 0; i < N; ++i) c += mesh.Node(el.m_node[i]).st();
+	c /= (double) N;
+
+	vec3d d = c - r;
+	d -= t*(d*t);
+	return d.norm();
+}
+
+//-----------------------------------------------------------------------------
+//! This function finds the element which is intersected by the ray (r,n), starting
+//! from the facet pe. The walk moves to the neighbor whose center is closest to the
+//! ray until a facet is intersected. Only facets that pass the same search radius 
+//! test as the candidates of Project are accepted. Since the ray can intersect more 
+//! than one facet near the edges, the walk then continues to the neighbor with the 
+//! smallest gap until none of the neighbors is a better intersection. This gives the
+//! same facet as Project, unless the surface folds back and is intersected again 
+//! away from this facet, in which case the intersection closest to the starting 
+//! facet is returned. If the walk gets stuck or takes too many steps, the global 
+//! search is done instead.
+//!
+FESurfaceElement* FENormalProjection::ProjectFrom(FESurfaceElement* pe, const vec3d& r, const vec3d& n, double rs[2])
+{
+	if ((pe == nullptr) || (m_pEEL == nullptr)) return Project(r, n, rs);
+
+	const FESurfaceBVH& bvh = (m_pbvh ? *m_pbvh : m_bvh);
+	auto intersect = [&](FESurfaceElement* pf, double rsl[2], double& g) {
+		return (bvh.IsRayCandidate(pf->m_lid, r, n, m_rad) && m_surf.Intersect(*pf, r, n, rsl, g, m_tol) && (g > -m_rad));
+	};
+
+	vec3d t = n; t.unit();
+	double d = RayDistance(m_surf, *pe, r, t);
+	double rsl[2], g;
+	for (int nstep = 0; nstep <= m_maxWalk; ++nstep)
+	{
+		int nf = pe->facet_edges();
+		if (intersect(pe, rsl, g))
+		{
+			FESurfaceElement* pei = pe;
+			rs[0] = rsl[0];
+			rs[1] = rsl[1];
+			for (int nbest = 0; nbest <= m_maxWalk; ++nbest)
+			{
+				FESurfaceElement* pbest = nullptr;
+				for (int k = 0; k < pei->facet_edges(); ++k)
+				{
+					FESurfaceElement* pn = static_cast<FESurfaceElement*>(m_pEEL->Neighbor(pei->m_lid, k));
+					double gn;
+					if (pn && intersect(pn, rsl, gn))
+					{
+						FESurfaceElement* pcur = (pbest ? pbest : pei);
+						if ((gn < g) || ((gn == g) && (pn->m_lid < pcur->m_lid)))
+						{
+							g = gn;
+							rs[0] = rsl[0];
+							rs[1] = rsl[1];
+							pbest = pn;
+						}
+					}
+				}
+				if (pbest == nullptr) break;
+				pei = pbest;
+			}
+			return pei;
+		}
+
+		// move to the neighbor that is closest to the ray
+		FESurfaceElement* pnext = nullptr;
+		for (int k = 0; k < nf; ++k)
+		{
+			FESurfaceElement* pn = static_cast<FESurfaceElement*>(m_pEEL->Neighbor(pe->m_lid, k));
+			if (pn)
+			{
+				double dn = RayDistance(m_surf, *pn, r, t);
+				if (dn < d) { d = dn; pnext = pn; }
+			}
+		}
+		if (pnext == nullptr) break;
+		pe = pnext;
+	}
+
+	// the walk failed, so do a global search
+	return Project(r, n, rs);
+}
+
 //-----------------------------------------------------------------------------
 //! This function finds the element which is intersected by the ray (r,n).
 //! It returns a pointer to the element, as well as the isoparametric coordinates
@@ -140,15 +246,16 @@ FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, double rs[2], int* pei)
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	vector<int> selist;
+	const FESurfaceBVH& bvh = (m_pbvh ? *m_pbvh : m_bvh);
+	bvh.FindRayCandidates(r, n, selist, m_rad);
 
 	double g, gmax = -1e99, r2[2] = {rs[0], rs[1]};
 	int imin = -1;
 	FESurfaceElement* pme = 0;
 
 	// loop over all surface element
-	set<int>::iterator it;
+	vector<int>::iterator it;
 	for (it = selist.begin(); it != selist.end(); ++it)
 	{
 		FESurfaceElement& el = m_surf.Element(*it);
@@ -28,7 +28,9 @@ SOFTWARE.*/
 
 #pragma once
 #include "FESurface.h"
-#include "FEOctree.h"
+#include "FESurfaceBVH.h"
+
+class FEElemElemList;
 
 //-----------------------------------------------------------------------------
 //! This class calculates the normal projection on to a surface.
@@ -42,6 +44,13 @@ public:
 	// initialization
 	void Init();
 
+	//! Use a persistent search tree instead of building a new one in Init. 
+	//! The tree must be attached to the same surface. Init will refit the tree.
+	void SetSearchTree(FESurfaceBVH* bvh) { m_pbvh = bvh; }
+
+	//! Set the facet neighbor list of the surface. This is needed for ProjectFrom.
+	void SetNeighborList(FEElemElemList* EEL) { m_pEEL = EEL; }
+
 	void SetTolerance(double tol) { m_tol = tol; }
 	void SetSearchRadius(double srad) { m_rad = srad; }
 
@@ -49,6 +58,12 @@ public:
 	//! find the intersection of a ray with the surface
 	FESurfaceElement* Project(vec3d r, vec3d n, double rs[2]);
 	FESurfaceElement* Project2(vec3d r, vec3d n, double rs[2]);
+
+	//! Same as Project, but the search starts at the facet pe (e.g. the facet of a previous 
+	//! projection) and walks across neighboring facets towards the ray. The global search
+	//! is only done when the walk does not find an intersection within a few steps.
+	FESurfaceElement* ProjectFrom(FESurfaceElement* pe, const vec3d& r, const vec3d& n, double rs[2]);
+
 	FESurfaceElement* Project3(const vec3d& r, const vec3d& n, double rs[2], int* pei = 0);
 
 	vec3d Project(const vec3d& r, const vec3d& N);
@@ -57,8 +72,11 @@ public:
 private:
 	double	m_tol;	//!< projection tolerance
 	double	m_rad;	//!< search radius
+	int		m_maxWalk;	//!< max nr of steps of a facet walk
 
 private:
-	FESurface&	m_surf;	//!< the target surface
-	FEOctree	m_OT;	//!< used to optimize ray-surface intersections
+	FESurface&		m_surf;	//!< the target surface
+	FESurfaceBVH	m_bvh;	//!< used to optimize ray-surface intersections
+	FESurfaceBVH*	m_pbvh;	//!< persistent search tree (if set)
+	FEElemElemList*	m_pEEL;	//!< facet neighbor list (if set)
 };
@@ -32,6 +32,8 @@ SOFTWARE.*/
 #include "tools.h"
 #include "log.h"
 #include "FEModel.h"
+#include "FEElementScratch.h"
+#include "FESolidElementKernel.h"
 
 //-----------------------------------------------------------------------------
 FESolidDomain::FESolidDomain(FEModel* pfem) : FEDomain(FE_DOMAIN_SOLID, pfem), m_dofU(pfem), m_dofSU(pfem)
@@ -45,6 +47,7 @@ FESolidDomain::FESolidDomain(FEModel* pfem) : FEDomain(FE_DOMAIN_SOLID, pfem), m
 		m_dofSU.AddDof(pfem->GetDOFIndex("sy"));
 		m_dofSU.AddDof(pfem->GetDOFIndex("sz"));
 	}
+	m_kernel = FE_ELEM_INVALID_TYPE;
 }
 
 //-----------------------------------------------------------------------------
@@ -95,6 +98,7 @@ void FESolidDomain::CopyFrom(FEMeshPartition* pd)
 	FEDomain::CopyFrom(pd);
 	FESolidDomain* psd = dynamic_cast<FESolidDomain*>(pd);
     m_Elem = psd->m_Elem;
+	m_kernel = psd->m_kernel;
 	ForEachElement([=](FEElement& el) { el.SetMeshPartition(this); });
 }
 
@@ -105,6 +109,18 @@ bool FESolidDomain::Init()
 	// base class first
 	if (FEDomain::Init() == false) return false;
 
+	// Select the specialized kernels. This requires that all elements have the same type.
+	m_kernel = FE_ELEM_INVALID_TYPE;
+	if (Elements() > 0)
+	{
+		int etype = m_Elem[0].Type();
+		for (int i = 1; i < Elements(); ++i)
+		{
+			if (m_Elem[i].Type() != etype) { etype = FE_ELEM_INVALID_TYPE; break; }
+		}
+		if (HasSolidElementKernel(etype)) m_kernel = etype;
+	}
+
 	// init solid element data
 	// TODO: In principle I could parallelize this, but right now this cannot be done
 	//       because of the try block. 
@@ -500,31 +516,8 @@ double FESolidDomain::defgrad(FESolidElement &el, mat3d &F, int n)
 	double *Gtn = el.Gt(n);
 
     // calculate deformation gradient
-	F[0][0] = F[0][1] = F[0][2] = 0;
-    F[1][0] = F[1][1] = F[1][2] = 0;
-    F[2][0] = F[2][1] = F[2][2] = 0;
 	int neln = el.Nodes();
-	for (int i = 0; i<neln; ++i)
-    {
-        double Gri = Grn[i];
-        double Gsi = Gsn[i];
-        double Gti = Gtn[i];
-        
-        double x = r[i].x;
-        double y = r[i].y;
-        double z = r[i].z;
-        
-        // calculate global gradient of shape functions
-        // note that we need the transposed of Ji, not Ji itself !
-        double GX = Ji[0][0]*Gri+Ji[1][0]*Gsi+Ji[2][0]*Gti;
-        double GY = Ji[0][1]*Gri+Ji[1][1]*Gsi+Ji[2][1]*Gti;
-        double GZ = Ji[0][2]*Gri+Ji[1][2]*Gsi+Ji[2][2]*Gti;
-        
-        // calculate deformation gradient F
-        F[0][0] += GX*x; F[0][1] += GY*x; F[0][2] += GZ*x;
-        F[1][0] += GX*y; F[1][1] += GY*y; F[1][2] += GZ*y;
-        F[2][0] += GX*z; F[2][1] += GY*z; F[2][2] += GZ*z;
-    }
+	FE_SOLID_KERNEL_DISPATCH(m_kernel, FESolidElementKernel, ::defgrad(neln, Ji, Grn, Gsn, Gtn, r, F));
     
     double D = F.det();
     if (D <= 0) throw NegativeJacobian(el.GetID(), n, D, &el);
@@ -1196,48 +1189,7 @@ double FESolidDomain::invjact(FESolidElement& el, double Ji[3][3], int n)
     vec3d rt[FEElement::MAX_NODES];
 	GetCurrentNodalCoordinates(el, rt);
 
-    // calculate jacobian
-    double J[3][3] = {0};
-	int neln = el.Nodes();
-	for (int i = 0; i<neln; ++i)
-    {
-        const double& Gri = el.Gr(n)[i];
-        const double& Gsi = el.Gs(n)[i];
-        const double& Gti = el.Gt(n)[i];
-        
-        const double& x = rt[i].x;
-        const double& y = rt[i].y;
-        const double& z = rt[i].z;
-        
-        J[0][0] += Gri*x; J[0][1] += Gsi*x; J[0][2] += Gti*x;
-        J[1][0] += Gri*y; J[1][1] += Gsi*y; J[1][2] += Gti*y;
-        J[2][0] += Gri*z; J[2][1] += Gsi*z; J[2][2] += Gti*z;
-    }
-    
-    // calculate the determinant
-    double det =  J[0][0]*(J[1][1]*J[2][2] - J[1][2]*J[2][1])
-				+ J[0][1]*(J[1][2]*J[2][0] - J[2][2]*J[1][0])
-				+ J[0][2]*(J[1][0]*J[2][1] - J[1][1]*J[2][0]);
-    
-    // make sure the determinant is positive
-    if (det <= 0) throw NegativeJacobian(el.GetID(), n+1, det);
-    
-    // calculate inverse jacobian
-    double deti = 1.0 / det;
-				
-    Ji[0][0] =  deti*(J[1][1]*J[2][2] - J[1][2]*J[2][1]);
-    Ji[1][0] =  deti*(J[1][2]*J[2][0] - J[1][0]*J[2][2]);
-    Ji[2][0] =  deti*(J[1][0]*J[2][1] - J[1][1]*J[2][0]);
-    
-    Ji[0][1] =  deti*(J[0][2]*J[2][1] - J[0][1]*J[2][2]);
-    Ji[1][1] =  deti*(J[0][0]*J[2][2] - J[0][2]*J[2][0]);
-    Ji[2][1] =  deti*(J[0][1]*J[2][0] - J[0][0]*J[2][1]);
-    
-    Ji[0][2] =  deti*(J[0][1]*J[1][2] - J[1][1]*J[0][2]);
-    Ji[1][2] =  deti*(J[0][2]*J[1][0] - J[0][0]*J[1][2]);
-    Ji[2][2] =  deti*(J[0][0]*J[1][1] - J[0][1]*J[1][0]);
-    
-    return det;
+	return invjact(el, Ji, n, rt);
 }
 
 //-----------------------------------------------------------------------------
@@ -1247,22 +1199,9 @@ double FESolidDomain::invjact(FESolidElement& el, double Ji[3][3], int n)
 double FESolidDomain::invjact(FESolidElement& el, double Ji[3][3], int n, const vec3d* rt)
 {
 	// calculate jacobian
-	double J[3][3] = { 0 };
+	double J[3][3];
 	int neln = el.Nodes();
-	for (int i = 0; i<neln; ++i)
-	{
-		const double& Gri = el.Gr(n)[i];
-		const double& Gsi = el.Gs(n)[i];
-		const double& Gti = el.Gt(n)[i];
-
-		const double& x = rt[i].x;
-		const double& y = rt[i].y;
-		const double& z = rt[i].z;
-
-		J[0][0] += Gri*x; J[0][1] += Gsi*x; J[0][2] += Gti*x;
-		J[1][0] += Gri*y; J[1][1] += Gsi*y; J[1][2] += Gti*y;
-		J[2][0] += Gri*z; J[2][1] += Gsi*z; J[2][2] += Gti*z;
-	}
+	FE_SOLID_KERNEL_DISPATCH(m_kernel, FESolidElementKernel, ::jacobian(neln, el.Gr(n), el.Gs(n), el.Gt(n), rt, J));
 
 	// calculate the determinant
 	double det = J[0][0] * (J[1][1] * J[2][2] - J[1][2] * J[2][1])
@@ -1299,49 +1238,8 @@ double FESolidDomain::invjact(FESolidElement& el, double Ji[3][3], int n, const
     // nodal coordinates
     vec3d rt[FEElement::MAX_NODES];
 	GetCurrentNodalCoordinates(el, rt, alpha);
-    
-    // calculate jacobian
-	int neln = el.Nodes();
-	double J[3][3] = { 0 };
-    for (int i=0; i<neln; ++i)
-    {
-        const double& Gri = el.Gr(n)[i];
-        const double& Gsi = el.Gs(n)[i];
-        const double& Gti = el.Gt(n)[i];
-        
-        const double& x = rt[i].x;
-        const double& y = rt[i].y;
-        const double& z = rt[i].z;
-        
-        J[0][0] += Gri*x; J[0][1] += Gsi*x; J[0][2] += Gti*x;
-        J[1][0] += Gri*y; J[1][1] += Gsi*y; J[1][2] += Gti*y;
-        J[2][0] += Gri*z; J[2][1] += Gsi*z; J[2][2] += Gti*z;
-    }
-    
-    // calculate the determinant
-    double det =  J[0][0]*(J[1][1]*J[2][2] - J[1][2]*J[2][1])
-				+ J[0][1]*(J[1][2]*J[2][0] - J[2][2]*J[1][0])
-				+ J[0][2]*(J[1][0]*J[2][1] - J[1][1]*J[2][0]);
-    
-    // make sure the determinant is positive
-    if (det <= 0) throw NegativeJacobian(el.GetID(), n+1, det);
-    
-    // calculate inverse jacobian
-    double deti = 1.0 / det;
-				
-    Ji[0][0] =  deti*(J[1][1]*J[2][2] - J[1][2]*J[2][1]);
-    Ji[1][0] =  deti*(J[1][2]*J[2][0] - J[1][0]*J[2][2]);
-    Ji[2][0] =  deti*(J[1][0]*J[2][1] - J[1][1]*J[2][0]);
-    
-    Ji[0][1] =  deti*(J[0][2]*J[2][1] - J[0][1]*J[2][2]);
-    Ji[1][1] =  deti*(J[0][0]*J[2][2] - J[0][2]*J[2][0]);
-    Ji[2][1] =  deti*(J[0][1]*J[2][0] - J[0][0]*J[2][1]);
-    
-    Ji[0][2] =  deti*(J[0][1]*J[1][2] - J[1][1]*J[0][2]);
-    Ji[1][2] =  deti*(J[0][2]*J[1][0] - J[0][0]*J[1][2]);
-    Ji[2][2] =  deti*(J[0][0]*J[1][1] - J[0][1]*J[1][0]);
-    
-    return det;
+
+	return invjact(el, Ji, n, rt);
 }
 
 //-----------------------------------------------------------------------------
@@ -2335,18 +2233,7 @@ double FESolidDomain::ShapeGradient(FESolidElement& el, int n, vec3d* GradH)
     
     // evaluate shape function derivatives
     int ne = el.Nodes();
-    for (int i = 0; i<ne; ++i)
-    {
-        double Gr = el.Gr(n)[i];
-        double Gs = el.Gs(n)[i];
-        double Gt = el.Gt(n)[i];
-        
-        // calculate global gradient of shape functions
-        // note that we need the transposed of Ji, not Ji itself !
-        GradH[i].x = Ji[0][0] * Gr + Ji[1][0] * Gs + Ji[2][0] * Gt;
-        GradH[i].y = Ji[0][1] * Gr + Ji[1][1] * Gs + Ji[2][1] * Gt;
-        GradH[i].z = Ji[0][2] * Gr + Ji[1][2] * Gs + Ji[2][2] * Gt;
-    }
+	FE_SOLID_KERNEL_DISPATCH(m_kernel, FESolidElementKernel, ::gradient(ne, Ji, el.Gr(n), el.Gs(n), el.Gt(n), GradH));
     
     return detJt;
 }
@@ -2360,18 +2247,7 @@ double FESolidDomain::ShapeGradient(FESolidElement& el, int n, vec3d* GradH, con
     
     // evaluate shape function derivatives
     int ne = el.Nodes();
-    for (int i = 0; i<ne; ++i)
-    {
-        double Gr = el.Gr(n)[i];
-        double Gs = el.Gs(n)[i];
-        double Gt = el.Gt(n)[i];
-        
-        // calculate global gradient of shape functions
-        // note that we need the transposed of Ji, not Ji itself !
-        GradH[i].x = Ji[0][0] * Gr + Ji[1][0] * Gs + Ji[2][0] * Gt;
-        GradH[i].y = Ji[0][1] * Gr + Ji[1][1] * Gs + Ji[2][1] * Gt;
-        GradH[i].z = Ji[0][2] * Gr + Ji[1][2] * Gs + Ji[2][2] * Gt;
-    }
+	FE_SOLID_KERNEL_DISPATCH(m_kernel, FESolidElementKernel, ::gradient(ne, Ji, el.Gr(n), el.Gs(n), el.Gt(n), GradH));
     
     return detJt;
 }
@@ -2562,72 +2438,78 @@ void FESolidDomain::LoadVector(
 	FEVolumeVectorIntegrand f	// the actual integrand function
 )
 {
-	FEMesh& mesh = *GetMesh();
-
-	// degrees of freedom per node
-	int dofPerNode = dofList.Size();
-
 	// loop over all the elements
 	int NE = Elements();
 	#pragma omp parallel for 
 	for (int i = 0; i<NE; ++i)
 	{
-		// get the next element
-		FESolidElement& el = Element(i);
-		int neln = el.Nodes();
+		ElementLoadVector(R, i, dofList, f);
+	}
+}
 
-		// only consider active elements
-		if (el.isActive()) 
-		{
-			std::vector<double> val(dofPerNode, 0.0);
+//-----------------------------------------------------------------------------
+void FESolidDomain::ElementLoadVector(FEGlobalVector& R, int iel, const FEDofList& dofList, const FEVolumeVectorIntegrand& f)
+{
+	FEMesh& mesh = *GetMesh();
+
+	// degrees of freedom per node
+	int dofPerNode = dofList.Size();
 
-			// total size of the element vector
-			int ndof = dofPerNode * el.Nodes();
+	// get the element
+	FESolidElement& el = Element(iel);
+	int neln = el.Nodes();
 
-			// setup the element vector
-			vector<double> fe;
-			fe.assign(ndof, 0);
+	// only consider active elements
+	if (el.isActive() == false) return;
 
-			// loop over integration points
-			double* w = el.GaussWeights();
-			int nint = el.GaussPoints();
-			for (int n = 0; n<nint; ++n)
-			{
-				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+	std::vector<double> val(dofPerNode, 0.0);
 
-				mp.m_Jt = detJt(el, n);
-				mp.m_shape = el.H(n);
+	// total size of the element vector
+	int ndof = dofPerNode * el.Nodes();
 
-				// loop over all nodes
-				for (int j = 0; j<neln; ++j)
-				{
-					// get the value of the integrand for this node
-					f(mp, j, val);
-
-					// add it all up
-					for (int k=0; k<dofPerNode; ++k)
-					{
-						fe[dofPerNode*j + k] += val[k] * w[n];
-					}
-				}
-			}
+	// setup the element vector
+	FEElementScratch& scratch = FEElementScratch::Get();
+	vector<double>& fe = scratch.Vector(ndof);
 
-			// get the element's LM vector
-			vector<int> lm(ndof, -1);
-			for (int j = 0; j < neln; ++j)
+	// loop over integration points
+	double* w = el.GaussWeights();
+	int nint = el.GaussPoints();
+	for (int n = 0; n<nint; ++n)
+	{
+		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+
+		mp.m_Jt = detJt(el, n);
+		mp.m_shape = el.H(n);
+
+		// loop over all nodes
+		for (int j = 0; j<neln; ++j)
+		{
+			// get the value of the integrand for this node
+			f(mp, j, val);
+
+			// add it all up
+			for (int k=0; k<dofPerNode; ++k)
 			{
-				FENode& node = mesh.Node(el.m_node[j]);
-				vector<int>& ID = node.m_ID;
-				for (int k = 0; k < dofPerNode; ++k)
-				{
-					lm[dofPerNode*j + k] = ID[dofList[k]];
-				}
+				fe[dofPerNode*j + k] += val[k] * w[n];
 			}
+		}
+	}
 
-			// Assemble into global vector
-			R.Assemble(el.m_node, lm, fe);
+	// get the element's LM vector
+	vector<int>& lm = scratch.LM();
+	lm.assign(ndof, -1);
+	for (int j = 0; j < neln; ++j)
+	{
+		FENode& node = mesh.Node(el.m_node[j]);
+		vector<int>& ID = node.m_ID;
+		for (int k = 0; k < dofPerNode; ++k)
+		{
+			lm[dofPerNode*j + k] = ID[dofList[k]];
 		}
 	}
+
+	// Assemble into global vector
+	R.Assemble(el.m_node, lm, fe);
 }
 
 //-----------------------------------------------------------------------------
@@ -78,6 +78,10 @@ public:
     int GetElementShape() const { return m_Elem[0].Shape(); }
 
 	FE_Element_Spec GetElementSpec() const;
+
+	//! The element type for which specialized kernels are used, or FE_ELEM_INVALID_TYPE
+	//! if the generic kernels are used. This is determined in Init.
+	int ElementKernel() const { return m_kernel; }
     
     //! find the element in which point y lies
     FESolidElement* FindElement(const vec3d& y, double r[3]);
@@ -276,6 +280,10 @@ public:
 		FEVolumeVectorIntegrand f	// the actual integrand function
 	);
 
+	//! Evaluate the load vector integral over element iel and assemble it into R. 
+	//! This is the element loop of LoadVector.
+	void ElementLoadVector(FEGlobalVector& R, int iel, const FEDofList& dofList, const FEVolumeVectorIntegrand& f);
+
 	//! Evaluate the stiffness matrix of a load
 	virtual void LoadStiffness(
 		FELinearSystem& LS,			// The solver does the assembling
@@ -287,6 +295,7 @@ public:
 protected:
     vector<FESolidElement>	m_Elem;		//!< array of elements
 	FE_Element_Spec			m_elemSpec;	//!< the element spec
+	int						m_kernel;	//!< element type of the specialized kernels
 
 	FEDofList	m_dofU;
 	FEDofList	m_dofSU;
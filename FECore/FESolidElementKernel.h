@@ -0,0 +1,137 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FEElementTraits.h"
+
+//-----------------------------------------------------------------------------
+//! Kernels that evaluate the geometry of solid elements at an integration point. 
+//! The template parameter is the number of element nodes. When it is nonzero, the
+//! loops over the nodes have a fixed trip count, so that the compiler can unroll 
+//! and vectorize them. NELN = 0 gives the generic version, which uses the node count
+//! that is passed in. Specialized versions are obtained from the element traits, 
+//! e.g. FESolidElementKernel<FEHex8G8::NELN>.
+template <int NELN> class FESolidElementKernel
+{
+public:
+	//! Calculate the Jacobian J = dx/dr from the nodal coordinates r and the 
+	//! shape function derivatives Gr, Gs, Gt at an integration point.
+	static void jacobian(int neln, const double* Gr, const double* Gs, const double* Gt, const vec3d* r, double J[3][3])
+	{
+		const int ne = (NELN > 0 ? NELN : neln);
+		double J00 = 0, J01 = 0, J02 = 0;
+		double J10 = 0, J11 = 0, J12 = 0;
+		double J20 = 0, J21 = 0, J22 = 0;
+		for (int i = 0; i < ne; ++i)
+		{
+			const double x = r[i].x;
+			const double y = r[i].y;
+			const double z = r[i].z;
+
+			J00 += Gr[i] * x; J01 += Gs[i] * x; J02 += Gt[i] * x;
+			J10 += Gr[i] * y; J11 += Gs[i] * y; J12 += Gt[i] * y;
+			J20 += Gr[i] * z; J21 += Gs[i] * z; J22 += Gt[i] * z;
+		}
+		J[0][0] = J00; J[0][1] = J01; J[0][2] = J02;
+		J[1][0] = J10; J[1][1] = J11; J[1][2] = J12;
+		J[2][0] = J20; J[2][1] = J21; J[2][2] = J22;
+	}
+
+	//! Calculate the spatial shape function gradients G from the inverse Jacobian Ji
+	static void gradient(int neln, const double Ji[3][3], const double* Gr, const double* Gs, const double* Gt, vec3d* G)
+	{
+		const int ne = (NELN > 0 ? NELN : neln);
+		for (int i = 0; i < ne; ++i)
+		{
+			// note that we need the transposed of Ji, not Ji itself !
+			G[i].x = Ji[0][0] * Gr[i] + Ji[1][0] * Gs[i] + Ji[2][0] * Gt[i];
+			G[i].y = Ji[0][1] * Gr[i] + Ji[1][1] * Gs[i] + Ji[2][1] * Gt[i];
+			G[i].z = Ji[0][2] * Gr[i] + Ji[1][2] * Gs[i] + Ji[2][2] * Gt[i];
+		}
+	}
+
+	//! Calculate the deformation gradient F from the current nodal coordinates r
+	//! and the inverse of the reference Jacobian Ji
+	static void defgrad(int neln, const mat3d& Ji, const double* Gr, const double* Gs, const double* Gt, const vec3d* r, mat3d& F)
+	{
+		const int ne = (NELN > 0 ? NELN : neln);
+		double F00 = 0, F01 = 0, F02 = 0;
+		double F10 = 0, F11 = 0, F12 = 0;
+		double F20 = 0, F21 = 0, F22 = 0;
+		for (int i = 0; i < ne; ++i)
+		{
+			// note that we need the transposed of Ji, not Ji itself !
+			const double GX = Ji[0][0] * Gr[i] + Ji[1][0] * Gs[i] + Ji[2][0] * Gt[i];
+			const double GY = Ji[0][1] * Gr[i] + Ji[1][1] * Gs[i] + Ji[2][1] * Gt[i];
+			const double GZ = Ji[0][2] * Gr[i] + Ji[1][2] * Gs[i] + Ji[2][2] * Gt[i];
+
+			const double x = r[i].x;
+			const double y = r[i].y;
+			const double z = r[i].z;
+
+			F00 += GX * x; F01 += GY * x; F02 += GZ * x;
+			F10 += GX * y; F11 += GY * y; F12 += GZ * y;
+			F20 += GX * z; F21 += GY * z; F22 += GZ * z;
+		}
+		F[0][0] = F00; F[0][1] = F01; F[0][2] = F02;
+		F[1][0] = F10; F[1][1] = F11; F[1][2] = F12;
+		F[2][0] = F20; F[2][1] = F21; F[2][2] = F22;
+	}
+};
+
+//-----------------------------------------------------------------------------
+//! Returns true if there are specialized kernels for the element type. These are
+//! the element types that are selected with FESolidDomain::ElementKernel.
+inline bool HasSolidElementKernel(int etype)
+{
+	switch (etype)
+	{
+	case FE_TET4G1:
+	case FE_TET10G4:
+	case FE_PENTA6G6:
+	case FE_HEX8G8:
+	case FE_HEX20G27:
+		return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+//! Call FUNC with the node count of the element type ETYPE as the template parameter
+//! (or 0 if there is no specialized kernel for it), e.g.
+//! FE_SOLID_KERNEL_DISPATCH(m_kernel, FESolidElementKernel, ::jacobian(neln, Gr, Gs, Gt, r, J));
+#define FE_SOLID_KERNEL_DISPATCH(ETYPE, FUNC, ARGS) \
+	switch (ETYPE) \
+	{ \
+	case FE_TET4G1   : FUNC<FETet4G1  ::NELN>ARGS; break; \
+	case FE_TET10G4  : FUNC<FETet10G4 ::NELN>ARGS; break; \
+	case FE_PENTA6G6 : FUNC<FEPenta6G6::NELN>ARGS; break; \
+	case FE_HEX8G8   : FUNC<FEHex8G8  ::NELN>ARGS; break; \
+	case FE_HEX20G27 : FUNC<FEHex20G27::NELN>ARGS; break; \
+	default: FUNC<0>ARGS; \
+	}
@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FESolver.h"
 #include "FEModel.h"
 #include "FENodeReorder.h"
+#include "FENestedDissection.h"
 #include "DumpStream.h"
 #include "FEDomain.h"
 #include "FESurfacePairConstraint.h"
@@ -37,6 +38,7 @@ SOFTWARE.*/
 #include "FELinearConstraintManager.h"
 #include "FENodalLoad.h"
 #include "LinearSolver.h"
+#include "log.h"
 
 BEGIN_FECORE_CLASS(FESolver, FECoreBase)
 	BEGIN_PARAM_GROUP("linear system");
@@ -44,6 +46,10 @@ BEGIN_FECORE_CLASS(FESolver, FECoreBase)
 		ADD_PARAMETER(m_eq_scheme, "equation_scheme", 0, "staggered\0block\0");
 		ADD_PARAMETER(m_eq_order , "equation_order", 0, "default\0reverse\0febio2\0");
 		ADD_PARAMETER(m_bwopt    , "optimize_bw");
+		ADD_PARAMETER(m_ndopt    , "nested_dissection");
+		ADD_PARAMETER(m_ndexport , "export_ordering");
+		ADD_PARAMETER(m_assembly , "assembly_scheme", 0, "atomic\0colored\0");
+		ADD_PARAMETER(m_bscatter , "cache_scatter_maps");
 	END_PARAM_GROUP();
 END_FECORE_CLASS();
 
@@ -61,9 +67,13 @@ FESolver::FESolver(FEModel* fem) : FECoreBase(fem)
 	m_neq = 0;
 
 	m_bwopt = false;
+	m_ndopt = false;
+	m_ndexport = false;
 
 	m_eq_scheme = EQUATION_SCHEME::STAGGERED;
 	m_eq_order = EQUATION_ORDER::NORMAL_ORDER;
+	m_assembly = ASSEMBLY_SCHEME::ATOMIC_ASSEMBLY;
+	m_bscatter = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -295,6 +305,74 @@ void FESolver::BuildMatrixProfile(FEGlobalMatrix& G, bool breset)
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Calculates the order in which the nodes are numbered. P stores for each new
+//! node the old node that corresponds to this node.
+void FESolver::NodeOrdering(vector<int>& P)
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	int NN = mesh.Nodes();
+	m_ndperm.clear();
+
+	// the bandwidth optimization and the fill-reducing ordering are mutually exclusive
+	if (m_bwopt && m_ndopt)
+	{
+		feLogWarning("Both optimize_bw and nested_dissection are set. The nested_dissection option is ignored.");
+	}
+
+	// see if we need to optimize the bandwidth
+	if (m_bwopt)
+	{
+		FENodeReorder mod;
+		mod.Apply(mesh, P);
+	}
+	else if (m_ndopt)
+	{
+		// calculate a fill-reducing ordering
+		FENestedDissection nd;
+		if (m_ndexport)
+		{
+			// the nodes keep their numbers, but the ordering is passed on to the linear solver
+			nd.Apply(mesh, m_ndperm);
+			P.resize(NN);
+			for (int i = 0; i < NN; ++i) P[i] = i;
+		}
+		else nd.Apply(mesh, P);
+	}
+	else
+	{
+		P.resize(NN);
+		for (int i = 0; i < NN; ++i) P[i] = i;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Expands the nested dissection ordering of the nodes to the equations. Equations
+//! that do not belong to a node (e.g. of rigid bodies) are ordered last. This returns 
+//! false if the ordering should not be passed to the linear solver.
+bool FESolver::EquationOrdering(vector<int>& perm)
+{
+	if (m_ndperm.empty()) return false;
+
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	perm.clear();
+	perm.reserve(m_neq);
+	vector<char> tag(m_neq, 0);
+	for (int i = 0; i < (int)m_ndperm.size(); ++i)
+	{
+		FENode& node = mesh.Node(m_ndperm[i]);
+		for (int j = 0; j < (int)node.m_ID.size(); ++j)
+		{
+			int id = node.m_ID[j];
+			int eq = (id < -1 ? -id - 2 : id);
+			if ((eq >= 0) && (eq < m_neq) && (tag[eq] == 0)) { tag[eq] = 1; perm.push_back(eq); }
+		}
+	}
+	for (int i = 0; i < m_neq; ++i) if (tag[i] == 0) perm.push_back(i);
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! This function is called right before SolveStep and should be used to initialize
 //! time dependent information and other settings.
@@ -345,15 +423,8 @@ bool FESolver::InitEquations()
 
 	// reorder the node numbers
 	int NN = mesh.Nodes();
-	vector<int> P(NN);
-    
-    // see if we need to optimize the bandwidth
-	if (m_bwopt)
-	{
-		FENodeReorder mod;
-		mod.Apply(mesh, P);
-	}
-	else for (int i = 0; i < NN; ++i) P[i] = i;
+	vector<int> P;
+	NodeOrdering(P);
 
 	for (int i = 0; i < mesh.Nodes(); ++i)
 	{
@@ -396,7 +467,6 @@ bool FESolver::InitEquations()
 		}
 		else
 		{
-			int NN = mesh.Nodes();
 			for (int i = NN-1; i >= 0; --i)
 			{
 				FENode& node = mesh.Node(P[i]);
@@ -545,16 +615,8 @@ bool FESolver::InitEquations2()
 	m_part.clear();
 
 	// reorder the node numbers
-	int NN = mesh.Nodes();
-	vector<int> P(NN);
-
-	// see if we need to optimize the bandwidth
-	if (m_bwopt)
-	{
-		FENodeReorder mod;
-		mod.Apply(mesh, P);
-	}
-	else for (int i = 0; i < NN; ++i) P[i] = i;
+	vector<int> P;
+	NodeOrdering(P);
 
 	// reset all equation numbers
 	// first, on all nodes
@@ -52,6 +52,16 @@ enum EQUATION_ORDER
 	FEBIO2_ORDER
 };
 
+//-----------------------------------------------------------------------------
+// Scheme for assembling element matrices into the global matrix
+// ATOMIC : elements are assembled concurrently and all updates are atomic
+// COLORED: elements are assembled color by color, without atomic updates
+enum ASSEMBLY_SCHEME
+{
+	ATOMIC_ASSEMBLY,
+	COLORED_ASSEMBLY
+};
+
 //-----------------------------------------------------------------------------
 // Solution variable
 class FESolutionVariable
@@ -179,6 +189,13 @@ public:
 	// return the node (mesh index) from an equation number
 	FENodalDofInfo GetDOFInfoFromEquation(int ieq);
 
+	// get the fill-reducing ordering of the equations that is passed to the linear solver
+	bool EquationOrdering(std::vector<int>& perm);
+
+protected:
+	// calculate the order in which the nodes are numbered
+	void NodeOrdering(std::vector<int>& P);
+
 public:
 	// extract the (square) norm of a solution vector
 	double ExtractSolutionNorm(const vector<double>& v, const FEDofList& dofs) const;
@@ -188,12 +205,17 @@ public:
 
 public: //TODO Move these parameters elsewhere
 	bool				m_bwopt;	    //!< bandwidth optimization flag
+	bool				m_ndopt;		//!< nested dissection ordering flag
+	bool				m_ndexport;		//!< pass the nested dissection ordering to the linear solver instead of renumbering the nodes
 	int					m_msymm;		//!< matrix symmetry flag for linear solver allocation
 	int					m_eq_scheme;	//!< equation number scheme (used in InitEquations)
 	int					m_eq_order;		//!< normal or reverse ordering
+	int					m_assembly;		//!< assembly scheme (atomic or colored)
+	bool				m_bscatter;		//!< cache element scatter maps for assembly
 	int					m_neq;			//!< number of equations
 	std::vector<int>	m_part;			//!< partitions of linear system
 	std::vector<int>	m_dofMap;		//!< array stores for each equation the corresponding dof index
+	std::vector<int>	m_ndperm;		//!< nested dissection ordering of the nodes (only when exported)
 
 	// counters
 	int		m_nrhs;			//!< nr of right hand side evalutations
@@ -0,0 +1,423 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FESurfaceBVH.h"
+#include "FESurface.h"
+#include "FEMesh.h"
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// max number of facets in a leaf
+const int LEAF_SIZE = 4;
+
+// max depth of the tree searches (the tree is balanced, so this is plenty)
+const int MAX_STACK = 128;
+
+// boxes are inflated by at least this fraction of their size to make sure that 
+// points on the facet boundaries are found
+const double BOX_EPS = 1e-6;
+
+//-----------------------------------------------------------------------------
+// see if the line through p with direction n intersects the box [a, b], and if
+// the box lies within the search radius srad of p
+static bool LineIntersectsBox(const vec3d& a, const vec3d& b, const vec3d& p, const vec3d& n, double srad)
+{
+	if ((p.x < a.x - srad) || (p.x > b.x + srad)) return false;
+	if ((p.y < a.y - srad) || (p.y > b.y + srad)) return false;
+	if ((p.z < a.z - srad) || (p.z > b.z + srad)) return false;
+
+	double tmin = -1e99, tmax = 1e99;
+	const double pp[3] = { p.x, p.y, p.z };
+	const double nn[3] = { n.x, n.y, n.z };
+	const double aa[3] = { a.x, a.y, a.z };
+	const double bb[3] = { b.x, b.y, b.z };
+	for (int i = 0; i < 3; ++i)
+	{
+		if (nn[i] == 0.0)
+		{
+			if ((pp[i] < aa[i]) || (pp[i] > bb[i])) return false;
+		}
+		else
+		{
+			double t0 = (aa[i] - pp[i]) / nn[i];
+			double t1 = (bb[i] - pp[i]) / nn[i];
+			if (t0 > t1) { double t = t0; t0 = t1; t1 = t; }
+			if (t0 > tmin) tmin = t0;
+			if (t1 < tmax) tmax = t1;
+			if (tmin > tmax) return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// see if the line through p with direction n intersects the box [a, b] inflated by rad
+static bool LineIntersectsBox(const vec3d& a, const vec3d& b, double rad, const vec3d& p, const vec3d& n)
+{
+	vec3d d(rad, rad, rad);
+	return LineIntersectsBox(a - d, b + d, p, n, 1e99);
+}
+
+//-----------------------------------------------------------------------------
+// squared distance of point x to the box [a, b]
+static double BoxDistance2(const vec3d& a, const vec3d& b, const vec3d& x)
+{
+	double dx = (x.x < a.x ? a.x - x.x : (x.x > b.x ? x.x - b.x : 0.0));
+	double dy = (x.y < a.y ? a.y - x.y : (x.y > b.y ? x.y - b.y : 0.0));
+	double dz = (x.z < a.z ? a.z - x.z : (x.z > b.z ? x.z - b.z : 0.0));
+	return dx*dx + dy*dy + dz*dz;
+}
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH::FESurfaceBVH(FESurface* ps)
+{
+	m_ps = ps;
+	m_area0 = 0.0;
+	m_maxRatio = 2.0;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Attach(FESurface* ps)
+{
+	if (ps != m_ps)
+	{
+		m_ps = ps;
+		m_node.clear();
+		m_facet.clear();
+		m_leaf.clear();
+		m_fmin.clear();
+		m_fmax.clear();
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Build(double tol)
+{
+	assert(m_ps);
+	FEMesh& mesh = *m_ps->GetMesh();
+
+	// calculate the facet centroids
+	int NF = m_ps->Elements();
+	std::vector<vec3d> centroid(NF);
+	m_facet.resize(NF);
+	for (int i = 0; i < NF; ++i)
+	{
+		FESurfaceElement& el = m_ps->Element(i);
+		vec3d c(0, 0, 0);
+		int ne = el.Nodes();
+		for (int j = 0; j < ne; ++j) c += mesh.Node(el.m_node[j]).m_rt;
+		centroid[i] = c / ne;
+		m_facet[i] = i;
+	}
+
+	// build the tree (top-down)
+	m_node.clear();
+	if (NF > 0)
+	{
+		m_node.reserve(2 * (NF / LEAF_SIZE + 1));
+		buildNode(0, NF, centroid);
+	}
+	m_leaf.resize(NF);
+	for (int k = 0; k < NF; ++k) m_leaf[m_facet[k]] = k;
+
+	// evaluate the boxes
+	Refit(tol);
+	m_area0 = boxArea();
+}
+
+//-----------------------------------------------------------------------------
+// Create the node for the facets [first, first + count) and its children. The
+// facets are split at the median of their centroids along the largest extent.
+int FESurfaceBVH::buildNode(int first, int count, std::vector<vec3d>& centroid)
+{
+	int inode = (int)m_node.size();
+	m_node.push_back(NODE());
+	m_node[inode].right = -1;
+	m_node[inode].first = first;
+	m_node[inode].count = count;
+	if (count <= LEAF_SIZE) return inode;
+
+	// find the extent of the centroids
+	vec3d cmin = centroid[m_facet[first]], cmax = cmin;
+	for (int i = first + 1; i < first + count; ++i)
+	{
+		const vec3d& c = centroid[m_facet[i]];
+		if (c.x < cmin.x) cmin.x = c.x; if (c.x > cmax.x) cmax.x = c.x;
+		if (c.y < cmin.y) cmin.y = c.y; if (c.y > cmax.y) cmax.y = c.y;
+		if (c.z < cmin.z) cmin.z = c.z; if (c.z > cmax.z) cmax.z = c.z;
+	}
+	vec3d d = cmax - cmin;
+	int axis = ((d.x >= d.y) && (d.x >= d.z) ? 0 : (d.y >= d.z ? 1 : 2));
+
+	// split at the median
+	int mid = first + count / 2;
+	std::nth_element(m_facet.begin() + first, m_facet.begin() + mid, m_facet.begin() + first + count, [&](int a, int b) {
+		const vec3d& ca = centroid[a];
+		const vec3d& cb = centroid[b];
+		return (axis == 0 ? ca.x < cb.x : (axis == 1 ? ca.y < cb.y : ca.z < cb.z));
+	});
+
+	// the left child always follows its parent
+	buildNode(first, mid - first, centroid);
+	int right = buildNode(mid, first + count - mid, centroid);
+	m_node[inode].right = right;
+	m_node[inode].count = 0;
+	return inode;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Refit(double tol)
+{
+	assert(m_ps);
+	FEMesh& mesh = *m_ps->GetMesh();
+
+	// update the facet boxes
+	int NF = (int)m_facet.size();
+	m_fmin.resize(NF);
+	m_fmax.resize(NF);
+	for (int k = 0; k < NF; ++k)
+	{
+		FESurfaceElement& el = m_ps->Element(m_facet[k]);
+		vec3d a = mesh.Node(el.m_node[0]).m_rt, b = a;
+		int ne = el.Nodes();
+		for (int j = 1; j < ne; ++j)
+		{
+			const vec3d& r = mesh.Node(el.m_node[j]).m_rt;
+			if (r.x < a.x) a.x = r.x; if (r.x > b.x) b.x = r.x;
+			if (r.y < a.y) a.y = r.y; if (r.y > b.y) b.y = r.y;
+			if (r.z < a.z) a.z = r.z; if (r.z > b.z) b.z = r.z;
+		}
+		double d = (b - a).norm()*(tol + BOX_EPS);
+		m_fmin[k] = a - vec3d(d, d, d);
+		m_fmax[k] = b + vec3d(d, d, d);
+	}
+
+	// update the tree boxes bottom-up (children are stored after their parent)
+	for (int i = (int)m_node.size() - 1; i >= 0; --i)
+	{
+		NODE& node = m_node[i];
+		vec3d a, b;
+		if (node.right < 0)
+		{
+			a = m_fmin[node.first];
+			b = m_fmax[node.first];
+			for (int k = node.first + 1; k < node.first + node.count; ++k)
+			{
+				const vec3d& ak = m_fmin[k];
+				const vec3d& bk = m_fmax[k];
+				if (ak.x < a.x) a.x = ak.x; if (bk.x > b.x) b.x = bk.x;
+				if (ak.y < a.y) a.y = ak.y; if (bk.y > b.y) b.y = bk.y;
+				if (ak.z < a.z) a.z = ak.z; if (bk.z > b.z) b.z = bk.z;
+			}
+		}
+		else
+		{
+			const NODE& l = m_node[i + 1];
+			const NODE& r = m_node[node.right];
+			a = vec3d(std::min(l.bmin.x, r.bmin.x), std::min(l.bmin.y, r.bmin.y), std::min(l.bmin.z, r.bmin.z));
+			b = vec3d(std::max(l.bmax.x, r.bmax.x), std::max(l.bmax.y, r.bmax.y), std::max(l.bmax.z, r.bmax.z));
+		}
+		node.bmin = a;
+		node.bmax = b;
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool FESurfaceBVH::Update(double tol)
+{
+	assert(m_ps);
+
+	// build the tree when it does not match the surface
+	if ((int)m_facet.size() != m_ps->Elements())
+	{
+		Build(tol);
+		return true;
+	}
+
+	Refit(tol);
+	if (Quality() > m_maxRatio)
+	{
+		Build(tol);
+		return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+double FESurfaceBVH::boxArea() const
+{
+	double A = 0.0;
+	for (const NODE& node : m_node)
+	{
+		if (node.right >= 0)
+		{
+			vec3d d = node.bmax - node.bmin;
+			A += 2.0*(d.x*d.y + d.y*d.z + d.z*d.x);
+		}
+	}
+	return A;
+}
+
+//-----------------------------------------------------------------------------
+double FESurfaceBVH::Quality() const
+{
+	return (m_area0 > 0.0 ? boxArea() / m_area0 : 1.0);
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindRayCandidates(const vec3d& p, const vec3d& n, std::vector<int>& sel, double srad) const
+{
+	sel.clear();
+	if (m_node.empty()) return;
+
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		int i = stack[--ns];
+		const NODE& node = m_node[i];
+		if (LineIntersectsBox(node.bmin, node.bmax, p, n, srad) == false) continue;
+
+		if (node.right < 0)
+		{
+			for (int k = node.first; k < node.first + node.count; ++k)
+			{
+				if (LineIntersectsBox(m_fmin[k], m_fmax[k], p, n, srad)) sel.push_back(m_facet[k]);
+			}
+		}
+		else
+		{
+			assert(ns + 2 <= MAX_STACK);
+			stack[ns++] = node.right;
+			stack[ns++] = i + 1;
+		}
+	}
+
+	std::sort(sel.begin(), sel.end());
+}
+
+//-----------------------------------------------------------------------------
+// Since the boxes of the tree nodes contain the boxes of their facets, only the 
+// facet's own box needs to be checked.
+bool FESurfaceBVH::IsRayCandidate(int nf, const vec3d& p, const vec3d& n, double srad) const
+{
+	if ((nf < 0) || (nf >= (int)m_leaf.size())) return false;
+	int k = m_leaf[nf];
+	return LineIntersectsBox(m_fmin[k], m_fmax[k], p, n, srad);
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindLineCandidates(const vec3d& p, const vec3d& n, double rad, std::vector<int>& sel) const
+{
+	sel.clear();
+	if (m_node.empty()) return;
+
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		int i = stack[--ns];
+		const NODE& node = m_node[i];
+		if (LineIntersectsBox(node.bmin, node.bmax, rad, p, n) == false) continue;
+
+		if (node.right < 0)
+		{
+			for (int k = node.first; k < node.first + node.count; ++k)
+			{
+				if (LineIntersectsBox(m_fmin[k], m_fmax[k], rad, p, n)) sel.push_back(m_facet[k]);
+			}
+		}
+		else
+		{
+			assert(ns + 2 <= MAX_STACK);
+			stack[ns++] = node.right;
+			stack[ns++] = i + 1;
+		}
+	}
+
+	std::sort(sel.begin(), sel.end());
+}
+
+//-----------------------------------------------------------------------------
+int FESurfaceBVH::FindClosestNode(const vec3d& x, double rad, const std::function<bool(int)>& accept) const
+{
+	if (m_node.empty()) return -1;
+
+	int imin = -1;
+	double d2min = (rad > 0.0 ? rad*rad : 1e99);
+
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		int i = stack[--ns];
+		const NODE& node = m_node[i];
+		if (BoxDistance2(node.bmin, node.bmax, x) > d2min) continue;
+
+		if (node.right < 0)
+		{
+			for (int k = node.first; k < node.first + node.count; ++k)
+			{
+				if (BoxDistance2(m_fmin[k], m_fmax[k], x) > d2min) continue;
+
+				FESurfaceElement& el = m_ps->Element(m_facet[k]);
+				int ne = el.Nodes();
+				for (int j = 0; j < ne; ++j)
+				{
+					int l = el.m_lnode[j];
+					vec3d dr = m_ps->Node(l).m_rt - x;
+					double d2 = dr*dr;
+
+					// on a tie, pick the lowest node index
+					if ((d2 < d2min) || ((d2 == d2min) && ((imin == -1) || (l < imin))))
+					{
+						if (accept && (accept(l) == false)) continue;
+						d2min = d2;
+						imin = l;
+					}
+				}
+			}
+		}
+		else
+		{
+			// visit the closest child first
+			int l = i + 1, r = node.right;
+			double dl = BoxDistance2(m_node[l].bmin, m_node[l].bmax, x);
+			double dr = BoxDistance2(m_node[r].bmin, m_node[r].bmax, x);
+			assert(ns + 2 <= MAX_STACK);
+			if (dl <= dr) { stack[ns++] = r; stack[ns++] = l; }
+			else { stack[ns++] = l; stack[ns++] = r; }
+		}
+	}
+
+	return imin;
+}
@@ -0,0 +1,106 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "vec3d.h"
+#include "fecore_api.h"
+#include <vector>
+#include <functional>
+
+class FESurface;
+
+//-----------------------------------------------------------------------------
+//! Bounding volume hierarchy (a tree of axis-aligned bounding boxes) over the 
+//! facets of a surface. It is used to accelerate the projections onto a surface.
+//! The tree is built once and can then be refit to the current nodal positions
+//! in linear time. It is only rebuilt when the refit tree has become much less 
+//! efficient than the tree that was originally built (see Update).
+class FECORE_API FESurfaceBVH
+{
+	struct NODE
+	{
+		vec3d	bmin, bmax;	//!< bounding box
+		int		right;		//!< index of the right child (the left child follows the node), or -1 for leaves
+		int		first;		//!< first facet of a leaf
+		int		count;		//!< number of facets of a leaf
+	};
+
+public:
+	FESurfaceBVH(FESurface* ps = nullptr);
+
+	//! attach to a surface
+	void Attach(FESurface* ps);
+
+	//! get the surface
+	FESurface* GetSurface() { return m_ps; }
+
+	//! Build the tree from the current nodal positions. The boxes of the facets are
+	//! inflated by the fraction tol of their size.
+	void Build(double tol = 0.0);
+
+	//! Refit the boxes of the tree to the current nodal positions.
+	void Refit(double tol = 0.0);
+
+	//! Refit the tree, and rebuild it when its quality has degraded too much. 
+	//! Returns true if the tree was rebuilt.
+	bool Update(double tol = 0.0);
+
+	//! Ratio of the total surface area of the boxes and the total area right after the last build.
+	//! This is a measure for the cost of a search, relative to the cost after a build.
+	double Quality() const;
+
+	//! Find all facets whose box is intersected by the line through p with direction n
+	//! and lies within the search radius of p. The facets are returned in ascending order.
+	void FindRayCandidates(const vec3d& p, const vec3d& n, std::vector<int>& sel, double srad) const;
+
+	//! See if the facet nf would be returned by FindRayCandidates(p, n, sel, srad).
+	bool IsRayCandidate(int nf, const vec3d& p, const vec3d& n, double srad) const;
+
+	//! Find all facets whose box, inflated by rad, is intersected by the (infinite) line 
+	//! through p with direction n. The facets are returned in ascending order.
+	void FindLineCandidates(const vec3d& p, const vec3d& n, double rad, std::vector<int>& sel) const;
+
+	//! Find the closest surface node to x (as local node index). Only nodes within 
+	//! the distance rad (if rad > 0) and for which accept returns true (if given) 
+	//! are considered. Returns -1 if no node is found.
+	int FindClosestNode(const vec3d& x, double rad = 0.0, const std::function<bool(int)>& accept = nullptr) const;
+
+private:
+	int buildNode(int first, int count, std::vector<vec3d>& centroid);
+	double boxArea() const;
+
+private:
+	FESurface*			m_ps;		//!< the surface
+	std::vector<NODE>	m_node;		//!< tree nodes (root first)
+	std::vector<int>	m_facet;	//!< facets in leaf order
+	std::vector<int>	m_leaf;		//!< position of each facet in leaf order
+	std::vector<vec3d>	m_fmin;		//!< facet boxes (in leaf order)
+	std::vector<vec3d>	m_fmax;
+	double				m_area0;	//!< total box area after the last build
+	double				m_maxRatio;	//!< quality ratio that triggers a rebuild
+};
@@ -0,0 +1,110 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FETaskList.h"
+#include "sys.h"
+
+//-----------------------------------------------------------------------------
+FETaskList::FETaskList()
+{
+	m_chunkSize = 0;
+	m_bstatic = false;
+}
+
+//-----------------------------------------------------------------------------
+void FETaskList::AddTask(int n, RangeFunction f)
+{
+	if (n <= 0) return;
+	m_task.push_back(f);
+	m_items.push_back(n);
+}
+
+//-----------------------------------------------------------------------------
+void FETaskList::Clear()
+{
+	m_task.clear();
+	m_items.clear();
+	m_chunk.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FETaskList::Run()
+{
+	if (m_task.empty()) return;
+
+	// total number of items
+	int items = 0;
+	for (int n : m_items) items += n;
+
+	// Unless set, we pick the chunk size so that each thread gets several chunks 
+	// (for load balancing), but not too many (to keep the scheduling overhead low).
+	int chunkSize = m_chunkSize;
+	if (chunkSize <= 0)
+	{
+		int nt = omp_get_max_threads();
+		chunkSize = items / (8 * nt);
+		if (chunkSize < 1) chunkSize = 1;
+		if (chunkSize > 256) chunkSize = 256;
+	}
+
+	// split the tasks in chunks
+	m_chunk.clear();
+	for (int i = 0; i < (int)m_task.size(); ++i)
+	{
+		for (int i0 = 0; i0 < m_items[i]; i0 += chunkSize)
+		{
+			int i1 = i0 + chunkSize;
+			if (i1 > m_items[i]) i1 = m_items[i];
+			m_chunk.push_back({ i, i0, i1 });
+		}
+	}
+
+	// process all chunks in one parallel region
+	int NC = (int)m_chunk.size();
+	if (m_bstatic)
+	{
+#pragma omp parallel for schedule(static, 1) shared(NC)
+		for (int i = 0; i < NC; ++i)
+		{
+			const Chunk& c = m_chunk[i];
+			m_task[c.task](c.i0, c.i1);
+		}
+	}
+	else
+	{
+#pragma omp parallel for schedule(dynamic, 1) shared(NC)
+		for (int i = 0; i < NC; ++i)
+		{
+			const Chunk& c = m_chunk[i];
+			m_task[c.task](c.i0, c.i1);
+		}
+	}
+
+	Clear();
+}
@@ -0,0 +1,80 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+#include <functional>
+
+//-----------------------------------------------------------------------------
+//! A list of tasks that are executed together in a single parallel region.
+//! Each task processes a range of items (e.g. the elements of a domain) and is
+//! split into chunks that are handed out dynamically to the threads. This way, 
+//! a model with many small domains does not pay for a parallel region per domain,
+//! and threads that finish a domain early continue with the next one.
+class FECORE_API FETaskList
+{
+public:
+	//! function that processes the items [i0, i1)
+	typedef std::function<void(int i0, int i1)> RangeFunction;
+
+public:
+	FETaskList();
+
+	//! add a task that processes the items [0, n)
+	void AddTask(int n, RangeFunction f);
+
+	//! number of tasks
+	int Tasks() const { return (int)m_task.size(); }
+
+	//! remove all tasks
+	void Clear();
+
+	//! Execute all tasks. The tasks are cleared afterwards.
+	void Run();
+
+	//! Set the number of items per chunk (0 = determined automatically)
+	void SetChunkSize(int n) { m_chunkSize = n; }
+
+	//! Assign the chunks to the threads in a fixed order instead of dynamically. This 
+	//! gives up some load balancing, but each thread then always processes the same items.
+	void SetStaticSchedule(bool b) { m_bstatic = b; }
+
+private:
+	struct Chunk
+	{
+		int		task;	// task index
+		int		i0, i1;	// item range
+	};
+
+	std::vector<RangeFunction>	m_task;		//!< the tasks
+	std::vector<int>			m_items;	//!< number of items of each task
+	std::vector<Chunk>			m_chunk;	//!< the chunks
+	int							m_chunkSize;	//!< items per chunk
+	bool						m_bstatic;		//!< use static schedule
+};
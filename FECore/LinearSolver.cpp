@@ -82,6 +82,13 @@ int LinearSolver::GetPartitionSize(int part) const
 	return m_part[part];
 }
 
+//-----------------------------------------------------------------------------
+// set the fill-reducing ordering of the equations
+void LinearSolver::SetPermutation(const vector<int>& perm)
+{
+	m_perm = perm;
+}
+
 //-----------------------------------------------------------------------------
 const LinearSolverStats& LinearSolver::GetStats() const
 {
@@ -101,6 +101,10 @@ public:
 	// get the size of a partition
 	int GetPartitionSize(int part) const;
 
+	//! Set a fill-reducing ordering of the equations, where perm[k] is the equation 
+	//! that is eliminated k-th. This is only used by solvers that accept a user permutation.
+	void SetPermutation(const vector<int>& perm);
+
 	//! version for std::vector
 	bool BackSolve(std::vector<double>& x, std::vector<double>& b)
 	{
@@ -125,6 +129,7 @@ protected:
 
 protected:
 	std::vector<int>	m_part;		//!< partitions of linear system.
+	std::vector<int>	m_perm;		//!< (optional) user permutation of equations
 
 private:
 	LinearSolverStats	m_stats;	//!< stats on how often linear solver was called.
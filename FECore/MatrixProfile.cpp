@@ -319,6 +319,70 @@ void SparseMatrixProfile::Insert(int i, int j)
 	a.insertRow(i);
 }
 
+//-----------------------------------------------------------------------------
+//! See if all the entries of the profile mp are also in this profile. 
+//! This assumes that the row entries of each column are sorted and don't overlap.
+bool SparseMatrixProfile::Contains(const SparseMatrixProfile& mp) const
+{
+	if ((mp.m_nrow != m_nrow) || (mp.m_ncol != m_ncol)) return false;
+	if (mp.m_prof.size() != m_prof.size()) return false;
+
+	for (int i = 0; i < m_ncol; ++i)
+	{
+		const ColumnProfile& a = m_prof[i];
+		const ColumnProfile& b = mp.m_prof[i];
+		int na = a.size();
+		int nb = b.size();
+		int k = 0;
+		for (int j = 0; j < nb; ++j)
+		{
+			const RowEntry& rb = b[j];
+
+			// find the interval of a that could contain rb
+			while ((k < na) && (a[k].end < rb.start)) ++k;
+			if (k == na) return false;
+
+			// since the intervals of a are merged, rb must be inside a single interval
+			if ((rb.start < a[k].start) || (rb.end > a[k].end)) return false;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Add all the entries of the profile mp to this profile
+void SparseMatrixProfile::Merge(const SparseMatrixProfile& mp)
+{
+	assert((mp.m_nrow == m_nrow) && (mp.m_ncol == m_ncol));
+	if ((mp.m_nrow != m_nrow) || (mp.m_ncol != m_ncol)) return;
+
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < m_ncol; ++i)
+	{
+		const ColumnProfile& a = m_prof[i];
+		const ColumnProfile& b = mp.m_prof[i];
+		if (b.size() == 0) continue;
+
+		// merge the two sorted interval lists
+		ColumnProfile c;
+		c.reserve(a.size() + b.size());
+		int ka = 0, kb = 0;
+		while ((ka < a.size()) || (kb < b.size()))
+		{
+			const RowEntry& r = ((kb == b.size()) || ((ka < a.size()) && (a[ka].start <= b[kb].start)) ? a[ka++] : b[kb++]);
+
+			int n = c.size();
+			if ((n > 0) && (r.start <= c[n - 1].end + 1))
+			{
+				if (r.end > c[n - 1].end) c[n - 1].end = r.end;
+			}
+			else c.push_back(r.start, r.end);
+		}
+		m_prof[i] = c;
+	}
+}
+
 //-----------------------------------------------------------------------------
 // extract the matrix profile of a block
 SparseMatrixProfile SparseMatrixProfile::GetBlockProfile(int nrow0, int ncol0, int nrow1, int ncol1) const
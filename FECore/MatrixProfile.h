@@ -114,6 +114,12 @@ public:
 	//! inserts an entry into the profile (This is an expensive operation!)
 	void Insert(int i, int j);
 
+	//! see if all the entries of a profile are also in this profile
+	bool Contains(const SparseMatrixProfile& mp) const;
+
+	//! add all the entries of a profile to this profile
+	void Merge(const SparseMatrixProfile& mp);
+
 	//! returns the number of rows
 	int Rows() const { return m_nrow; }
 
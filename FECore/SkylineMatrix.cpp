@@ -125,14 +125,52 @@ void SkylineMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 				// only add values to upper-diagonal part of stiffness matrix
 				if (J>=I)
 				{
-					#pragma omp atomic
-					pv[ pi[J] + J - I] += ke[i][j];
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pv[ pi[J] + J - I] += ke[i][j];
+					}
+					else pv[ pi[J] + J - I] += ke[i][j];
 				}
 			}
 		}
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Same as Assemble, but only the upper triangle of the symmetric matrix ke is set.
+void SkylineMatrix::AssembleUpper(const matrix& ke, const vector<int>& LM)
+{
+	const int N = ke.rows();
+
+	double* pv = values();
+	int* pi = pointers();
+
+	for (int i=0; i<N; ++i)
+	{
+		int I = LM[i];
+
+		if (I>=0)
+		{
+			for (int j=0; j<N; ++j)
+			{
+				int J = LM[j];
+
+				// only add values to upper-diagonal part of stiffness matrix
+				if (J>=I)
+				{
+					double kij = (j >= i ? ke[i][j] : ke[j][i]);
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pv[ pi[J] + J - I] += kij;
+					}
+					else pv[ pi[J] + J - I] += kij;
+				}
+			}
+		}
+	}
+}
 
 //-----------------------------------------------------------------------------
 void SkylineMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const vector<int>& LMj)
@@ -158,8 +196,12 @@ void SkylineMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const vec
 				// only add values to upper-diagonal part of stiffness matrix
 				if (J>=I)
 				{
-					#pragma omp atomic
-					pv[ pi[J] + J - I] += ke[i][j];
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pv[ pi[J] + J - I] += ke[i][j];
+					}
+					else pv[ pi[J] + J - I] += ke[i][j];
 				}
 			}
 		}
@@ -177,8 +219,12 @@ void SkylineMatrix::add(int i, int j, double v)
 	// only add to the upper triangular part
 	if (j >= i)
 	{
-		#pragma omp atomic
-		m_pd[m_ppointers[j] + j - i] += v;
+		if (m_batomic)
+		{
+			#pragma omp atomic
+			m_pd[m_ppointers[j] + j - i] += v;
+		}
+		else m_pd[m_ppointers[j] + j - i] += v;
 	}
 }
 
@@ -55,6 +55,9 @@ public: // from SparseMatrix
 	//! assemble a matrix into the sparse matrix
 	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
 
+	//! assemble an element matrix of which only the upper triangle is set
+	void AssembleUpper(const matrix& ke, const std::vector<int>& lm) override;
+
 	void add(int i, int j, double v) override;
 
 	void set(int i, int j, double v) override;
@@ -36,6 +36,7 @@ SparseMatrix::SparseMatrix()
 {
 	m_nrow = m_ncol = 0;
 	m_nsize = 0;
+	m_batomic = true;
 }
 
 SparseMatrix::~SparseMatrix()
@@ -53,3 +54,33 @@ void SparseMatrix::scale(const vector<double>& L, const vector<double>& R)
 {
 	assert(false);
 }
+
+//! assemble a symmetric matrix of which only the upper triangle is set
+void SparseMatrix::AssembleUpper(const matrix& ke, const vector<int>& lm)
+{
+	// the scratch matrix is only reallocated when the element size changes
+	static thread_local matrix kf;
+	const int n = ke.rows();
+	kf.resize(n, n);
+	for (int i = 0; i < n; ++i)
+	{
+		for (int j = 0; j < i; ++j) kf[i][j] = ke[j][i];
+		for (int j = i; j < n; ++j) kf[i][j] = ke[i][j];
+	}
+	Assemble(kf, lm);
+}
+
+//! scatter a symmetric matrix of which only the upper triangle is set
+void SparseMatrix::ScatterAddUpper(const matrix& ke, const int* slots)
+{
+	// the scratch matrix is only reallocated when the element size changes
+	static thread_local matrix kf;
+	const int n = ke.rows();
+	kf.resize(n, n);
+	for (int i = 0; i < n; ++i)
+	{
+		for (int j = 0; j < i; ++j) kf[i][j] = ke[j][i];
+		for (int j = i; j < n; ++j) kf[i][j] = ke[i][j];
+	}
+	ScatterAdd(kf, slots);
+}
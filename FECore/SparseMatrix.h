@@ -60,6 +60,14 @@ public:
 	//! return number of nonzeros
 	int NonZeroes() const { return m_nsize; }
 
+	//! Turn on/off the atomic updates in the Assemble functions. This can only be 
+	//! turned off when no two element matrices that are assembled concurrently
+	//! share an entry of the global matrix (e.g. when assembling by element colors).
+	void SetAtomicAssembly(bool b) { m_batomic = b; }
+
+	//! see if the Assemble functions use atomic updates
+	bool AtomicAssembly() const { return m_batomic; }
+
 public: // functions to be overwritten in derived classes
 
 	//! set all matrix elements to zero
@@ -74,6 +82,10 @@ public: // functions to be overwritten in derived classes
 	//! assemble a matrix into the sparse matrix
 	virtual void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) = 0;
 
+	//! Assemble a symmetric matrix of which only the upper triangle (j >= i) is set. 
+	//! The default implementation completes the lower triangle and calls Assemble.
+	virtual void AssembleUpper(const matrix& ke, const std::vector<int>& lm);
+
 	//! check if an entry was allocated
 	virtual bool check(int i, int j) = 0;
 
@@ -95,6 +107,21 @@ public: // functions to be overwritten in derived classes
 	//! scale matrix
 	virtual void scale(const std::vector<double>& L, const std::vector<double>& R);
 
+	//! Build the scatter map of an element matrix with indices lm. The scatter map stores for
+	//! each entry (i,j) of the element matrix the offset into the Values() array, or -1 if 
+	//! that entry is not assembled. Returns false if the matrix format does not support this.
+	virtual bool BuildScatterMap(const std::vector<int>& lm, std::vector<int>& slots) { return false; }
+
+	//! Assemble an element matrix using a scatter map that was created with BuildScatterMap.
+	virtual void ScatterAdd(const matrix& ke, const int* slots) { assert(false); }
+
+	//! Same as ScatterAdd, but only the upper triangle of the (symmetric) matrix ke is set.
+	virtual void ScatterAddUpper(const matrix& ke, const int* slots);
+
+	//! Returns false for operators that do not store the matrix entries (e.g. matrix-free
+	//! operators). For these, the matrix profile does not need to be built.
+	virtual bool NeedsProfile() const { return true; }
+
 public:
 	//! multiply with vector
 	bool mult_vector(double* x, double* r) override { assert(false); return false; }
@@ -111,4 +138,5 @@ protected:
 	// NOTE: These values are set by derived classes
 	int	m_nrow, m_ncol;		//!< dimension of matrix
 	int	m_nsize;			//!< number of nonzeroes (i.e. matrix elements actually allocated)
+	bool	m_batomic;		//!< use atomic updates during assembly
 };
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "mortar.h"
 #include <math.h>
 #include "FEMesh.h"
+#include "FESurfaceBVH.h"
 
 //-----------------------------------------------------------------------------
 // subtract operator for POINT2D
@@ -543,25 +544,48 @@ bool CalculateMortarIntersection(FESurface& ss, FESurface& ms, int k, int l, Pat
 
 void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& mortar)
 {
+	// The intersections are calculated by projecting the mortar facets onto the plane of 
+	// the non-mortar facet. A mortar facet can only intersect the non-mortar facet if it 
+	// comes within distance R of the axis through the center of the non-mortar facet, 
+	// where R is the radius of the facet. We use a search tree to find these candidates.
+	FESurfaceBVH bvh(&ms);
+	bvh.Build();
+
 	// loop over all non-mortar facets
 	int NSF = ss.Elements();
-	int NMF = ms.Elements();
+	vector<int> sel;
 	for (int i=0; i<NSF; ++i)
 	{
 		// get the non-mortar surface element
 		FESurfaceElement& se = ss.Element(i);
-
-		// loop over all the mortar surface elements
-		for (int j=0; j<NMF; ++j)
+		int ns = se.Nodes();
+		vec3d rs[FEElement::MAX_NODES];
+		for (int k=0; k<ns; ++k) rs[k] = ss.Node(se.m_lnode[k]).m_rt;
+
+		// the projection direction (see CalculateMortarIntersection)
+		vec3d e1 = rs[   1] - rs[0]; e1.unit();
+		vec3d e2 = rs[ns-1] - rs[0]; e2.unit();
+		vec3d e3 = e1^e2; e3.unit();
+
+		// center and radius of the facet
+		vec3d c(0,0,0);
+		for (int k=0; k<ns; ++k) c += rs[k];
+		c /= (double) ns;
+		double R = 0;
+		for (int k=0; k<ns; ++k)
 		{
-			// get the next surface element
-			FESurfaceElement& me = ms.Element(j);
+			double d = (rs[k] - c).norm();
+			if (d > R) R = d;
+		}
 
+		// loop over all the candidate mortar surface elements
+		bvh.FindLineCandidates(c, e3, R, sel);
+		for (int j : sel)
+		{
 			// calculate the patch of triangles, representing the intersection
 			// of the non-mortar facet with the mortar facet
 			Patch patch(i,j);
-			CalculateMortarIntersection(ss, ms, i, j, patch);
-			mortar.AddPatch(patch);
+			if (CalculateMortarIntersection(ss, ms, i, j, patch)) mortar.AddPatch(patch);
 		}
 	}
 }
@@ -131,7 +131,8 @@ private:
 FECORE_API bool CalculateMortarIntersection(FESurface& ss, FESurface& ms, int k, int l, Patch& patch);
 
 //-----------------------------------------------------------------------------
-// Calculates the mortar intersection between two surfaces
+// Calculates the mortar intersection between two surfaces.
+// Only the non-empty patches are added to the mortar surface.
 FECORE_API void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& s);
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,1015 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "AMGPreconditioner.h"
+#include <FECore/CompactMatrix.h>
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/log.h>
+#include <algorithm>
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+// The coarsest level is solved with a dense LU factorization, unless it is larger than this.
+#define MAX_DIRECT_SIZE	5000
+
+//-----------------------------------------------------------------------------
+// Simple zero-based compressed row matrix that is used for all levels of the hierarchy.
+struct AMGMatrix
+{
+	int		rows = 0;
+	int		cols = 0;
+	vector<int>		p;	// row pointers
+	vector<int>		c;	// column indices
+	vector<double>	v;	// values
+
+	int NonZeroes() const { return (int)c.size(); }
+
+	// y = A*x
+	void mult(const double* x, double* y) const
+	{
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < rows; ++i)
+		{
+			double s = 0.0;
+			for (int k = p[i]; k < p[i + 1]; ++k) s += v[k] * x[c[k]];
+			y[i] = s;
+		}
+	}
+
+	// r = b - A*x
+	void residual(const double* x, const double* b, double* r) const
+	{
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < rows; ++i)
+		{
+			double s = b[i];
+			for (int k = p[i]; k < p[i + 1]; ++k) s -= v[k] * x[c[k]];
+			r[i] = s;
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------
+// C = A*B
+static void spgemm(const AMGMatrix& A, const AMGMatrix& B, AMGMatrix& C)
+{
+	C.rows = A.rows;
+	C.cols = B.cols;
+	C.p.assign(A.rows + 1, 0);
+
+	// count the nonzeroes of each row
+#pragma omp parallel
+	{
+		vector<int> mark(B.cols, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < A.rows; ++i)
+		{
+			int nz = 0;
+			for (int k = A.p[i]; k < A.p[i + 1]; ++k)
+			{
+				int j = A.c[k];
+				for (int l = B.p[j]; l < B.p[j + 1]; ++l)
+				{
+					int m = B.c[l];
+					if (mark[m] != i) { mark[m] = i; nz++; }
+				}
+			}
+			C.p[i + 1] = nz;
+		}
+	}
+	for (int i = 0; i < A.rows; ++i) C.p[i + 1] += C.p[i];
+
+	C.c.resize(C.p[A.rows]);
+	C.v.resize(C.p[A.rows]);
+
+	// compute the values
+#pragma omp parallel
+	{
+		vector<int> pos(B.cols, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < A.rows; ++i)
+		{
+			int n0 = C.p[i], nz = n0;
+			for (int k = A.p[i]; k < A.p[i + 1]; ++k)
+			{
+				int j = A.c[k];
+				double a = A.v[k];
+				for (int l = B.p[j]; l < B.p[j + 1]; ++l)
+				{
+					int m = B.c[l];
+					if ((pos[m] < n0) || (pos[m] >= nz) || (C.c[pos[m]] != m))
+					{
+						pos[m] = nz;
+						C.c[nz] = m;
+						C.v[nz] = a * B.v[l];
+						nz++;
+					}
+					else C.v[pos[m]] += a * B.v[l];
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// B = A^T
+static void transpose(const AMGMatrix& A, AMGMatrix& B)
+{
+	B.rows = A.cols;
+	B.cols = A.rows;
+	B.p.assign(B.rows + 1, 0);
+	for (int k = 0; k < A.NonZeroes(); ++k) B.p[A.c[k] + 1]++;
+	for (int i = 0; i < B.rows; ++i) B.p[i + 1] += B.p[i];
+	B.c.resize(A.NonZeroes());
+	B.v.resize(A.NonZeroes());
+	vector<int> pos(B.p.begin(), B.p.end() - 1);
+	for (int i = 0; i < A.rows; ++i)
+	{
+		for (int k = A.p[i]; k < A.p[i + 1]; ++k)
+		{
+			int n = pos[A.c[k]]++;
+			B.c[n] = i;
+			B.v[n] = A.v[k];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+class AMGPreconditioner::Impl
+{
+public:
+	struct Level
+	{
+		AMGMatrix	A;		// operator on this level
+		AMGMatrix	P;		// prolongator to this level (from the next coarser level)
+		AMGMatrix	R;		// restriction (transpose of P)
+		vector<double>	dinv;	// inverse of diagonal
+		double			rho;	// estimate of spectral radius of D^-1*A
+
+		// work vectors for the V-cycle
+		vector<double>	x, b, r, d;
+	};
+
+public:
+	void Clear()
+	{
+		levels.clear();
+		LU.clear();
+		piv.clear();
+		node.clear();
+		B.clear();
+		nodes = 0;
+		nmodes = 0;
+		neq0 = -1;
+		nnz0 = -1;
+		nc = 0;
+	}
+
+	// copy the fine level matrix into (full) compressed row format
+	bool CopyMatrix(CompactMatrix* K);
+
+	// build the hierarchy
+	void Setup(int maxLevels, int coarseSize, double theta);
+
+	// only recompute the coarse operators
+	void Update();
+
+	// do one V-cycle
+	void Cycle(int l, int degree);
+
+private:
+	void Aggregate(const AMGMatrix& A, const vector<int>& node, int nodes, double theta, vector<int>& agg, int& naggs);
+	void Tentative(const vector<int>& agg, int naggs, const vector<double>& B, int k, AMGMatrix& T, vector<double>& Bc);
+	void Smoother(Level& L);
+	void Chebyshev(Level& L, int degree);
+	void CoarseFactor(const AMGMatrix& A);
+	void DenseFactor(const AMGMatrix& A);
+	void CoarseSolve(const double* b, double* x);
+
+public:
+	vector<Level>	levels;
+
+	// fine level near null space
+	vector<int>		node;	// node index of each equation
+	int				nodes = 0;
+	vector<double>	B;		// near null space vectors (equation-major)
+	int				nmodes = 0;
+
+	// profile of fine level matrix at last setup
+	int		neq0 = -1;
+	int		nnz0 = -1;
+
+	// dense LU factorization of coarsest level
+	vector<double>	LU;
+	vector<int>		piv;
+	int				nc = 0;
+};
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::Impl::CopyMatrix(CompactMatrix* K)
+{
+	int n = K->Rows();
+	if (K->Columns() != n) return false;
+
+	int offset = K->Offset();
+	int* ptr = K->Pointers();
+	int* ind = K->Indices();
+	double* val = K->Values();
+	int nnz = ptr[n] - offset;
+
+	if (levels.empty()) levels.resize(1);
+	AMGMatrix& A = levels[0].A;
+	A.rows = A.cols = n;
+	A.p.assign(n + 1, 0);
+
+	if (K->isSymmetric())
+	{
+		// only the lower triangle is stored (by columns), so add the transpose
+		for (int j = 0; j < n; ++j)
+			for (int k = ptr[j] - offset; k < ptr[j + 1] - offset; ++k)
+			{
+				int i = ind[k] - offset;
+				A.p[i + 1]++;
+				if (i != j) A.p[j + 1]++;
+			}
+		for (int i = 0; i < n; ++i) A.p[i + 1] += A.p[i];
+		A.c.resize(A.p[n]);
+		A.v.resize(A.p[n]);
+		vector<int> pos(A.p.begin(), A.p.end() - 1);
+		for (int j = 0; j < n; ++j)
+			for (int k = ptr[j] - offset; k < ptr[j + 1] - offset; ++k)
+			{
+				int i = ind[k] - offset;
+				int m = pos[i]++; A.c[m] = j; A.v[m] = val[k];
+				if (i != j) { m = pos[j]++; A.c[m] = i; A.v[m] = val[k]; }
+			}
+	}
+	else if (K->isRowBased())
+	{
+		for (int i = 0; i <= n; ++i) A.p[i] = ptr[i] - offset;
+		A.c.resize(nnz);
+		A.v.assign(val, val + nnz);
+		for (int k = 0; k < nnz; ++k) A.c[k] = ind[k] - offset;
+	}
+	else
+	{
+		// column based, so we need the transpose
+		AMGMatrix T;
+		T.rows = T.cols = n;
+		T.p.resize(n + 1);
+		for (int i = 0; i <= n; ++i) T.p[i] = ptr[i] - offset;
+		T.c.resize(nnz);
+		T.v.assign(val, val + nnz);
+		for (int k = 0; k < nnz; ++k) T.c[k] = ind[k] - offset;
+		transpose(T, A);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Aggregates the nodes of the strength graph. The strength of the connection between
+// two nodes is the Frobenius norm of the corresponding block of A.
+void AMGPreconditioner::Impl::Aggregate(const AMGMatrix& A, const vector<int>& node, int nodes, double theta, vector<int>& agg, int& naggs)
+{
+	// equations of each node
+	vector<int> np(nodes + 1, 0), ne(A.rows);
+	for (int i = 0; i < A.rows; ++i) np[node[i] + 1]++;
+	for (int i = 0; i < nodes; ++i) np[i + 1] += np[i];
+	vector<int> pos(np.begin(), np.end() - 1);
+	for (int i = 0; i < A.rows; ++i) ne[pos[node[i]]++] = i;
+
+	// node graph with squared block norms
+	vector<int> gp(nodes + 1, 0), gi;
+	vector<double> gw, diag(nodes, 0.0);
+	vector<int> mark(nodes, -1);
+	vector<double> w(nodes, 0.0);
+	vector<int> nbr;
+	for (int I = 0; I < nodes; ++I)
+	{
+		nbr.clear();
+		for (int n = np[I]; n < np[I + 1]; ++n)
+		{
+			int i = ne[n];
+			for (int k = A.p[i]; k < A.p[i + 1]; ++k)
+			{
+				int J = node[A.c[k]];
+				if (mark[J] != I) { mark[J] = I; w[J] = 0.0; nbr.push_back(J); }
+				w[J] += A.v[k] * A.v[k];
+			}
+		}
+		for (int J : nbr)
+		{
+			if (J == I) diag[I] = w[J];
+			else { gi.push_back(J); gw.push_back(w[J]); }
+		}
+		gp[I + 1] = (int)gi.size();
+	}
+
+	// only keep strong connections
+	double th2 = theta*theta;
+	vector<int> sp(nodes + 1, 0), si;
+	si.reserve(gi.size());
+	for (int I = 0; I < nodes; ++I)
+	{
+		for (int k = gp[I]; k < gp[I + 1]; ++k)
+		{
+			int J = gi[k];
+			if ((gw[k] > 0.0) && (gw[k] >= th2*sqrt(diag[I] * diag[J]))) si.push_back(J);
+		}
+		sp[I + 1] = (int)si.size();
+	}
+
+	// phase 1: nodes whose strong neighbors are not aggregated yet form a new aggregate
+	agg.assign(nodes, -1);
+	naggs = 0;
+	for (int I = 0; I < nodes; ++I)
+	{
+		if ((agg[I] >= 0) || (sp[I] == sp[I + 1])) continue;
+		bool free = true;
+		for (int k = sp[I]; k < sp[I + 1]; ++k) if (agg[si[k]] >= 0) { free = false; break; }
+		if (free)
+		{
+			agg[I] = naggs;
+			for (int k = sp[I]; k < sp[I + 1]; ++k) agg[si[k]] = naggs;
+			naggs++;
+		}
+	}
+
+	// phase 2: remaining nodes join a neighboring aggregate
+	vector<int> agg1(agg);
+	for (int I = 0; I < nodes; ++I)
+	{
+		if (agg[I] >= 0) continue;
+		for (int k = sp[I]; k < sp[I + 1]; ++k)
+		{
+			int J = si[k];
+			if (agg1[J] >= 0) { agg[I] = agg1[J]; break; }
+		}
+	}
+
+	// phase 3: whatever is left forms new aggregates
+	for (int I = 0; I < nodes; ++I)
+	{
+		if (agg[I] >= 0) continue;
+		agg[I] = naggs;
+		for (int k = sp[I]; k < sp[I + 1]; ++k)
+		{
+			int J = si[k];
+			if (agg[J] < 0) agg[J] = naggs;
+		}
+		naggs++;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Builds the tentative prolongator by orthonormalizing the near null space vectors 
+// on each aggregate. The coarse near null space is given by the R factors.
+void AMGPreconditioner::Impl::Tentative(const vector<int>& agg, int naggs, const vector<double>& B, int k, AMGMatrix& T, vector<double>& Bc)
+{
+	int n = (int)agg.size();
+
+	// equations of each aggregate
+	vector<int> ap(naggs + 1, 0), ae(n);
+	for (int i = 0; i < n; ++i) ap[agg[i] + 1]++;
+	for (int i = 0; i < naggs; ++i) ap[i + 1] += ap[i];
+	vector<int> pos(ap.begin(), ap.end() - 1);
+	for (int i = 0; i < n; ++i) ae[pos[agg[i]]++] = i;
+
+	// QR factorization of each aggregate's block
+	vector<int> cp(naggs + 1, 0);	// coarse equations of each aggregate
+	vector< vector<double> > Q(naggs), Rf(naggs);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int a = 0; a < naggs; ++a)
+	{
+		int m = ap[a + 1] - ap[a];
+		vector<double> V(m*k);
+		for (int i = 0; i < m; ++i)
+			for (int j = 0; j < k; ++j) V[j*m + i] = B[ae[ap[a] + i] * k + j];
+
+		// modified Gram-Schmidt, dropping dependent columns
+		vector<double>& q = Q[a];
+		vector<double>& r = Rf[a];
+		int rank = 0;
+		r.assign(k*k, 0.0);
+		for (int j = 0; j < k; ++j)
+		{
+			double* vj = &V[j*m];
+			double n0 = 0.0;
+			for (int i = 0; i < m; ++i) n0 += vj[i] * vj[i];
+			n0 = sqrt(n0);
+			for (int l = 0; l < rank; ++l)
+			{
+				const double* ql = &q[l*m];
+				double s = 0.0;
+				for (int i = 0; i < m; ++i) s += ql[i] * vj[i];
+				for (int i = 0; i < m; ++i) vj[i] -= s*ql[i];
+				r[l*k + j] = s;
+			}
+			double nj = 0.0;
+			for (int i = 0; i < m; ++i) nj += vj[i] * vj[i];
+			nj = sqrt(nj);
+			if ((nj > 1e-10*n0) && (nj > 0.0))
+			{
+				q.resize((rank + 1)*m);
+				for (int i = 0; i < m; ++i) q[rank*m + i] = vj[i] / nj;
+				r[rank*k + j] = nj;
+				rank++;
+			}
+		}
+		r.resize(rank*k);
+		cp[a + 1] = rank;
+	}
+	for (int a = 0; a < naggs; ++a) cp[a + 1] += cp[a];
+	int nc = cp[naggs];
+
+	// assemble T
+	T.rows = n;
+	T.cols = nc;
+	T.p.assign(n + 1, 0);
+	for (int i = 0; i < n; ++i) T.p[i + 1] = T.p[i] + (cp[agg[i] + 1] - cp[agg[i]]);
+	T.c.resize(T.p[n]);
+	T.v.resize(T.p[n]);
+	for (int a = 0; a < naggs; ++a)
+	{
+		int m = ap[a + 1] - ap[a];
+		int rank = cp[a + 1] - cp[a];
+		for (int i = 0; i < m; ++i)
+		{
+			int ei = ae[ap[a] + i];
+			for (int j = 0; j < rank; ++j)
+			{
+				T.c[T.p[ei] + j] = cp[a] + j;
+				T.v[T.p[ei] + j] = Q[a][j*m + i];
+			}
+		}
+	}
+
+	// coarse near null space
+	Bc.assign(nc*k, 0.0);
+	for (int a = 0; a < naggs; ++a)
+	{
+		int rank = cp[a + 1] - cp[a];
+		for (int j = 0; j < rank; ++j)
+			for (int l = 0; l < k; ++l) Bc[(cp[a] + j)*k + l] = Rf[a][j*k + l];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Calculates the inverse diagonal and estimates the spectral radius of D^-1*A.
+// The estimate is the Rayleigh quotient of a few power iterations on D^-1/2*A*D^-1/2,
+// which is increased by a safety factor, but not beyond the Gershgorin bound.
+void AMGPreconditioner::Impl::Smoother(Level& L)
+{
+	const AMGMatrix& A = L.A;
+	int n = A.rows;
+	L.dinv.assign(n, 1.0);
+	for (int i = 0; i < n; ++i)
+	{
+		for (int k = A.p[i]; k < A.p[i + 1]; ++k)
+			if ((A.c[k] == i) && (A.v[k] != 0.0)) { L.dinv[i] = 1.0 / fabs(A.v[k]); break; }
+	}
+
+	// Gershgorin bound
+	double gmax = 0.0;
+	for (int i = 0; i < n; ++i)
+	{
+		double s = 0.0;
+		for (int k = A.p[i]; k < A.p[i + 1]; ++k) s += fabs(A.v[k]);
+		s *= L.dinv[i];
+		if (s > gmax) gmax = s;
+	}
+
+	// power iterations (starting from a pseudo-random vector)
+	vector<double> s(n), x(n), y(n);
+	for (int i = 0; i < n; ++i)
+	{
+		s[i] = sqrt(L.dinv[i]);
+		unsigned int h = (unsigned int)i * 2654435761u;
+		h ^= h >> 16;
+		x[i] = (double)(h % 1000) / 1000.0 - 0.5;
+	}
+	double lam = 0.0;
+	for (int it = 0; it < 20; ++it)
+	{
+		double xn = 0.0;
+		for (int i = 0; i < n; ++i) xn += x[i] * x[i];
+		xn = sqrt(xn);
+		if (xn == 0.0) break;
+		for (int i = 0; i < n; ++i) x[i] = s[i] * x[i] / xn;
+		A.mult(&x[0], &y[0]);
+		lam = 0.0;
+		for (int i = 0; i < n; ++i)
+		{
+			x[i] /= s[i];
+			y[i] *= s[i];
+			lam += x[i] * y[i];
+		}
+		x.swap(y);
+	}
+	lam *= 1.1;
+	if ((lam <= 0.0) || (lam > gmax)) lam = gmax;
+	L.rho = (lam > 0.0 ? lam : 1.0);
+
+	L.x.resize(n);
+	L.b.resize(n);
+	L.r.resize(n);
+	L.d.resize(n);
+}
+
+//-----------------------------------------------------------------------------
+// Chebyshev smoothing of A x = b on the interval [rho/30, rho].
+void AMGPreconditioner::Impl::Chebyshev(Level& L, int degree)
+{
+	const AMGMatrix& A = L.A;
+	int n = A.rows;
+	double lmax = L.rho;
+	double lmin = lmax / 30.0;
+	double theta = 0.5*(lmax + lmin);
+	double delta = 0.5*(lmax - lmin);
+	double sigma = theta / delta;
+	double rk = 1.0 / sigma;
+
+	double* x = &L.x[0];
+	double* r = &L.r[0];
+	double* d = &L.d[0];
+	const double* b = &L.b[0];
+	const double* dinv = &L.dinv[0];
+
+	A.residual(x, b, r);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		d[i] = dinv[i] * r[i] / theta;
+		x[i] += d[i];
+	}
+
+	for (int k = 1; k < degree; ++k)
+	{
+		double rn = 1.0 / (2.0*sigma - rk);
+		A.residual(x, b, r);
+		double c1 = rn*rk;
+		double c2 = 2.0*rn / delta;
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			d[i] = c1*d[i] + c2*dinv[i] * r[i];
+			x[i] += d[i];
+		}
+		rk = rn;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Dense LU factorization with partial pivoting of the coarsest level. Pivots that
+// are (numerically) zero are perturbed, since the coarse operator may be singular.
+void AMGPreconditioner::Impl::DenseFactor(const AMGMatrix& A)
+{
+	int n = A.rows;
+	nc = n;
+	LU.assign((size_t)n*n, 0.0);
+	piv.resize(n);
+	double amax = 0.0;
+	for (int i = 0; i < n; ++i)
+		for (int k = A.p[i]; k < A.p[i + 1]; ++k)
+		{
+			LU[(size_t)i*n + A.c[k]] += A.v[k];
+			if (fabs(A.v[k]) > amax) amax = fabs(A.v[k]);
+		}
+	if (amax == 0.0) amax = 1.0;
+	double eps = 1e-12*amax;
+
+	for (int k = 0; k < n; ++k)
+	{
+		int p = k;
+		double pmax = fabs(LU[(size_t)k*n + k]);
+		for (int i = k + 1; i < n; ++i)
+			if (fabs(LU[(size_t)i*n + k]) > pmax) { pmax = fabs(LU[(size_t)i*n + k]); p = i; }
+		piv[k] = p;
+		if (p != k)
+			for (int j = 0; j < n; ++j) std::swap(LU[(size_t)k*n + j], LU[(size_t)p*n + j]);
+
+		double* rk = &LU[(size_t)k*n];
+		if (fabs(rk[k]) < eps) rk[k] = (rk[k] < 0.0 ? -eps : eps);
+
+#pragma omp parallel for schedule(static)
+		for (int i = k + 1; i < n; ++i)
+		{
+			double* ri = &LU[(size_t)i*n];
+			double l = ri[k] / rk[k];
+			ri[k] = l;
+			if (l != 0.0) for (int j = k + 1; j < n; ++j) ri[j] -= l*rk[j];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::Impl::CoarseSolve(const double* b, double* x)
+{
+	int n = nc;
+	for (int i = 0; i < n; ++i) x[i] = b[i];
+	for (int k = 0; k < n; ++k) if (piv[k] != k) std::swap(x[k], x[piv[k]]);
+	for (int i = 0; i < n; ++i)
+	{
+		const double* ri = &LU[(size_t)i*n];
+		double s = x[i];
+		for (int j = 0; j < i; ++j) s -= ri[j] * x[j];
+		x[i] = s;
+	}
+	for (int i = n - 1; i >= 0; --i)
+	{
+		const double* ri = &LU[(size_t)i*n];
+		double s = x[i];
+		for (int j = i + 1; j < n; ++j) s -= ri[j] * x[j];
+		x[i] = s / ri[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::Impl::Setup(int maxLevels, int coarseSize, double theta)
+{
+	levels.resize(1);
+	vector<int> lnode(node);
+	int lnodes = nodes;
+	vector<double> lB(B);
+	int k = nmodes;
+
+	for (int l = 0; l < maxLevels - 1; ++l)
+	{
+		Level& L = levels[l];
+		Smoother(L);
+		if (L.A.rows <= coarseSize) break;
+
+		// aggregate the nodes
+		vector<int> nagg;
+		int naggs = 0;
+		Aggregate(L.A, lnode, lnodes, theta, nagg, naggs);
+
+		// map the aggregates to the equations
+		int n = L.A.rows;
+		vector<int> agg(n);
+		for (int i = 0; i < n; ++i) agg[i] = nagg[lnode[i]];
+
+		AMGMatrix T;
+		vector<double> Bc;
+		Tentative(agg, naggs, lB, k, T, Bc);
+
+		// stop when coarsening stalls
+		if ((T.cols == 0) || (T.cols > 0.9*n)) break;
+
+		// smooth the prolongator: P = (I - w*D^-1*A)*T
+		Level C;
+		AMGMatrix AT;
+		spgemm(L.A, T, AT);
+		double w = 4.0 / (3.0*L.rho);
+		{
+			// add T to AT, which contains the pattern of T since the diagonal of A is nonzero
+			AMGMatrix& P = C.P;
+			P.rows = n;
+			P.cols = T.cols;
+			P.p.assign(n + 1, 0);
+			vector<int> mark(T.cols, -1);
+			vector<int> pc;
+			vector<double> pv;
+			for (int i = 0; i < n; ++i)
+			{
+				int n0 = (int)pc.size();
+				for (int m = AT.p[i]; m < AT.p[i + 1]; ++m)
+				{
+					mark[AT.c[m]] = (int)pc.size();
+					pc.push_back(AT.c[m]);
+					pv.push_back(-w*L.dinv[i] * AT.v[m]);
+				}
+				for (int m = T.p[i]; m < T.p[i + 1]; ++m)
+				{
+					int j = T.c[m];
+					if ((mark[j] >= n0) && (mark[j] < (int)pc.size()) && (pc[mark[j]] == j)) pv[mark[j]] += T.v[m];
+					else { pc.push_back(j); pv.push_back(T.v[m]); }
+				}
+				P.p[i + 1] = (int)pc.size();
+			}
+			P.c.swap(pc);
+			P.v.swap(pv);
+		}
+		transpose(C.P, C.R);
+
+		// Galerkin coarse operator
+		AMGMatrix AP;
+		spgemm(L.A, C.P, AP);
+		spgemm(C.R, AP, C.A);
+
+		// the aggregates are the nodes of the next level
+		lnode.resize(T.cols);
+		for (int i = 0; i < n; ++i)
+			for (int m = T.p[i]; m < T.p[i + 1]; ++m) lnode[T.c[m]] = agg[i];
+		lnodes = naggs;
+		lB.swap(Bc);
+
+		levels.push_back(C);
+	}
+
+	Level& Lc = levels.back();
+	if (Lc.dinv.empty()) Smoother(Lc);
+	CoarseFactor(Lc.A);
+}
+
+//-----------------------------------------------------------------------------
+// The coarsest level is solved directly, unless coarsening stalled before it got small enough.
+void AMGPreconditioner::Impl::CoarseFactor(const AMGMatrix& A)
+{
+	if (A.rows > MAX_DIRECT_SIZE)
+	{
+		nc = 0;
+		LU.clear();
+		piv.clear();
+	}
+	else DenseFactor(A);
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::Impl::Update()
+{
+	for (int l = 0; l < (int)levels.size(); ++l)
+	{
+		Level& L = levels[l];
+		if (l > 0)
+		{
+			AMGMatrix AP;
+			spgemm(levels[l - 1].A, L.P, AP);
+			spgemm(L.R, AP, L.A);
+		}
+		Smoother(L);
+	}
+	CoarseFactor(levels.back().A);
+}
+
+//-----------------------------------------------------------------------------
+// V-cycle on level l. The right-hand side is in b and the solution is returned in x.
+void AMGPreconditioner::Impl::Cycle(int l, int degree)
+{
+	Level& L = levels[l];
+	if (l == (int)levels.size() - 1)
+	{
+		if (nc == L.A.rows) CoarseSolve(&L.b[0], &L.x[0]);
+		else
+		{
+			std::fill(L.x.begin(), L.x.end(), 0.0);
+			for (int i = 0; i < 4; ++i) Chebyshev(L, degree);
+		}
+		return;
+	}
+
+	Level& C = levels[l + 1];
+	int n = L.A.rows;
+
+	// pre-smoothing
+	std::fill(L.x.begin(), L.x.end(), 0.0);
+	Chebyshev(L, degree);
+
+	// restrict the residual
+	L.A.residual(&L.x[0], &L.b[0], &L.r[0]);
+	C.R.mult(&L.r[0], &C.b[0]);
+
+	// coarse grid correction
+	Cycle(l + 1, degree);
+	C.P.mult(&C.x[0], &L.r[0]);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i) L.x[i] += L.r[i];
+
+	// post-smoothing
+	Chebyshev(L, degree);
+}
+
+//=============================================================================
+BEGIN_FECORE_CLASS(AMGPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_maxLevels , "max_levels");
+	ADD_PARAMETER(m_coarseSize, "coarse_size");
+	ADD_PARAMETER(m_theta     , "strong_threshold");
+	ADD_PARAMETER(m_degree    , "smoother_degree");
+	ADD_PARAMETER(m_cycles    , "cycles");
+	ADD_PARAMETER(m_rbm       , "rigid_body_modes");
+	ADD_PARAMETER(m_reuse     , "reuse_setup");
+	ADD_PARAMETER(m_printLevel, "print_level");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+AMGPreconditioner::AMGPreconditioner(FEModel* fem) : Preconditioner(fem), m(new AMGPreconditioner::Impl)
+{
+	m_maxLevels = 10;
+	m_coarseSize = 500;
+	m_theta = 0.0;
+	m_degree = 2;
+	m_cycles = 1;
+	m_rbm = true;
+	m_reuse = true;
+	m_printLevel = 0;
+}
+
+//-----------------------------------------------------------------------------
+AMGPreconditioner::~AMGPreconditioner()
+{
+	delete m;
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::SetPrintLevel(int n)
+{
+	m_printLevel = n;
+}
+
+//-----------------------------------------------------------------------------
+// The near null space is spanned by the rigid body modes of the displacement 
+// degrees of freedom, plus a constant mode for each other type of degree of freedom.
+// Equations that do not belong to a mesh node (e.g. rigid bodies) get their own node
+// and a constant mode.
+void AMGPreconditioner::BuildNearNullSpace(int neq)
+{
+	Impl& I = *m;
+	I.node.assign(neq, -1);
+
+	// component of each equation: 0-2 = displacement, 3-5 = shell displacement, 
+	// otherwise 6 + index of the constant mode
+	vector<int> comp(neq, -1);
+	vector<vec3d> pos(neq);
+	int nodes = 0;
+
+	FEModel* fem = GetFEModel();
+	if (fem && m_rbm)
+	{
+		int dofs[6] = {
+			fem->GetDOFIndex("x"), fem->GetDOFIndex("y"), fem->GetDOFIndex("z"),
+			fem->GetDOFIndex("sx"), fem->GetDOFIndex("sy"), fem->GetDOFIndex("sz")
+		};
+
+		FEMesh& mesh = fem->GetMesh();
+		nodes = mesh.Nodes();
+		for (int i = 0; i < nodes; ++i)
+		{
+			FENode& nd = mesh.Node(i);
+			for (int j = 0; j < nd.dofs(); ++j)
+			{
+				int eq = nd.m_ID[j];
+				if ((eq < 0) || (eq >= neq)) continue;
+
+				int c = -1;
+				for (int l = 0; l < 6; ++l) if (dofs[l] == j) { c = l; break; }
+				if (c < 0) c = 6 + j;
+
+				I.node[eq] = i;
+				comp[eq] = c;
+				pos[eq] = (c < 3 ? nd.m_rt : nd.st());
+			}
+		}
+	}
+
+	// remaining equations
+	for (int i = 0; i < neq; ++i)
+	{
+		if (I.node[i] < 0) { I.node[i] = nodes++; comp[i] = -1; }
+	}
+	I.nodes = nodes;
+
+	// assign the modes
+	bool hasDisp = false;
+	vector<int> mode;
+	for (int i = 0; i < neq; ++i)
+	{
+		if ((comp[i] >= 0) && (comp[i] < 6)) hasDisp = true;
+		else
+		{
+			int c = (comp[i] < 0 ? 0 : comp[i] - 5);
+			if (c >= (int)mode.size()) mode.resize(c + 1, -1);
+			mode[c] = 0;
+		}
+	}
+	int k = (hasDisp ? 6 : 0);
+	for (int c = 0; c < (int)mode.size(); ++c) if (mode[c] == 0) mode[c] = k++;
+	I.nmodes = k;
+
+	// center of the displacement nodes
+	vec3d c0(0, 0, 0);
+	int nc = 0;
+	for (int i = 0; i < neq; ++i) if ((comp[i] >= 0) && (comp[i] < 6)) { c0 += pos[i]; nc++; }
+	if (nc > 0) c0 /= (double)nc;
+
+	I.B.assign((size_t)neq*k, 0.0);
+	for (int i = 0; i < neq; ++i)
+	{
+		double* b = &I.B[(size_t)i*k];
+		if ((comp[i] >= 0) && (comp[i] < 6))
+		{
+			int d = comp[i] % 3;
+			vec3d r = pos[i] - c0;
+
+			// translation
+			b[d] = 1.0;
+
+			// rotations about x, y, z
+			if (d == 0) { b[4] =  r.z; b[5] = -r.y; }
+			if (d == 1) { b[3] = -r.z; b[5] =  r.x; }
+			if (d == 2) { b[3] =  r.y; b[4] = -r.x; }
+		}
+		else
+		{
+			int c = (comp[i] < 0 ? 0 : comp[i] - 5);
+			b[mode[c]] = 1.0;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::Factor()
+{
+	CompactMatrix* K = dynamic_cast<CompactMatrix*>(GetSparseMatrix());
+	if (K == nullptr) return false;
+
+	int neq = K->Rows();
+	int nnz = (int)K->NonZeroes();
+	bool reuse = m_reuse && (m->levels.size() > 1) && (neq == m->neq0) && (nnz == m->nnz0);
+
+	if (m->CopyMatrix(K) == false) return false;
+
+	if (reuse)
+	{
+		m->Update();
+	}
+	else
+	{
+		if (m->levels.size() > 1) m->levels.resize(1);
+		BuildNearNullSpace(neq);
+		m->Setup(m_maxLevels, m_coarseSize, m_theta);
+		m->neq0 = neq;
+		m->nnz0 = nnz;
+	}
+
+	if (m_printLevel > 0)
+	{
+		feLog("AMG hierarchy%s:\n", (reuse ? " (reused)" : ""));
+		for (int l = 0; l < (int)m->levels.size(); ++l)
+		{
+			const AMGMatrix& A = m->levels[l].A;
+			feLog("\tlevel %d: %d equations, %d nonzeroes\n", l, A.rows, A.NonZeroes());
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::BackSolve(double* x, double* y)
+{
+	if (m->levels.empty()) return false;
+
+	Impl::Level& L = m->levels[0];
+	int n = L.A.rows;
+
+	// first cycle
+	for (int i = 0; i < n; ++i) L.b[i] = y[i];
+	m->Cycle(0, m_degree);
+	for (int i = 0; i < n; ++i) x[i] = L.x[i];
+
+	// additional cycles on the residual
+	vector<double> r(m_cycles > 1 ? n : 0);
+	for (int k = 1; k < m_cycles; ++k)
+	{
+		L.A.residual(x, y, &r[0]);
+		for (int i = 0; i < n; ++i) L.b[i] = r[i];
+		m->Cycle(0, m_degree);
+		for (int i = 0; i < n; ++i) x[i] += L.x[i];
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::Destroy()
+{
+	m->Clear();
+}
@@ -0,0 +1,77 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+
+//-----------------------------------------------------------------------------
+//! Native smoothed aggregation algebraic multigrid preconditioner.
+//! The equations are aggregated per node and the near null space is spanned
+//! by the rigid body modes that are computed from the nodal coordinates of the mesh.
+//! (Degrees of freedom that are not displacements only contribute a constant mode.)
+//! One application of the preconditioner does one or more V-cycles with Chebyshev smoothing, 
+//! which keeps the preconditioner symmetric so it can be used with CG as well as GMRES.
+//! When the matrix profile does not change between factorizations, the prolongators
+//! can be reused and only the coarse operators are recomputed.
+class AMGPreconditioner : public Preconditioner
+{
+	class Impl;
+
+public:
+	AMGPreconditioner(FEModel* fem);
+	~AMGPreconditioner();
+
+	// setup the multigrid hierarchy
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+	// clean up
+	void Destroy() override;
+
+	void SetPrintLevel(int n) override;
+
+private:
+	// setup the near null space for the equations of the model
+	void BuildNearNullSpace(int neq);
+
+private:
+	Impl*	m;
+
+	int		m_maxLevels;	//!< max number of levels
+	int		m_coarseSize;	//!< max size of coarsest level
+	double	m_theta;		//!< strength of connection threshold
+	int		m_degree;		//!< degree of Chebyshev smoother
+	int		m_cycles;		//!< number of V-cycles per application
+	bool	m_rbm;			//!< use rigid body modes for the near null space
+	bool	m_reuse;		//!< reuse the prolongators when the matrix profile does not change
+	int		m_printLevel;	//!< print level
+
+	DECLARE_FECORE_CLASS();
+};
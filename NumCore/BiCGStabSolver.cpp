@@ -26,6 +26,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "BiCGStabSolver.h"
 #include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/BlockCSRMatrix.h>
 #include <FECore/log.h>
 
 //-----------------------------------------------------------------------------
@@ -34,6 +35,7 @@ BEGIN_FECORE_CLASS(BiCGStabSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_tol, "tol");
 	ADD_PARAMETER(m_maxiter, "max_iter");
 	ADD_PARAMETER(m_fail_max_iter, "fail_max_iters");
+	ADD_PARAMETER(m_blockSize, "block_size");
 	ADD_PROPERTY(m_P, "pc_left")->SetFlags(FEProperty::Optional);
 END_FECORE_CLASS();
 
@@ -45,22 +47,35 @@ BiCGStabSolver::BiCGStabSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(
 	m_abstol = 0.0;
 	m_print_level = 0;
 	m_fail_max_iter = true;
+	m_blockSize = 0;
 }
 
 //-----------------------------------------------------------------------------
 SparseMatrix* BiCGStabSolver::CreateSparseMatrix(Matrix_Type ntype)
 {
+	// The block format is only supported by the diagonal preconditioner. The other 
+	// preconditioners require a compact matrix format.
+	if ((m_blockSize > 0) && m_P && (dynamic_cast<DiagonalPreconditioner*>(m_P) == nullptr))
+	{
+		feLogError("The block_size option of the bicgstab solver can only be used with the diagonal preconditioner.");
+		return 0;
+	}
+
 	// let the preconditioner decide
 	m_pA = nullptr;
-	if (m_P)
+	if (m_P && (m_blockSize <= 0))
 	{
 		m_P->SetPartitions(m_part);
 		m_pA = m_P->CreateSparseMatrix(ntype);
 	}
-	else
+
+	// if the preconditioner doesn't care, allocate the matrix ourselves
+	if (m_pA == nullptr)
 	{
-		if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix;
+		if (m_blockSize > 0) m_pA = new BlockCSRMatrix(m_blockSize);
+		else if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix;
 		else m_pA = new CRSSparseMatrix(1);
+		if (m_P) m_P->SetSparseMatrix(m_pA);
 	}
 	return m_pA;
 }
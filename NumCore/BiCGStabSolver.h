@@ -59,6 +59,7 @@ protected:
 	double	m_abstol;		// absolute residual tolerance
 	int		m_print_level;	// output level
 	double	m_fail_max_iter;
+	int		m_blockSize;	// block size of block CSR matrix (0 = don't use block format)
 
 	DECLARE_FECORE_CLASS();
 };
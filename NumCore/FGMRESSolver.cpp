@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FGMRESSolver.h"
 #include <FECore/CompactSymmMatrix.h>
 #include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/BlockCSRMatrix.h>
 #include <FECore/log.h>
 #include "MatrixTools.h"
 
@@ -52,6 +53,7 @@ BEGIN_FECORE_CLASS(FGMRESSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_reltol        , "tol");
 	ADD_PARAMETER(m_abstol        , "abs_tol");
 	ADD_PARAMETER(m_maxIterFail   , "fail_max_iters");
+	ADD_PARAMETER(m_blockSize     , "block_size");
 
 	ADD_PROPERTY(m_P, "pc_left")->SetFlags(FEProperty::Optional);
 	ADD_PROPERTY(m_R, "pc_right")->SetFlags(FEProperty::Optional);
@@ -75,6 +77,7 @@ FGMRESSolver::FGMRESSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0)
 	m_R = 0;	// no right preconditioner
 
 	m_maxIterFail = true;
+	m_blockSize = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -190,28 +193,44 @@ void FGMRESSolver::DoJacobiPreconditioning(bool b)
 //-----------------------------------------------------------------------------
 SparseMatrix* FGMRESSolver::CreateSparseMatrix(Matrix_Type ntype)
 {
-#ifdef MKL_ISS
 	// Cleanup if necessary
 	if (m_pA) delete m_pA; 
 	m_pA = nullptr;
 
+	// The block format is only supported by the diagonal preconditioner. The other 
+	// preconditioners require a compact matrix format.
+	if (m_blockSize > 0)
+	{
+		if ((m_P && (dynamic_cast<DiagonalPreconditioner*>(m_P) == nullptr)) ||
+			(m_R && (dynamic_cast<DiagonalPreconditioner*>(m_R) == nullptr)))
+		{
+			feLogError("The block_size option of the fgmres solver can only be used with the diagonal preconditioner.");
+			return nullptr;
+		}
+	}
+
 	// since FMGRES doesn't really care what matrix is requested, 
 	// see if the preconditioner cares.
-	if (m_P)
+	if (m_P && (m_blockSize <= 0))
 	{
 		m_P->SetPartitions(m_part);
 		m_pA = m_P->CreateSparseMatrix(ntype);
-		return m_pA;
+		if (m_pA) return m_pA;
 	}
-	else if (m_R)
+	else if (m_R && (m_blockSize <= 0))
 	{
 		m_R->SetPartitions(m_part);
 		m_pA = m_R->CreateSparseMatrix(ntype);
-		return m_pA;
+		if (m_pA) return m_pA;
 	}
 
 	// if the matrix is still zero, let's just allocate one
-	if (m_pA == nullptr)
+	if ((m_pA == nullptr) && (m_blockSize > 0))
+	{
+		// the block format can store any of the matrix types
+		m_pA = new BlockCSRMatrix(m_blockSize);
+	}
+	else if (m_pA == nullptr)
 	{
 		// allocate new matrix
 		switch (ntype)
@@ -222,11 +241,16 @@ SparseMatrix* FGMRESSolver::CreateSparseMatrix(Matrix_Type ntype)
 		}
 	}
 
+	// a preconditioner that doesn't allocate its own matrix (i.e. the diagonal 
+	// preconditioner) works on the matrix of the solver
+	if (m_pA)
+	{
+		if (m_P) m_P->SetSparseMatrix(m_pA);
+		if (m_R) m_R->SetSparseMatrix(m_pA);
+	}
+
 	// return the matrix (Can be null if matrix format not supported!)
 	return m_pA;
-#else
-	return 0;
-#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -247,10 +271,10 @@ void FGMRESSolver::Destroy()
 //-----------------------------------------------------------------------------
 bool FGMRESSolver::PreProcess() 
 {
-#ifdef MKL_ISS
 	// number of equations
-	MKL_INT N = m_pA->Rows();
+	int N = m_pA->Rows();
 
+#ifdef MKL_ISS
 	int M = (N < 150 ? N : 150); // this is the default value of ipar[14]
 
 	if (m_nrestart > 0) M = m_nrestart;
@@ -258,15 +282,13 @@ bool FGMRESSolver::PreProcess()
 
 	// allocate temp storage
 	m_tmp.resize((N*(2 * M + 1) + (M*(M + 9)) / 2 + 1));
+#endif
 
 	m_Rv.resize(N);
 
 	m_W.resize(N, 1.0);
 
 	return true; 
-#else
-	return false;
-#endif
 }
 
 
@@ -443,7 +465,175 @@ bool FGMRESSolver::BackSolve(double* x, double* b)
 	return bconverged;
 
 #else
-	return false;
+	// make sure we have a matrix
+	if (m_pA == 0) return false;
+
+	// number of equations
+	int N = m_pA->Rows();
+
+	// use the same defaults as the MKL implementation
+	int M = (N < 150 ? N : 150);
+
+	int nrestart = M;
+	if (m_nrestart > 0) nrestart = m_nrestart;
+	else if (m_maxiter > 0) nrestart = m_maxiter;
+
+	int maxIter = M;
+	if (m_maxiter > 0) maxIter = m_maxiter;
+	if (nrestart > maxIter) nrestart = maxIter;
+
+	double reltol = (m_reltol > 0 ? m_reltol : 1e-6);
+	double abstol = (m_abstol > 0 ? m_abstol : 0.0);
+
+	// scale rhs
+	vector<double> F(N);
+	for (int i = 0; i < N; ++i) F[i] = m_W[i] * b[i];
+
+	// zero solution vector
+	for (int i = 0; i < N; ++i) x[i] = 0.0;
+
+	// Krylov basis V and, when preconditioned, the preconditioned basis Z
+	vector< vector<double> > V(nrestart + 1, vector<double>(N));
+	vector< vector<double> > Z(m_P ? nrestart : 0, vector<double>(N));
+	vector< vector<double> > H(nrestart + 1, vector<double>(nrestart, 0.0));
+	vector<double> cs(nrestart), sn(nrestart), g(nrestart + 1), y(nrestart);
+	vector<double> w(N);
+
+	if (m_print_level > 0) feLog("FGMRES:\n");
+
+	// initial residual
+	V[0] = F;
+	double beta = sqrt(V[0] * V[0]);
+	double tol = reltol*beta + abstol;
+
+	bool bconverged = (beta == 0.0);
+	bool bfailed = false;
+	int iter = 0;
+	double res = beta;
+	while (!bconverged && !bfailed && (iter < maxIter))
+	{
+		for (int i = 0; i < N; ++i) V[0][i] /= beta;
+		g.assign(nrestart + 1, 0.0);
+		g[0] = beta;
+
+		int j = 0;
+		while ((j < nrestart) && (iter < maxIter))
+		{
+			// apply the (flexible) preconditioner
+			double* zj = &V[j][0];
+			if (m_P)
+			{
+				zj = &Z[j][0];
+				if (m_P->mult_vector(&V[j][0], zj) == false) { bfailed = true; break; }
+			}
+
+			// do matrix-vector multiplication
+			if (m_R)
+			{
+				m_R->mult_vector(zj, &m_Rv[0]);
+				m_pA->mult_vector(&m_Rv[0], &w[0]);
+			}
+			else m_pA->mult_vector(zj, &w[0]);
+
+			// modified Gram-Schmidt
+			for (int i = 0; i <= j; ++i)
+			{
+				double hij = w*V[i];
+				H[i][j] = hij;
+				const double* vi = &V[i][0];
+				for (int k = 0; k < N; ++k) w[k] -= hij*vi[k];
+			}
+			double hn = sqrt(w*w);
+
+			// apply previous Givens rotations to the new column of H
+			for (int i = 0; i < j; ++i)
+			{
+				double h0 = H[i][j], h1 = H[i + 1][j];
+				H[i    ][j] =  cs[i] * h0 + sn[i] * h1;
+				H[i + 1][j] = -sn[i] * h0 + cs[i] * h1;
+			}
+
+			// new rotation that eliminates H[j+1][j]
+			double hjj = H[j][j];
+			double d = sqrt(hjj*hjj + hn*hn);
+			cs[j] = (d != 0.0 ? hjj / d : 1.0);
+			sn[j] = (d != 0.0 ? hn / d : 0.0);
+			H[j][j] = d;
+			g[j + 1] = -sn[j] * g[j];
+			g[j] = cs[j] * g[j];
+
+			j++;
+			iter++;
+			res = fabs(g[j]);
+
+			if (m_print_level > 1) feLog("%3d = %lg (%lg)\n", iter, res, tol);
+
+			if (m_doResidualTest && (res <= tol)) { bconverged = true; break; }
+
+			// check for breakdown, in which case the solution is exact
+			if (m_doZeroNormTest && (hn <= 1e-30*d)) { bconverged = true; break; }
+			if (hn == 0.0) { bconverged = true; break; }
+
+			for (int k = 0; k < N; ++k) V[j][k] = w[k] / hn;
+		}
+
+		// solve the upper triangular system H y = g
+		for (int i = j - 1; i >= 0; --i)
+		{
+			double s = g[i];
+			for (int k = i + 1; k < j; ++k) s -= H[i][k] * y[k];
+			y[i] = s / H[i][i];
+		}
+
+		// update the solution
+		for (int i = 0; i < j; ++i)
+		{
+			const double* zi = (m_P ? &Z[i][0] : &V[i][0]);
+			for (int k = 0; k < N; ++k) x[k] += y[i] * zi[k];
+		}
+
+		// compute the residual for the restart
+		if (!bconverged && !bfailed && (iter < maxIter))
+		{
+			if (m_R)
+			{
+				m_R->mult_vector(x, &m_Rv[0]);
+				m_pA->mult_vector(&m_Rv[0], &w[0]);
+			}
+			else m_pA->mult_vector(x, &w[0]);
+
+			for (int k = 0; k < N; ++k) V[0][k] = F[k] - w[k];
+			beta = sqrt(V[0] * V[0]);
+			res = beta;
+			if (beta == 0.0) bconverged = true;
+			else if (m_doResidualTest && (beta <= tol)) bconverged = true;
+		}
+	}
+
+	// without the residual test, we are done when all iterations are done
+	if (!bfailed && !m_doResidualTest) bconverged = true;
+	if (!bfailed && !bconverged && !m_maxIterFail) bconverged = true;
+
+	if (m_do_jacobi)
+	{
+		for (int i = 0; i < N; ++i) x[i] *= m_W[i];
+	}
+
+	if (m_R)
+	{
+		m_R->mult_vector(&x[0], &m_Rv[0]);
+		for (int i = 0; i < N; ++i) x[i] = m_Rv[i];
+	}
+
+	if (m_print_level > 0)
+	{
+		feLog("%3d = %lg (%lg)\n", iter, res, tol);
+	}
+
+	// update stats
+	UpdateStats(iter);
+
+	return bconverged;
 #endif // MKL_ISS
 }
 
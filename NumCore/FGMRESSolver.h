@@ -116,6 +116,7 @@ private:
 	bool	m_maxIterFail;
 	bool	m_print_cn;			// Calculate and print the condition number
 	bool	m_do_jacobi;
+	int		m_blockSize;		// block size of block CSR matrix (0 = don't use block format)
 
 private:
 	SparseMatrix*	m_pA;		//!< the sparse matrix format
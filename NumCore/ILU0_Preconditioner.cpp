@@ -118,6 +118,93 @@ bool ILU0_Preconditioner::BackSolve(double* x, double* y)
 }
 
 #else
-bool ILU0_Preconditioner::Factor() { return false; }
-bool ILU0_Preconditioner::BackSolve(double* x, double* y) { return false; }
+bool ILU0_Preconditioner::Factor()
+{
+	if (m_K == 0) m_K = dynamic_cast<CRSSparseMatrix*>(GetSparseMatrix());
+	if (m_K == 0) return false;
+
+	int N = m_K->Rows();
+	int NNZ = m_K->NonZeroes();
+	int offset = m_K->Offset();
+
+	double* pa = m_K->Values();
+	int* ia = m_K->Pointers();
+	int* ja = m_K->Indices();
+
+	// the triangles have the same structure as the matrix
+	m_L.Create(N, ia, ja, offset, true, true);
+	m_U.Create(N, ia, ja, offset, false, false);
+
+	// location of diagonal elements
+	m_diag.assign(N, -1);
+	for (int i = 0; i < N; ++i)
+	{
+		for (int k = ia[i] - offset; k < ia[i + 1] - offset; ++k)
+			if (ja[k] - offset == i) { m_diag[i] = k; break; }
+		if (m_diag[i] < 0) return false;
+	}
+
+	m_tmp.resize(N, 0.0);
+	m_bilu0.assign(pa, pa + NNZ);
+	double* a = &m_bilu0[0];
+
+	// The rows are factored level by level, using the levels of the lower triangle,
+	// since a row only depends on the rows of its lower triangle.
+	bool bok = true;
+	int nlevels = m_L.Levels();
+#pragma omp parallel
+	{
+		vector<int> iw(N, -1);
+		for (int l = 0; l < nlevels; ++l)
+		{
+			const int* rows = m_L.LevelRows(l);
+			int nrows = m_L.LevelSize(l);
+#pragma omp for schedule(dynamic, 64)
+			for (int q = 0; q < nrows; ++q)
+			{
+				int i = rows[q];
+				int k0 = ia[i] - offset;
+				int k1 = ia[i + 1] - offset;
+				for (int k = k0; k < k1; ++k) iw[ja[k] - offset] = k;
+
+				for (int k = k0; k < k1; ++k)
+				{
+					int j = ja[k] - offset;
+					if (j >= i) continue;
+
+					// l_ij = a_ij / u_jj
+					double lij = a[k] / a[m_diag[j]];
+					a[k] = lij;
+
+					// a_im -= l_ij * u_jm (only where a_im is in the pattern)
+					for (int m = m_diag[j] + 1; m < ia[j + 1] - offset; ++m)
+					{
+						int im = iw[ja[m] - offset];
+						if (im >= 0) a[im] -= lij * a[m];
+					}
+				}
+
+				// check the diagonal
+				double& uii = a[m_diag[i]];
+				if (m_checkZeroDiagonal && (fabs(uii) < m_zeroThreshold)) uii = m_zeroReplace;
+				if (uii == 0.0) bok = false;
+
+				for (int k = k0; k < k1; ++k) iw[ja[k] - offset] = -1;
+			}
+		}
+	}
+	if (bok == false) return false;
+
+	m_L.SetValues(a);
+	m_U.SetValues(a);
+
+	return true;
+}
+
+bool ILU0_Preconditioner::BackSolve(double* x, double* y)
+{
+	m_L.Solve(y, &m_tmp[0]);
+	m_U.Solve(&m_tmp[0], x);
+	return true;
+}
 #endif
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "SparseTriangle.h"
 
 //-----------------------------------------------------------------------------
 class ILU0_Preconditioner : public Preconditioner
@@ -54,5 +55,10 @@ private:
 	vector<double>		m_tmp;
 	CRSSparseMatrix*	m_K;
 
+	// used by native implementation
+	vector<int>			m_diag;	// location of diagonal elements
+	SparseTriangle		m_L;	// unit lower triangle
+	SparseTriangle		m_U;	// upper triangle
+
 	DECLARE_FECORE_CLASS();
 };
@@ -28,6 +28,8 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "ILUT_Preconditioner.h"
+#include <algorithm>
+#include <functional>
 #include <FECore/CompactUnSymmMatrix.h>
 
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
@@ -50,6 +52,8 @@ END_FECORE_CLASS();
 
 ILUT_Preconditioner::ILUT_Preconditioner(FEModel* fem) : Preconditioner(fem)
 {
+	m_K = nullptr;
+
 	m_maxfill = 1;
 	m_fillTol = 1e-16;
 
@@ -123,6 +127,137 @@ bool ILUT_Preconditioner::BackSolve(double* x, double* y)
 	return true;
 }
 #else
-bool ILUT_Preconditioner::Factor() { return false; }
-bool ILUT_Preconditioner::BackSolve(double* x, double* y) { return false; }
-#endif
\ No newline at end of file
+// This is Saad's ILUT(p, tau), where p = maxfill is the max number of entries that are
+// kept in each row of L and U (besides the diagonal) and tau = filltol is the drop 
+// tolerance relative to the norm of the row.
+// Unlike ILU0, the factorization is not level-scheduled: the fill-in that is kept
+// in a row depends on the factored rows above it, so the dependencies between the 
+// rows (and hence the levels) are only known once those rows have been factored.
+// The triangular solves do use the levels of the final factor.
+bool ILUT_Preconditioner::Factor()
+{
+	if (m_K == 0) m_K = dynamic_cast<CRSSparseMatrix*>(GetSparseMatrix());
+	if (m_K == 0) return false;
+
+	int N = m_K->Rows();
+	int offset = m_K->Offset();
+
+	double* pa = m_K->Values();
+	int* ia = m_K->Pointers();
+	int* ja = m_K->Indices();
+
+	int p = (m_maxfill > 0 ? m_maxfill : 0);
+
+	// the factor is stored in a single (zero-based) compressed row matrix
+	m_ibilut.assign(N + 1, 0);
+	m_jbilut.clear();
+	m_bilut.clear();
+	m_jbilut.reserve((2 * p + 1)*N);
+	m_bilut.reserve((2 * p + 1)*N);
+	vector<int> udiag(N, -1);	// location of diagonal of U
+
+	vector<double> w(N, 0.0);	// work row
+	vector<int> iw(N, -1);		// flags columns that are in the work row
+	vector<int> jw;				// columns in work row
+	vector<int> lcols, lkeep, cols;
+	vector<pair<double, int> > tmp;
+	for (int i = 0; i < N; ++i)
+	{
+		// copy row i into the work row
+		jw.clear();
+		double rnorm = 0.0;
+		for (int k = ia[i] - offset; k < ia[i + 1] - offset; ++k)
+		{
+			int j = ja[k] - offset;
+			w[j] = pa[k];
+			iw[j] = 1;
+			jw.push_back(j);
+			rnorm += pa[k] * pa[k];
+		}
+		rnorm = sqrt(rnorm);
+		double tol = m_fillTol*rnorm;
+		if (iw[i] < 0) { iw[i] = 1; jw.push_back(i); w[i] = 0.0; }
+
+		// eliminate the lower part in increasing column order
+		lcols.clear();
+		lkeep.clear();
+		for (int n = 0; n < (int)jw.size(); ++n) if (jw[n] < i) lcols.push_back(jw[n]);
+		make_heap(lcols.begin(), lcols.end(), greater<int>());
+		while (lcols.empty() == false)
+		{
+			pop_heap(lcols.begin(), lcols.end(), greater<int>());
+			int k = lcols.back(); lcols.pop_back();
+
+			double wk = w[k] / m_bilut[udiag[k]];
+			if (fabs(wk) <= tol) { w[k] = 0.0; continue; }
+			w[k] = wk;
+			lkeep.push_back(k);
+
+			// w -= wk * (row k of U)
+			for (int m = udiag[k] + 1; m < m_ibilut[k + 1]; ++m)
+			{
+				int j = m_jbilut[m];
+				if (iw[j] < 0)
+				{
+					// fill-in
+					iw[j] = 1;
+					jw.push_back(j);
+					w[j] = 0.0;
+					if (j < i) { lcols.push_back(j); push_heap(lcols.begin(), lcols.end(), greater<int>()); }
+				}
+				w[j] -= wk*m_bilut[m];
+			}
+		}
+
+		// keep the p largest entries of L
+		tmp.clear();
+		for (int n = 0; n < (int)lkeep.size(); ++n) tmp.push_back(pair<double, int>(-fabs(w[lkeep[n]]), lkeep[n]));
+		if ((int)tmp.size() > p) { nth_element(tmp.begin(), tmp.begin() + p, tmp.end()); tmp.resize(p); }
+		cols.clear();
+		for (int n = 0; n < (int)tmp.size(); ++n) cols.push_back(tmp[n].second);
+		sort(cols.begin(), cols.end());
+		for (int n = 0; n < (int)cols.size(); ++n) { m_jbilut.push_back(cols[n]); m_bilut.push_back(w[cols[n]]); }
+
+		// diagonal
+		double uii = w[i];
+		if (m_checkZeroDiagonal && (fabs(uii) < m_zeroThreshold)) uii = m_zeroReplace;
+		if (uii == 0.0) return false;
+		udiag[i] = (int)m_jbilut.size();
+		m_jbilut.push_back(i);
+		m_bilut.push_back(uii);
+
+		// keep the p largest entries of U
+		tmp.clear();
+		for (int n = 0; n < (int)jw.size(); ++n)
+		{
+			int j = jw[n];
+			if ((j > i) && (fabs(w[j]) > tol)) tmp.push_back(pair<double, int>(-fabs(w[j]), j));
+		}
+		if ((int)tmp.size() > p) { nth_element(tmp.begin(), tmp.begin() + p, tmp.end()); tmp.resize(p); }
+		cols.clear();
+		for (int n = 0; n < (int)tmp.size(); ++n) cols.push_back(tmp[n].second);
+		sort(cols.begin(), cols.end());
+		for (int n = 0; n < (int)cols.size(); ++n) { m_jbilut.push_back(cols[n]); m_bilut.push_back(w[cols[n]]); }
+		m_ibilut[i + 1] = (int)m_jbilut.size();
+
+		// clear work row
+		for (int n = 0; n < (int)jw.size(); ++n) { w[jw[n]] = 0.0; iw[jw[n]] = -1; }
+	}
+
+	m_L.Create(N, &m_ibilut[0], &m_jbilut[0], 0, true, true);
+	m_U.Create(N, &m_ibilut[0], &m_jbilut[0], 0, false, false);
+	m_L.SetValues(&m_bilut[0]);
+	m_U.SetValues(&m_bilut[0]);
+
+	m_tmp.resize(N, 0.0);
+
+	return true;
+}
+
+bool ILUT_Preconditioner::BackSolve(double* x, double* y)
+{
+	m_L.Solve(y, &m_tmp[0]);
+	m_U.Solve(&m_tmp[0], x);
+	return true;
+}
+#endif
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "SparseTriangle.h"
 
 //-----------------------------------------------------------------------------
 class ILUT_Preconditioner : public Preconditioner
@@ -57,5 +58,9 @@ private:
 	vector<int>		m_ibilut;
 	vector<double>	m_tmp;
 
+	// used by native implementation
+	SparseTriangle	m_L;	// unit lower triangle
+	SparseTriangle	m_U;	// upper triangle
+
 	DECLARE_FECORE_CLASS();
 };
@@ -58,7 +58,9 @@ bool IncompleteCholesky::Factor()
 	CompactSymmMatrix* K = dynamic_cast<CompactSymmMatrix*>(GetSparseMatrix());
 	if (K == nullptr) return false;
 
+#ifdef MKL_ISS
 	if (K->Offset() != 1) return false;
+#endif
 
 	int N = K->Rows();
 	int nnz = K->NonZeroes();
@@ -85,68 +87,112 @@ bool IncompleteCholesky::Factor()
 	for (int i = 0; i <= N; ++i) col[i] = acol[i];
 
 	CompactSymmMatrix& L = *m_L;
-
-	vector<double> tmp(N, 0.0);
-
-	// fill in the values
 	int offset = m_L->Offset();
+
+	// sanity check: the first entry of each column must be the diagonal
 	for (int k = 0; k < N; ++k)
 	{
-		// get the values for column k
-		double* ak = val + (col[k] - offset);
-		int* rowk = row + (col[k] - offset);
-		int Lk = col[k + 1] - col[k];
-
-		// sanity check
-		if (rowk[0] - offset != k)
+		if (row[col[k] - offset] - offset != k)
 		{
 			feLogError("Fatal error in incomplete Cholesky preconditioner:\nMatrix format error at row %d.", k);
 			return false;
 		}
+	}
 
-		// make sure the diagonal element is not zero
-		if (ak[0] == 0.0)
-		{
-			feLogError("Fatal error in incomplete Cholesky preconditioner:\nZero diagonal element at row %d.", k);
-			return false;
-		}
-
-		// make sure the diagonal element is not negative either
-		if (ak[0] < 0.0)
-		{
-			feLogError("Fatal error in incomplete Cholesky preconditioner:\nNegative diagonal element at row %d (value = %lg).", k, ak[0]);
-			return false;
-		}
-
-		// set the diagonal element
-		double akk = sqrt(ak[0]);
-		ak[0] = akk;
-		tmp[rowk[0] - offset] = akk;
-
-		// divide column by akk
-		for (int j = 1; j < Lk; ++j)
+	// The factor is stored by columns, which is L^T stored by rows. We also need L 
+	// stored by rows, both for the forward substitution and for the factorization, 
+	// since column k of L depends on the columns j < k for which l_kj is nonzero.
+	// The source locations of the values of L are kept so we can copy the values
+	// after the factorization.
+	vector<int> ptr(N + 1, 0), ind(nnz), src(nnz);
+	for (int i = 0; i < nnz; ++i) ptr[row[i] - offset + 1]++;
+	for (int i = 0; i < N; ++i) ptr[i + 1] += ptr[i];
+	vector<int> pos(ptr.begin(), ptr.end() - 1);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = col[j] - offset; k < col[j + 1] - offset; ++k)
 		{
-			ak[j] /= akk;
-			tmp[rowk[j] - offset] = ak[j];
+			int n = pos[row[k] - offset]++;
+			ind[n] = j;
+			src[n] = k;
 		}
-
-		// loop over all other columns
-		for (int _j = 1; _j < Lk; ++_j)
+	}
+	m_Lr.Create(N, &ptr[0], &ind[0], 0, true, false);
+
+	// The columns are factored level by level, using the levels of L. Each column 
+	// is only updated by the columns it depends on (left-looking), so that the 
+	// columns of a level can be processed concurrently.
+	int errRow = -1, errType = 0;
+	double errVal = 0.0;
+	int nlevels = m_Lr.Levels();
+#pragma omp parallel
+	{
+		vector<int> iw(N, -1);
+		for (int l = 0; l < nlevels; ++l)
 		{
-			int j = rowk[_j] - offset;
-			double tjk = tmp[j];
-			if (tjk != 0.0)
+			const int* cols = m_Lr.LevelRows(l);
+			int ncols = m_Lr.LevelSize(l);
+#pragma omp for schedule(dynamic, 64)
+			for (int q = 0; q < ncols; ++q)
 			{
-				double* aj = val + col[j] - offset;
-				int Lj = col[j + 1] - col[j];
-				int* rowj = row + col[j] - offset;
-
-				for (int i = 0; i < Lj; i ++) aj[i] -= tmp[rowj[i] - offset] * tjk;
+				int k = cols[q];
+
+				// get the values for column k
+				double* ak = val + (col[k] - offset);
+				int* rowk = row + (col[k] - offset);
+				int Lk = col[k + 1] - col[k];
+				for (int i = 0; i < Lk; ++i) iw[rowk[i] - offset] = i;
+
+				// subtract the contributions of the columns j < k with l_kj != 0
+				for (int n = ptr[k]; n < ptr[k + 1]; ++n)
+				{
+					int j = ind[n];
+					if (j == k) continue;
+
+					// l_kj, followed by the entries of column j in rows >= k
+					int p = src[n];
+					double lkj = val[p];
+					int p1 = col[j + 1] - offset;
+					for (int m = p; m < p1; ++m)
+					{
+						int i = iw[row[m] - offset];
+						if (i >= 0) ak[i] -= val[m] * lkj;
+					}
+				}
+				for (int i = 0; i < Lk; ++i) iw[rowk[i] - offset] = -1;
+
+				// make sure the diagonal element is not zero or negative
+				if (ak[0] <= 0.0)
+				{
+#pragma omp critical
+					{
+						if ((errRow < 0) || (k < errRow))
+						{
+							errRow = k;
+							errType = (ak[0] == 0.0 ? 1 : 2);
+							errVal = ak[0];
+						}
+					}
+					continue;
+				}
+
+				// set the diagonal element and divide column by akk
+				double akk = sqrt(ak[0]);
+				ak[0] = akk;
+				for (int j = 1; j < Lk; ++j) ak[j] /= akk;
 			}
 		}
+	}
 
-		// reset temp buffer
-		for (int j = 0; j < Lk; ++j) tmp[rowk[j] - offset] = 0.0;
+	if (errType == 1)
+	{
+		feLogError("Fatal error in incomplete Cholesky preconditioner:\nZero diagonal element at row %d.", errRow);
+		return false;
+	}
+	else if (errType == 2)
+	{
+		feLogError("Fatal error in incomplete Cholesky preconditioner:\nNegative diagonal element at row %d (value = %lg).", errRow, errVal);
+		return false;
 	}
 
 	for (int i = 0; i < N; ++i)
@@ -155,6 +201,15 @@ bool IncompleteCholesky::Factor()
 		assert(Lii != 0.0);
 	}
 
+#ifndef MKL_ISS
+	m_LT.Create(N, col, row, offset, false, false);
+	m_LT.SetValues(val);
+
+	vector<double> tval(nnz);
+	for (int i = 0; i < nnz; ++i) tval[i] = val[src[i]];
+	m_Lr.SetValues(&tval[0]);
+#endif
+
 	return true;
 }
 
@@ -177,6 +232,8 @@ bool IncompleteCholesky::BackSolve(double* x, double* y)
 
 	return true;
 #else 
+	m_Lr.Solve(y, &z[0]);
+	m_LT.Solve(&z[0], x);
 	return true;
 #endif
 }
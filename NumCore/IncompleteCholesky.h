@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "SparseTriangle.h"
 
 class CompactSymmMatrix;
 
@@ -48,4 +49,8 @@ public:
 private:
 	CompactSymmMatrix*	m_L;
 	vector<double>		z;
+
+	// used by native implementation
+	SparseTriangle		m_Lr;	// factor L, stored by rows
+	SparseTriangle		m_LT;	// transpose of L, stored by rows
 };
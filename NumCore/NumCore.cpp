@@ -48,6 +48,8 @@ SOFTWARE.*/
 #include "AccelerateSparseSolver.h"
 #include "SuperLU_MT.h"
 #include "MKLDSSolver.h"
+#include "SupernodalSolver.h"
+#include "AMGPreconditioner.h"
 #include "numcore_api.h"
 
 //=============================================================================
@@ -71,11 +73,13 @@ NUMCORE_API void NumCore::InitModule()
     REGISTER_FECORE_CLASS(AccelerateSparseSolver, "accelerate");
     REGISTER_FECORE_CLASS(SuperLU_MT_Solver     , "superlu_mt");
     REGISTER_FECORE_CLASS(MKLDSSolver           , "mkl_dss");
+    REGISTER_FECORE_CLASS(SupernodalSolver      , "supernodal");
 
 	// register preconditioners
 	REGISTER_FECORE_CLASS(ILU0_Preconditioner, "ilu0");
 	REGISTER_FECORE_CLASS(ILUT_Preconditioner, "ilut");
 	REGISTER_FECORE_CLASS(IncompleteCholesky , "ichol");
+	REGISTER_FECORE_CLASS(AMGPreconditioner  , "amg");
 
 	// register eigen solvers
 	REGISTER_FECORE_CLASS(FEASTEigenSolver, "feast");
@@ -87,6 +91,6 @@ NUMCORE_API void NumCore::InitModule()
 #ifdef PARDISO
 	fecore.SetDefaultSolverType("pardiso");
 #else
-	fecore.SetDefaultSolverType("skyline");
+	fecore.SetDefaultSolverType("supernodal");
 #endif
 }
@@ -99,6 +99,7 @@ PardisoSolver::PardisoSolver(FEModel* fem) : LinearSolver(fem), m_pA(0)
 	m_mtype = -2;
 	m_iparm3 = false;
 	m_isFactored = false;
+	m_isAnalyzed = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -171,6 +172,9 @@ bool PardisoSolver::PreProcess()
 
 	m_msglvl = 0;	/* 0 Suppress printing, 1 Print statistical information */
 
+	// the matrix structure changed, so we need to redo the symbolic factorization
+	m_isAnalyzed = false;
+
 	return LinearSolver::PreProcess();
 }
 
@@ -183,19 +187,39 @@ bool PardisoSolver::Factor()
 // ------------------------------------------------------------------------------
 // Reordering and Symbolic Factorization.  This step also allocates all memory
 // that is necessary for the factorization.
+// For symmetric matrices, this only depends on the sparsity pattern, so it can be 
+// reused as long as the matrix structure does not change. For unsymmetric matrices,
+// the (default) scaling and matching also depend on the values, so we redo it.
 // ------------------------------------------------------------------------------
 
 	int phase = 11;
 
 	int error = 0;
-	pardiso(m_pt, &m_maxfct, &m_mnum, &m_mtype, &phase, &m_n, m_pA->Values(), m_pA->Pointers(), m_pA->Indices(),
-		 NULL, &m_nrhs, m_iparm, &m_msglvl, NULL, NULL, &error);
-
-	if (error)
+	if ((m_isAnalyzed == false) || (m_mtype == 11))
 	{
-		fprintf(stderr, "\nERROR during symbolic factorization: ");
-		print_err(error);
-		exit(2);
+		// use the user permutation if we have one
+		// (Pardiso expects the new position of each equation)
+		int* pperm = NULL;
+		vector<int> perm;
+		if ((int)m_perm.size() == m_n)
+		{
+			perm.resize(m_n);
+			for (int k = 0; k < m_n; ++k) perm[m_perm[k]] = k + 1;
+			pperm = &perm[0];
+			m_iparm[4] = 1;
+		}
+
+		pardiso(m_pt, &m_maxfct, &m_mnum, &m_mtype, &phase, &m_n, m_pA->Values(), m_pA->Pointers(), m_pA->Indices(),
+			 pperm, &m_nrhs, m_iparm, &m_msglvl, NULL, NULL, &error);
+
+		if (error)
+		{
+			fprintf(stderr, "\nERROR during symbolic factorization: ");
+			print_err(error);
+			exit(2);
+		}
+
+		m_isAnalyzed = true;
 	}
 
 // ------------------------------------------------------------------------------
@@ -312,6 +336,7 @@ void PardisoSolver::Destroy()
 			NULL, &m_nrhs, m_iparm, &m_msglvl, NULL, NULL, &error);
 	}
 	m_isFactored = false;
+	m_isAnalyzed = false;
 }
 #else 
 BEGIN_FECORE_CLASS(PardisoSolver, LinearSolver)
@@ -73,6 +73,7 @@ protected:
 	bool	m_print_cn;	// estimate and print the condition number
 
 	bool	m_isFactored;
+	bool	m_isAnalyzed;	// symbolic factorization was done
 
 	void* m_pt[64]; // Internal solver memory pointer
 
@@ -29,6 +29,8 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "RCICGSolver.h"
 #include "IncompleteCholesky.h"
+#include <FECore/BlockCSRMatrix.h>
+#include <FECore/log.h>
 
 //-----------------------------------------------------------------------------
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
@@ -47,6 +49,7 @@ BEGIN_FECORE_CLASS(RCICGSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_tol, "tol");
 	ADD_PARAMETER(m_maxiter, "max_iter");
 	ADD_PARAMETER(m_fail_max_iters, "fail_max_iters");
+	ADD_PARAMETER(m_blockSize, "block_size");
 	ADD_PROPERTY(m_P, "pc_left")->SetFlags(FEProperty::Optional);
 END_FECORE_CLASS();
 
@@ -57,19 +60,26 @@ RCICGSolver::RCICGSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0), m_
 	m_tol = 1e-5;
 	m_print_level = 0;
 	m_fail_max_iters = true;
+	m_blockSize = 0;
 }
 
 //-----------------------------------------------------------------------------
 SparseMatrix* RCICGSolver::CreateSparseMatrix(Matrix_Type ntype)
 {
-#ifdef MKL_ISS
 	if (ntype != REAL_SYMMETRIC) return 0;
-	m_pA = new CompactSymmMatrix(1);
+
+	// The block format is only supported by the diagonal preconditioner. The other 
+	// preconditioners require a compact matrix format.
+	if ((m_blockSize > 0) && m_P && (dynamic_cast<DiagonalPreconditioner*>(m_P) == nullptr))
+	{
+		feLogError("The block_size option of the cg solver can only be used with the diagonal preconditioner.");
+		return 0;
+	}
+
+	if (m_blockSize > 0) m_pA = new BlockCSRMatrix(m_blockSize);
+	else m_pA = new CompactSymmMatrix(1);
 	if (m_P) m_P->SetSparseMatrix(m_pA);
 	return m_pA;
-#else
-	return 0;
-#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -209,7 +219,77 @@ bool RCICGSolver::BackSolve(double* x, double* b)
 
 	return (m_fail_max_iters ? bsuccess : true);
 #else
-	return false;
+	// make sure we have a matrix
+	if (m_pA == 0) return false;
+
+	// get number of equations
+	int n = m_pA->Rows();
+
+	// max nr of iterations (same default as the MKL solver)
+	int maxiter = (m_maxiter > 0 ? m_maxiter : (n < 150 ? n : 150));
+
+	// zero solution vector
+	for (int i = 0; i<n; ++i) x[i] = 0.0;
+
+	// r = b, since x = 0
+	vector<double> r(b, b + n), z(n), p(n), q(n);
+	double bnorm = sqrt(r*r);
+	if (bnorm == 0.0) { UpdateStats(0); return true; }
+
+	// apply preconditioner
+	if (m_P) m_P->mult_vector(&r[0], &z[0]); else z = r;
+	p = z;
+	double rz = r*z;
+
+	bool bsuccess = false;
+	int niter = 0;
+	double rnorm = bnorm;
+	while (niter < maxiter)
+	{
+		niter++;
+
+		// q = A*p
+		if (m_pA->mult_vector(&p[0], &q[0]) == false) break;
+
+		double pq = p*q;
+		if (pq == 0.0) break;
+		double alpha = rz / pq;
+
+#pragma omp parallel for
+		for (int i = 0; i < n; ++i)
+		{
+			x[i] += alpha*p[i];
+			r[i] -= alpha*q[i];
+		}
+
+		rnorm = sqrt(r*r);
+		if (m_print_level == 1)
+		{
+			fprintf(stderr, "%3d = %lg (%lg)\n", niter, rnorm, bnorm*m_tol);
+		}
+
+		// check convergence
+		if (rnorm <= m_tol*bnorm) { bsuccess = true; break; }
+
+		// apply preconditioner
+		if (m_P) m_P->mult_vector(&r[0], &z[0]); else z = r;
+
+		double rz_new = r*z;
+		double beta = rz_new / rz;
+		rz = rz_new;
+
+#pragma omp parallel for
+		for (int i = 0; i < n; ++i) p[i] = z[i] + beta*p[i];
+	}
+
+	if (m_print_level > 0)
+	{
+		fprintf(stderr, "%3d = %lg (%lg)\n", niter, rnorm, bnorm*m_tol);
+	}
+
+	UpdateStats(niter);
+
+	return (m_fail_max_iters ? bsuccess : true);
 #endif // MKL_ISS
 }
 
@@ -28,6 +28,7 @@ SOFTWARE.*/
 #include <FECore/CompactSymmMatrix.h>
 
 // This class implements an interface to the RCI CG iterative solver from the MKL math library.
+// When MKL is not available, a native preconditioned conjugate gradient method is used.
 class RCICGSolver : public IterativeLinearSolver
 {
 public:
@@ -59,6 +60,7 @@ protected:
 	double	m_tol;			// residual relative tolerance
 	int		m_print_level;	// output level
 	bool	m_fail_max_iters;
+	int		m_blockSize;	// block size of block CSR matrix (0 = don't use block format, otherwise only the diagonal preconditioner can be used)
 
 	DECLARE_FECORE_CLASS();
 };
@@ -0,0 +1,126 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "stdafx.h"
+#include "SparseTriangle.h"
+#include <algorithm>
+#include <assert.h>
+
+// levels with fewer rows than this are processed serially
+#define MIN_PARALLEL_LEVEL	256
+
+//-----------------------------------------------------------------------------
+SparseTriangle::SparseTriangle()
+{
+	m_n = 0;
+	m_lower = true;
+	m_unitDiag = true;
+}
+
+//-----------------------------------------------------------------------------
+void SparseTriangle::Create(int n, const int* ptr, const int* ind, int offset, bool lower, bool unitDiag)
+{
+	m_n = n;
+	m_lower = lower;
+	m_unitDiag = unitDiag;
+
+	// extract the structure
+	m_ptr.assign(n + 1, 0);
+	m_ind.clear();
+	m_src.clear();
+	m_dsrc.assign(n, -1);
+	for (int i = 0; i < n; ++i)
+	{
+		for (int k = ptr[i] - offset; k < ptr[i + 1] - offset; ++k)
+		{
+			int j = ind[k] - offset;
+			if (j == i) m_dsrc[i] = k;
+			else if ((lower && (j < i)) || (!lower && (j > i)))
+			{
+				m_ind.push_back(j);
+				m_src.push_back(k);
+			}
+		}
+		m_ptr[i + 1] = (int)m_ind.size();
+	}
+	m_val.assign(m_ind.size(), 0.0);
+	m_diag.assign(n, 1.0);
+
+	// Assign levels. For a lower triangle, rows depend on rows with smaller index, 
+	// so we can determine the levels in a single sweep (and backwards for upper triangles).
+	std::vector<int> level(n, 0);
+	int nlevels = 0;
+	for (int r = 0; r < n; ++r)
+	{
+		int i = (lower ? r : n - 1 - r);
+		int l = 0;
+		for (int k = m_ptr[i]; k < m_ptr[i + 1]; ++k) l = std::max(l, level[m_ind[k]] + 1);
+		level[i] = l;
+		nlevels = std::max(nlevels, l + 1);
+	}
+
+	m_levp.assign(nlevels + 1, 0);
+	for (int i = 0; i < n; ++i) m_levp[level[i] + 1]++;
+	for (int l = 0; l < nlevels; ++l) m_levp[l + 1] += m_levp[l];
+	m_rows.resize(n);
+	std::vector<int> pos(m_levp.begin(), m_levp.end() - 1);
+	for (int i = 0; i < n; ++i) m_rows[pos[level[i]]++] = i;
+}
+
+//-----------------------------------------------------------------------------
+void SparseTriangle::SetValues(const double* val)
+{
+	int nnz = (int)m_src.size();
+	for (int k = 0; k < nnz; ++k) m_val[k] = val[m_src[k]];
+	if (m_unitDiag == false)
+	{
+		for (int i = 0; i < m_n; ++i) m_diag[i] = (m_dsrc[i] >= 0 ? val[m_dsrc[i]] : 0.0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void SparseTriangle::Solve(const double* b, double* x) const
+{
+	const int* ptr = (m_ptr.empty() ? nullptr : &m_ptr[0]);
+	const int* ind = (m_ind.empty() ? nullptr : &m_ind[0]);
+	const double* val = (m_val.empty() ? nullptr : &m_val[0]);
+	const double* diag = (m_diag.empty() ? nullptr : &m_diag[0]);
+	bool unitDiag = m_unitDiag;
+
+	int nlevels = Levels();
+	for (int l = 0; l < nlevels; ++l)
+	{
+		const int* rows = LevelRows(l);
+		int nrows = LevelSize(l);
+#pragma omp parallel for if (nrows >= MIN_PARALLEL_LEVEL)
+		for (int q = 0; q < nrows; ++q)
+		{
+			int i = rows[q];
+			double s = b[i];
+			for (int k = ptr[i]; k < ptr[i + 1]; ++k) s -= val[k] * x[ind[k]];
+			x[i] = (unitDiag ? s : s / diag[i]);
+		}
+	}
+}
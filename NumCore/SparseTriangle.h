@@ -0,0 +1,76 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#pragma once
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Sparse triangular matrix that is stored by rows and solved with level scheduling.
+//! The rows are grouped in levels such that a row only depends on rows of 
+//! previous levels. All rows of a level can then be processed in parallel.
+//! This is used by the incomplete factorization preconditioners.
+class SparseTriangle
+{
+public:
+	SparseTriangle();
+
+	//! Extract a triangle from a compressed row matrix. If lower is true, the 
+	//! strictly lower triangle is extracted, otherwise the strictly upper triangle.
+	//! If unitDiag is false, the diagonal is extracted as well.
+	void Create(int n, const int* ptr, const int* ind, int offset, bool lower, bool unitDiag);
+
+	//! Copy the values from the matrix that was used to create the triangle.
+	void SetValues(const double* val);
+
+	//! solve T x = b (x and b can not be the same)
+	void Solve(const double* b, double* x) const;
+
+	//! number of rows
+	int Rows() const { return m_n; }
+
+	//! number of levels
+	int Levels() const { return (m_levp.empty() ? 0 : (int)m_levp.size() - 1); }
+
+	//! rows in level l
+	const int* LevelRows(int l) const { return &m_rows[0] + m_levp[l]; }
+
+	//! number of rows in level l
+	int LevelSize(int l) const { return m_levp[l + 1] - m_levp[l]; }
+
+private:
+	int		m_n;
+	bool	m_lower;
+	bool	m_unitDiag;
+
+	std::vector<int>	m_ptr;	//!< start of each row
+	std::vector<int>	m_ind;	//!< column indices (zero-based)
+	std::vector<int>	m_src;	//!< index of value in source matrix
+	std::vector<int>	m_dsrc;	//!< index of diagonal value in source matrix
+	std::vector<double>	m_val;	//!< off-diagonal values
+	std::vector<double>	m_diag;	//!< diagonal values
+
+	std::vector<int>	m_levp;	//!< start of each level in m_rows
+	std::vector<int>	m_rows;	//!< rows, sorted by level
+};
@@ -0,0 +1,944 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "stdafx.h"
+#include "SupernodalSolver.h"
+#include <FECore/log.h>
+#include <FECore/FENestedDissection.h>
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// block size of the dense panel factorization
+#define PANEL_SIZE	32
+
+// fronts larger than this are factored one at a time, with the dense updates done in parallel.
+// Smaller fronts on the same level of the assembly tree are factored concurrently.
+#define LARGE_FRONT	256
+
+//-----------------------------------------------------------------------------
+class SupernodalSolver::Impl
+{
+public:
+	// Analyze the structure of the matrix: compute the fill-reducing ordering, 
+	// the supernodes and the structure of the factor.
+	bool Analyze(CompactMatrix* A, bool symmetric, int leafSize, const vector<int>& userPerm);
+
+	// numerical factorization
+	bool Factor(CompactMatrix* A, double pivotTol);
+
+	// solve using the factorization (overwrites b with solution)
+	void Solve(const double* b, double* x);
+
+	// clear all data
+	void Clear();
+
+private:
+	// collect the nonzeroes of the matrix
+	void CollectEntries(CompactMatrix* A);
+
+	// build the permuted structure of the matrix for the current permutation
+	void BuildPermutedMatrix();
+
+	// get the strict lower triangle of the (symmetrized) permuted matrix by rows
+	void LowerRows(vector<int>& tp, vector<int>& ti);
+
+	// compute elimination tree of the permuted matrix
+	void EliminationTree(const vector<int>& tp, const vector<int>& ti, vector<int>& parent);
+
+	// compute supernodes and structure of factor
+	void Symbolic(const vector<int>& tp, const vector<int>& ti, const vector<int>& parent);
+
+	// factor one supernode, returns number of perturbed pivots
+	int FactorSupernode(int s, const double* val, double tol);
+
+public:
+	int		neq = 0;
+	bool	symmetric = true;
+	bool	isFactored = false;
+	int		npert = 0;		// number of perturbed pivots in last factorization
+	double	nflops = 0;		// estimated flop count of the factorization
+
+	// nonzeroes of the input matrix (original numbering)
+	vector<int>	erow, ecol;		// row and column of each nonzero (the nonzero index is the value index)
+
+	// permutation: perm[i] = new index of equation i, iperm[k] = old index of new equation k
+	vector<int>	perm, iperm;
+
+	// lower triangle (incl. diagonal) of permuted matrix in CSC format, 
+	// storing for each entry the index of its value in the input matrix
+	vector<int>	lp, li, ls;
+
+	// strict upper triangle of permuted matrix stored by rows (unsymmetric matrices only)
+	vector<int>	up, ui, us;
+
+	// supernodes
+	int				nsuper = 0;
+	vector<int>		sfirst;		// first column of each supernode (size nsuper + 1)
+	vector<int>		sparent;	// parent supernode (-1 for roots)
+	vector<int>		schildp;	// start of children list of supernode (size nsuper + 1)
+	vector<int>		schild;		// children of supernodes
+	vector<int>		rowp;		// start of row indices of each supernode (size nsuper + 1)
+	vector<int>		rows;		// row indices of supernodes (sorted, starting with its own columns)
+	vector<size_t>	lptr;		// start of L-block of each supernode (size nsuper + 1)
+	vector<size_t>	uptr;		// start of U-block of each supernode (size nsuper + 1)
+	vector<int>		levp;		// start of each level in lev
+	vector<int>		lev;		// supernodes, sorted by their level in the assembly tree
+
+	// numerical factor
+	vector<double>	L;		// L-blocks (column major, includes diagonal block)
+	vector<double>	U;		// U-blocks, i.e. off-diagonal part of U (unsymmetric only)
+	vector< vector<double> >	update;	// update matrices (only used during factorization)
+};
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::Clear()
+{
+	neq = 0;
+	nsuper = 0;
+	isFactored = false;
+	erow.clear(); ecol.clear();
+	perm.clear(); iperm.clear();
+	lp.clear(); li.clear(); ls.clear();
+	up.clear(); ui.clear(); us.clear();
+	sfirst.clear(); sparent.clear();
+	schildp.clear(); schild.clear();
+	rowp.clear(); rows.clear();
+	lptr.clear(); uptr.clear();
+	levp.clear(); lev.clear();
+	vector<double>().swap(L);
+	vector<double>().swap(U);
+	update.clear();
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::CollectEntries(CompactMatrix* A)
+{
+	int n = A->Rows();
+	int nnz = A->NonZeroes();
+	int offset = A->Offset();
+	int* pointers = A->Pointers();
+	int* indices = A->Indices();
+
+	// the compact symmetric matrix and the CCS matrix store columns, the CRS matrix stores rows
+	bool rowBased = (dynamic_cast<CRSSparseMatrix*>(A) != nullptr);
+
+	erow.resize(nnz);
+	ecol.resize(nnz);
+	for (int i = 0; i < n; ++i)
+	{
+		for (int k = pointers[i] - offset; k < pointers[i + 1] - offset; ++k)
+		{
+			int j = indices[k] - offset;
+			if (rowBased) { erow[k] = i; ecol[k] = j; }
+			else { erow[k] = j; ecol[k] = i; }
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// helper function for sorting the entries of compressed columns (or rows)
+static void sort_compressed(int n, const vector<int>& ptr, vector<int>& ind, vector<int>& src)
+{
+	vector<pair<int, int> > tmp;
+	for (int j = 0; j < n; ++j)
+	{
+		int n0 = ptr[j], n1 = ptr[j + 1];
+		tmp.resize(n1 - n0);
+		for (int k = n0; k < n1; ++k) tmp[k - n0] = pair<int, int>(ind[k], src[k]);
+		sort(tmp.begin(), tmp.end());
+		for (int k = n0; k < n1; ++k) { ind[k] = tmp[k - n0].first; src[k] = tmp[k - n0].second; }
+	}
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::BuildPermutedMatrix()
+{
+	int n = neq;
+	int nnz = (int)erow.size();
+
+	// count entries
+	lp.assign(n + 1, 0);
+	up.assign(n + 1, 0);
+	for (int k = 0; k < nnz; ++k)
+	{
+		int r = perm[erow[k]];
+		int c = perm[ecol[k]];
+		if (symmetric) lp[min(r, c) + 1]++;
+		else if (r >= c) lp[c + 1]++;
+		else up[r + 1]++;
+	}
+	for (int i = 0; i < n; ++i) { lp[i + 1] += lp[i]; up[i + 1] += up[i]; }
+
+	// fill entries
+	li.resize(lp[n]); ls.resize(lp[n]);
+	ui.resize(up[n]); us.resize(up[n]);
+	vector<int> lpos(lp.begin(), lp.end() - 1);
+	vector<int> upos(up.begin(), up.end() - 1);
+	for (int k = 0; k < nnz; ++k)
+	{
+		int r = perm[erow[k]];
+		int c = perm[ecol[k]];
+		if (symmetric)
+		{
+			int q = lpos[min(r, c)]++;
+			li[q] = max(r, c);
+			ls[q] = k;
+		}
+		else if (r >= c)
+		{
+			int q = lpos[c]++;
+			li[q] = r;
+			ls[q] = k;
+		}
+		else
+		{
+			int q = upos[r]++;
+			ui[q] = c;
+			us[q] = k;
+		}
+	}
+
+	sort_compressed(n, lp, li, ls);
+	sort_compressed(n, up, ui, us);
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::LowerRows(vector<int>& tp, vector<int>& ti)
+{
+	int n = neq;
+	tp.assign(n + 1, 0);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int q = lp[j]; q < lp[j + 1]; ++q) if (li[q] > j) tp[li[q] + 1]++;
+		for (int q = up[j]; q < up[j + 1]; ++q) tp[ui[q] + 1]++;
+	}
+	for (int i = 0; i < n; ++i) tp[i + 1] += tp[i];
+	ti.resize(tp[n]);
+	vector<int> pos(tp.begin(), tp.end() - 1);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int q = lp[j]; q < lp[j + 1]; ++q) if (li[q] > j) ti[pos[li[q]]++] = j;
+		for (int q = up[j]; q < up[j + 1]; ++q) ti[pos[ui[q]]++] = j;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::EliminationTree(const vector<int>& tp, const vector<int>& ti, vector<int>& parent)
+{
+	int n = neq;
+
+	// Liu's algorithm with path compression
+	parent.assign(n, -1);
+	vector<int> ancestor(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		for (int q = tp[k]; q < tp[k + 1]; ++q)
+		{
+			int i = ti[q];
+			while ((i != -1) && (i < k))
+			{
+				int inext = ancestor[i];
+				ancestor[i] = k;
+				if (inext == -1) parent[i] = k;
+				i = inext;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::Symbolic(const vector<int>& tp, const vector<int>& ti, const vector<int>& parent)
+{
+	int n = neq;
+
+	// column counts (including diagonal) from the row subtrees
+	vector<int> cc(n, 1);
+	vector<int> mark(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		mark[k] = k;
+		for (int q = tp[k]; q < tp[k + 1]; ++q)
+		{
+			int j = ti[q];
+			while (mark[j] != k)
+			{
+				mark[j] = k;
+				cc[j]++;
+				j = parent[j];
+			}
+		}
+	}
+
+	// fundamental supernodes
+	vector<int> nchild(n, 0);
+	for (int j = 0; j < n; ++j) if (parent[j] >= 0) nchild[parent[j]]++;
+
+	sfirst.clear();
+	for (int j = 0; j < n; ++j)
+	{
+		bool bnew = true;
+		if (j > 0)
+		{
+			if ((parent[j - 1] == j) && (cc[j - 1] == cc[j] + 1) && (nchild[j] == 1)) bnew = false;
+		}
+		if (bnew) sfirst.push_back(j);
+	}
+	nsuper = (int)sfirst.size();
+	sfirst.push_back(n);
+
+	vector<int> snode(n);
+	for (int s = 0; s < nsuper; ++s)
+		for (int j = sfirst[s]; j < sfirst[s + 1]; ++j) snode[j] = s;
+
+	// supernodal tree
+	sparent.assign(nsuper, -1);
+	schildp.assign(nsuper + 1, 0);
+	for (int s = 0; s < nsuper; ++s)
+	{
+		int p = parent[sfirst[s + 1] - 1];
+		if (p >= 0)
+		{
+			sparent[s] = snode[p];
+			schildp[sparent[s] + 1]++;
+		}
+	}
+	for (int s = 0; s < nsuper; ++s) schildp[s + 1] += schildp[s];
+	schild.resize(schildp[nsuper]);
+	vector<int> cpos(schildp.begin(), schildp.end() - 1);
+	for (int s = 0; s < nsuper; ++s) if (sparent[s] >= 0) schild[cpos[sparent[s]]++] = s;
+
+	// row structure of supernodes
+	rowp.assign(nsuper + 1, 0);
+	for (int s = 0; s < nsuper; ++s) rowp[s + 1] = rowp[s] + cc[sfirst[s]];
+	rows.resize(rowp[nsuper]);
+	for (int j = 0; j < n; ++j) mark[j] = -1;
+	for (int s = 0; s < nsuper; ++s)
+	{
+		int f = sfirst[s];
+		int l = sfirst[s + 1];
+		int* R = &rows[rowp[s]];
+		int m = 0;
+		for (int j = f; j < l; ++j) { R[m++] = j; mark[j] = s; }
+
+		// rows from the matrix
+		for (int j = f; j < l; ++j)
+		{
+			for (int q = lp[j]; q < lp[j + 1]; ++q)
+			{
+				int r = li[q];
+				if (mark[r] != s) { mark[r] = s; R[m++] = r; }
+			}
+			for (int q = up[j]; q < up[j + 1]; ++q)
+			{
+				int r = ui[q];
+				if (mark[r] != s) { mark[r] = s; R[m++] = r; }
+			}
+		}
+
+		// rows from the children
+		for (int c = schildp[s]; c < schildp[s + 1]; ++c)
+		{
+			int t = schild[c];
+			int kt = sfirst[t + 1] - sfirst[t];
+			for (int q = rowp[t] + kt; q < rowp[t + 1]; ++q)
+			{
+				int r = rows[q];
+				if (mark[r] != s) { mark[r] = s; R[m++] = r; }
+			}
+		}
+		assert(m == rowp[s + 1] - rowp[s]);
+		sort(R + (l - f), R + m);
+	}
+
+	// storage of factor
+	lptr.assign(nsuper + 1, 0);
+	uptr.assign(nsuper + 1, 0);
+	nflops = 0;
+	for (int s = 0; s < nsuper; ++s)
+	{
+		size_t k = sfirst[s + 1] - sfirst[s];
+		size_t m = rowp[s + 1] - rowp[s];
+		lptr[s + 1] = lptr[s] + m*k;
+		uptr[s + 1] = uptr[s] + (symmetric ? 0 : k*(m - k));
+		for (size_t p = 0; p < k; ++p) nflops += (double)(m - p)*(double)(m - p);
+	}
+	if (symmetric == false) nflops *= 2.0;
+
+	// levels in the assembly tree (leaves are on level 0)
+	vector<int> level(nsuper, 0);
+	int nlevels = 0;
+	for (int s = 0; s < nsuper; ++s)
+	{
+		if (sparent[s] >= 0) level[sparent[s]] = max(level[sparent[s]], level[s] + 1);
+		nlevels = max(nlevels, level[s] + 1);
+	}
+	levp.assign(nlevels + 1, 0);
+	for (int s = 0; s < nsuper; ++s) levp[level[s] + 1]++;
+	for (int i = 0; i < nlevels; ++i) levp[i + 1] += levp[i];
+	lev.resize(nsuper);
+	vector<int> lpos(levp.begin(), levp.end() - 1);
+	for (int s = 0; s < nsuper; ++s) lev[lpos[level[s]]++] = s;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Impl::Analyze(CompactMatrix* A, bool sym, int leafSize, const vector<int>& userPerm)
+{
+	Clear();
+	neq = A->Rows();
+	symmetric = sym;
+	int n = neq;
+	if (n == 0) return true;
+
+	CollectEntries(A);
+	int nnz = (int)erow.size();
+
+	// build the adjacency graph of the (symmetrized) matrix
+	vector<int> xadj(n + 1, 0);
+	for (int k = 0; k < nnz; ++k)
+	{
+		int i = erow[k], j = ecol[k];
+		if (i != j) { xadj[i + 1]++; xadj[j + 1]++; }
+	}
+	for (int i = 0; i < n; ++i) xadj[i + 1] += xadj[i];
+	vector<int> adj(xadj[n]);
+	vector<int> pos(xadj.begin(), xadj.end() - 1);
+	for (int k = 0; k < nnz; ++k)
+	{
+		int i = erow[k], j = ecol[k];
+		if (i != j) { adj[pos[i]++] = j; adj[pos[j]++] = i; }
+	}
+
+	// remove duplicates (the unsymmetric matrices store both (i,j) and (j,i))
+	int m = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		int n0 = xadj[i], n1 = xadj[i + 1];
+		xadj[i] = m;
+		sort(adj.begin() + n0, adj.begin() + n1);
+		for (int k = n0; k < n1; ++k)
+		{
+			if ((k == n0) || (adj[k] != adj[k - 1])) adj[m++] = adj[k];
+		}
+	}
+	xadj[n] = m;
+	adj.resize(m);
+
+	// fill-reducing ordering (unless the user provided one)
+	if ((int)userPerm.size() == n) iperm = userPerm;
+	else
+	{
+		FENestedDissection nd;
+		nd.m_leafSize = leafSize;
+		nd.Apply(n, xadj, adj, iperm);
+	}
+	perm.resize(n);
+	for (int k = 0; k < n; ++k) perm[iperm[k]] = k;
+
+	// elimination tree
+	BuildPermutedMatrix();
+	vector<int> tp, ti, parent;
+	LowerRows(tp, ti);
+	EliminationTree(tp, ti, parent);
+
+	// postorder the elimination tree so that supernodes are contiguous
+	vector<int> head(n, -1), next(n, -1);
+	for (int j = n - 1; j >= 0; --j)
+	{
+		if (parent[j] >= 0) { next[j] = head[parent[j]]; head[parent[j]] = j; }
+	}
+	vector<int> post(n), stack(n);
+	int k = 0;
+	for (int j = 0; j < n; ++j)
+	{
+		if (parent[j] != -1) continue;
+		int top = 0;
+		stack[0] = j;
+		while (top >= 0)
+		{
+			int p = stack[top];
+			int c = head[p];
+			if (c == -1) { top--; post[p] = k++; }
+			else { head[p] = next[c]; stack[++top] = c; }
+		}
+	}
+	assert(k == n);
+	for (int i = 0; i < n; ++i) perm[i] = post[perm[i]];
+	for (int i = 0; i < n; ++i) iperm[perm[i]] = i;
+
+	BuildPermutedMatrix();
+	LowerRows(tp, ti);
+	EliminationTree(tp, ti, parent);
+	Symbolic(tp, ti, parent);
+
+	update.resize(nsuper);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Updates column j (stored in Fj) of a symmetric frontal matrix F (leading dimension m)
+// with the factored columns p0 to p1. Only the lower triangle is updated. 
+// Four columns are processed at once to reduce the memory traffic on Fj.
+static void update_ldlt(const double* F, int m, int p0, int p1, int j, double* Fj)
+{
+	int p = p0;
+	for (; p + 3 < p1; p += 4)
+	{
+		const double* F0 = F + (size_t)p*m;
+		const double* F1 = F0 + m;
+		const double* F2 = F1 + m;
+		const double* F3 = F2 + m;
+		double c0 = F0[j] * F0[p];
+		double c1 = F1[j] * F1[p + 1];
+		double c2 = F2[j] * F2[p + 2];
+		double c3 = F3[j] * F3[p + 3];
+		if ((c0 == 0.0) && (c1 == 0.0) && (c2 == 0.0) && (c3 == 0.0)) continue;
+		for (int i = j; i < m; ++i) Fj[i] -= F0[i] * c0 + F1[i] * c1 + F2[i] * c2 + F3[i] * c3;
+	}
+	for (; p < p1; ++p)
+	{
+		const double* Fp = F + (size_t)p*m;
+		double c = Fp[j] * Fp[p];
+		if (c == 0.0) continue;
+		for (int i = j; i < m; ++i) Fj[i] -= Fp[i] * c;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Same as above, but for unsymmetric frontal matrices. This computes the rows
+// p0 to p1 of U for this column and updates the rest of the column.
+static void update_lu(const double* F, int m, int p0, int p1, double* Fj)
+{
+	int p = p0;
+	for (; p + 3 < p1; p += 4)
+	{
+		const double* F0 = F + (size_t)p*m;
+		const double* F1 = F0 + m;
+		const double* F2 = F1 + m;
+		const double* F3 = F2 + m;
+		double u0 = Fj[p];
+		double u1 = Fj[p + 1] - F0[p + 1] * u0;
+		double u2 = Fj[p + 2] - F0[p + 2] * u0 - F1[p + 2] * u1;
+		double u3 = Fj[p + 3] - F0[p + 3] * u0 - F1[p + 3] * u1 - F2[p + 3] * u2;
+		Fj[p + 1] = u1;
+		Fj[p + 2] = u2;
+		Fj[p + 3] = u3;
+		if ((u0 == 0.0) && (u1 == 0.0) && (u2 == 0.0) && (u3 == 0.0)) continue;
+		for (int i = p + 4; i < m; ++i) Fj[i] -= F0[i] * u0 + F1[i] * u1 + F2[i] * u2 + F3[i] * u3;
+	}
+	for (; p < p1; ++p)
+	{
+		const double* Fp = F + (size_t)p*m;
+		double u = Fj[p];
+		if (u == 0.0) continue;
+		for (int i = p + 1; i < m; ++i) Fj[i] -= Fp[i] * u;
+	}
+}
+
+//-----------------------------------------------------------------------------
+int SupernodalSolver::Impl::FactorSupernode(int s, const double* val, double tol)
+{
+	int f = sfirst[s];
+	int k = sfirst[s + 1] - f;
+	int m = rowp[s + 1] - rowp[s];
+	const int* R = &rows[rowp[s]];
+	int npert = 0;
+
+	// assemble the frontal matrix (column major)
+	vector<double> F((size_t)m*m, 0.0);
+	for (int c = 0; c < k; ++c)
+	{
+		int col = f + c;
+		double* Fc = &F[(size_t)c*m];
+		int pos = c;
+		for (int q = lp[col]; q < lp[col + 1]; ++q)
+		{
+			int r = li[q];
+			while (R[pos] != r) pos++;
+			Fc[pos] += val[ls[q]];
+		}
+
+		if (symmetric == false)
+		{
+			pos = c + 1;
+			for (int q = up[col]; q < up[col + 1]; ++q)
+			{
+				int r = ui[q];
+				while (R[pos] != r) pos++;
+				F[c + (size_t)pos*m] += val[us[q]];
+			}
+		}
+	}
+
+	// add the update matrices of the children
+	vector<int> idx;
+	for (int ic = schildp[s]; ic < schildp[s + 1]; ++ic)
+	{
+		int t = schild[ic];
+		int kt = sfirst[t + 1] - sfirst[t];
+		int mt = rowp[t + 1] - rowp[t] - kt;
+		const int* Rt = &rows[rowp[t] + kt];
+		vector<double>& Ut = update[t];
+		if (mt == 0) continue;
+
+		idx.resize(mt);
+		int pos = 0;
+		for (int a = 0; a < mt; ++a)
+		{
+			while (R[pos] != Rt[a]) pos++;
+			idx[a] = pos;
+		}
+
+		for (int b = 0; b < mt; ++b)
+		{
+			double* Fb = &F[(size_t)idx[b] * m];
+			const double* Ub = &Ut[(size_t)b*mt];
+			for (int a = (symmetric ? b : 0); a < mt; ++a) Fb[idx[a]] += Ub[a];
+		}
+
+		// we no longer need this update matrix
+		vector<double>().swap(Ut);
+	}
+
+	// blocked, right-looking factorization of the first k columns
+	for (int p0 = 0; p0 < k; p0 += PANEL_SIZE)
+	{
+		int p1 = min(p0 + PANEL_SIZE, k);
+
+		if (symmetric)
+		{
+			// factor the panel
+			for (int p = p0; p < p1; ++p)
+			{
+				double* Fp = &F[(size_t)p*m];
+				double d = Fp[p];
+				if (fabs(d) < tol) { d = (d < 0 ? -tol : tol); Fp[p] = d; npert++; }
+
+				for (int j = p + 1; j < p1; ++j)
+				{
+					double c = Fp[j] / d;
+					if (c == 0.0) continue;
+					double* Fj = &F[(size_t)j*m];
+					for (int i = j; i < m; ++i) Fj[i] -= Fp[i] * c;
+				}
+				for (int i = p + 1; i < m; ++i) Fp[i] /= d;
+			}
+
+			// update the trailing columns
+			const double* Fd = &F[0];
+#pragma omp parallel for schedule(dynamic, 8) if (m - p1 > LARGE_FRONT)
+			for (int j = p1; j < m; ++j) update_ldlt(Fd, m, p0, p1, j, &F[(size_t)j*m]);
+		}
+		else
+		{
+			// factor the panel
+			for (int p = p0; p < p1; ++p)
+			{
+				double* Fp = &F[(size_t)p*m];
+				double d = Fp[p];
+				if (fabs(d) < tol) { d = (d < 0 ? -tol : tol); Fp[p] = d; npert++; }
+
+				for (int i = p + 1; i < m; ++i) Fp[i] /= d;
+				for (int j = p + 1; j < p1; ++j)
+				{
+					double* Fj = &F[(size_t)j*m];
+					double u = Fj[p];
+					if (u == 0.0) continue;
+					for (int i = p + 1; i < m; ++i) Fj[i] -= Fp[i] * u;
+				}
+			}
+
+			// compute the U-rows of the panel and update the trailing columns
+			const double* Fd = &F[0];
+#pragma omp parallel for schedule(dynamic, 8) if (m - p1 > LARGE_FRONT)
+			for (int j = p1; j < m; ++j) update_lu(Fd, m, p0, p1, &F[(size_t)j*m]);
+		}
+	}
+
+	// store the factor
+	memcpy(&L[lptr[s]], &F[0], sizeof(double)*(size_t)m*k);
+	if (symmetric == false)
+	{
+		double* Us = &U[uptr[s]];
+		for (int j = k; j < m; ++j)
+			for (int p = 0; p < k; ++p) Us[p + (size_t)(j - k)*k] = F[p + (size_t)j*m];
+	}
+
+	// store the update matrix for the parent
+	int mu = m - k;
+	if ((mu > 0) && (sparent[s] >= 0))
+	{
+		vector<double>& Us = update[s];
+		Us.resize((size_t)mu*mu);
+		for (int b = 0; b < mu; ++b)
+			memcpy(&Us[(size_t)b*mu], &F[k + (size_t)(k + b)*m], sizeof(double)*mu);
+	}
+
+	return npert;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Impl::Factor(CompactMatrix* A, double pivotTol)
+{
+	isFactored = false;
+	npert = 0;
+	if (neq == 0) { isFactored = true; return true; }
+
+	const double* val = A->Values();
+
+	// pivots smaller than this will be perturbed
+	double maxDiag = 0.0;
+	for (int j = 0; j < neq; ++j)
+	{
+		if ((lp[j + 1] > lp[j]) && (li[lp[j]] == j)) maxDiag = max(maxDiag, fabs(val[ls[lp[j]]]));
+	}
+	double tol = pivotTol*maxDiag;
+	if (tol <= 0.0) tol = 1e-300;
+
+	L.resize(lptr[nsuper]);
+	U.resize(uptr[nsuper]);
+
+	// factor the supernodes level by level, starting at the leaves
+	int nlevels = (int)levp.size() - 1;
+	for (int l = 0; l < nlevels; ++l)
+	{
+		int n0 = levp[l];
+		int n1 = levp[l + 1];
+
+		// the small fronts of this level are factored concurrently
+		int np = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+:np)
+		for (int i = n0; i < n1; ++i)
+		{
+			int s = lev[i];
+			if (rowp[s + 1] - rowp[s] <= LARGE_FRONT) np += FactorSupernode(s, val, tol);
+		}
+
+		// the large fronts one by one
+		for (int i = n0; i < n1; ++i)
+		{
+			int s = lev[i];
+			if (rowp[s + 1] - rowp[s] > LARGE_FRONT) np += FactorSupernode(s, val, tol);
+		}
+
+		npert += np;
+	}
+
+	isFactored = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::Solve(const double* b, double* x)
+{
+	int n = neq;
+	vector<double> y(n);
+	for (int i = 0; i < n; ++i) y[perm[i]] = b[i];
+
+	// forward substitution with (unit) lower triangular factor
+	for (int s = 0; s < nsuper; ++s)
+	{
+		int f = sfirst[s];
+		int k = sfirst[s + 1] - f;
+		int m = rowp[s + 1] - rowp[s];
+		const int* R = &rows[rowp[s]];
+		const double* Ls = &L[lptr[s]];
+		for (int p = 0; p < k; ++p)
+		{
+			double yp = y[f + p];
+			if (yp == 0.0) continue;
+			const double* Lp = Ls + (size_t)p*m;
+			for (int i = p + 1; i < m; ++i) y[R[i]] -= Lp[i] * yp;
+		}
+	}
+
+	// backward substitution
+	for (int s = nsuper - 1; s >= 0; --s)
+	{
+		int f = sfirst[s];
+		int k = sfirst[s + 1] - f;
+		int m = rowp[s + 1] - rowp[s];
+		const int* R = &rows[rowp[s]];
+		const double* Ls = &L[lptr[s]];
+		if (symmetric)
+		{
+			// solve D L^T x = y
+			for (int p = k - 1; p >= 0; --p)
+			{
+				const double* Lp = Ls + (size_t)p*m;
+				double sum = y[f + p] / Lp[p];
+				for (int i = p + 1; i < m; ++i) sum -= Lp[i] * y[R[i]];
+				y[f + p] = sum;
+			}
+		}
+		else
+		{
+			// solve U x = y
+			const double* Us = &U[uptr[s]];
+			for (int p = k - 1; p >= 0; --p)
+			{
+				double sum = y[f + p];
+				for (int j = p + 1; j < k; ++j) sum -= Ls[p + (size_t)j*m] * y[f + j];
+				for (int j = k; j < m; ++j) sum -= Us[p + (size_t)(j - k)*k] * y[R[j]];
+				y[f + p] = sum / Ls[p + (size_t)p*m];
+			}
+		}
+	}
+
+	for (int i = 0; i < n; ++i) x[i] = y[perm[i]];
+}
+
+//=============================================================================
+BEGIN_FECORE_CLASS(SupernodalSolver, LinearSolver)
+	ADD_PARAMETER(m_printLevel, "print_level");
+	ADD_PARAMETER(m_pivotTol  , "pivot_perturbation");
+	ADD_PARAMETER(m_maxRefine , "max_refinements");
+	ADD_PARAMETER(m_leafSize  , "leaf_size");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::SupernodalSolver(FEModel* fem) : LinearSolver(fem), m_pA(nullptr)
+{
+	m = new SupernodalSolver::Impl;
+	m_printLevel = 0;
+	m_pivotTol = 1e-8;
+	m_maxRefine = 2;
+	m_leafSize = 32;
+}
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::~SupernodalSolver()
+{
+	Destroy();
+	delete m;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::SetPrintLevel(int n)
+{
+	m_printLevel = n;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* SupernodalSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// allocate the correct matrix format depending on matrix symmetry type
+	switch (ntype)
+	{
+	case REAL_SYMMETRIC     : m_pA = new CompactSymmMatrix(0); break;
+	case REAL_UNSYMMETRIC   : 
+	case REAL_SYMM_STRUCTURE: m_pA = new CRSSparseMatrix(0); break;
+	default:
+		assert(false);
+		m_pA = nullptr;
+	}
+
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::SetSparseMatrix(SparseMatrix* pA)
+{
+	if (m_pA && m->isFactored) Destroy();
+	m_pA = dynamic_cast<CompactMatrix*>(pA);
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::PreProcess()
+{
+	if (m_pA == nullptr) return false;
+
+	bool symmetric = (dynamic_cast<CompactSymmMatrix*>(m_pA) != nullptr);
+	if (m->Analyze(m_pA, symmetric, m_leafSize, m_perm) == false) return false;
+
+	if (m_printLevel != 0)
+	{
+		double nnzL = (double)m->lptr[m->nsuper] + (double)m->uptr[m->nsuper];
+		feLog("Supernodal solver: %d equations, %d supernodes, %lg nonzeroes in factor, %lg Gflop\n", m->neq, m->nsuper, nnzL, m->nflops*1e-9);
+	}
+
+	return LinearSolver::PreProcess();
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+
+	bool bret = m->Factor(m_pA, m_pivotTol);
+
+	if ((m_printLevel != 0) && (m->npert > 0))
+	{
+		feLog("Supernodal solver: %d pivots were perturbed\n", m->npert);
+	}
+
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::BackSolve(double* x, double* b)
+{
+	// make sure we have work to do
+	int n = m_pA->Rows();
+	if (n == 0) return true;
+	if (m->isFactored == false) return false;
+
+	m->Solve(b, x);
+
+	// when pivots were perturbed, improve the solution with iterative refinement
+	if ((m->npert > 0) && (m_maxRefine > 0))
+	{
+		vector<double> r(n), dx(n);
+		double bnorm = 0.0;
+		for (int i = 0; i < n; ++i) bnorm += b[i] * b[i];
+		bnorm = sqrt(bnorm);
+		for (int iter = 0; iter < m_maxRefine; ++iter)
+		{
+			m_pA->mult_vector(x, &r[0]);
+			double rnorm = 0.0;
+			for (int i = 0; i < n; ++i) { r[i] = b[i] - r[i]; rnorm += r[i] * r[i]; }
+			rnorm = sqrt(rnorm);
+			if (rnorm <= 1e-14*bnorm) break;
+
+			m->Solve(&r[0], &dx[0]);
+			for (int i = 0; i < n; ++i) x[i] += dx[i];
+		}
+	}
+
+	UpdateStats(1);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Destroy()
+{
+	m->Clear();
+	LinearSolver::Destroy();
+}
@@ -0,0 +1,67 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#pragma once
+#include <FECore/LinearSolver.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/CompactSymmMatrix.h>
+
+//-----------------------------------------------------------------------------
+//! Native sparse direct solver that does not depend on any external library.
+//! The equations are reordered with nested dissection, after which the matrix
+//! is factored with a supernodal multifrontal method: LDL^T for symmetric matrices
+//! and LU (on the symmetrized structure) for unsymmetric matrices. Independent
+//! branches of the assembly tree are factored in parallel and the dense updates
+//! of the large fronts are done in parallel as well.
+//! No pivoting is done. Instead, small pivots are perturbed, followed by a few
+//! steps of iterative refinement in the back solve.
+class SupernodalSolver : public LinearSolver
+{
+	class Impl;
+
+public:
+	SupernodalSolver(FEModel* fem);
+	~SupernodalSolver();
+	bool PreProcess() override;
+	bool Factor() override;
+	bool BackSolve(double* x, double* y) override;
+	void Destroy() override;
+
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+	bool SetSparseMatrix(SparseMatrix* pA) override;
+
+	void SetPrintLevel(int n) override;
+
+protected:
+	CompactMatrix*	m_pA;
+	Impl*			m;
+
+	int		m_printLevel;	//!< print level
+	double	m_pivotTol;		//!< relative tolerance for pivot perturbation
+	int		m_maxRefine;	//!< max nr of iterative refinement steps
+	int		m_leafSize;		//!< size of subgraphs at which nested dissection stops
+
+	DECLARE_FECORE_CLASS();
+};